@@ -128,6 +128,9 @@ variants <- function() {
 	print( "#define CONIFERS_CIPS           3" ) # CIPS variant
 }
 
+# Reports which version of the growth kernels the library uses on this machine
+simd.path <- function() .Call( "r_get_simd_path", PACKAGE="rconifers" )
+
 # This function just combines the plant and plot data into a special class of object: 
 # For example: x = list( plots=plots.swo, plants=plants.swo, age=3, yrst=3, x0=0.0, n.years.projected=0 )
 build.sample.data <- function( x ) {
@@ -271,7 +274,7 @@ process.output.data <- function( x ) {
 
 # Project the plant list into the future
 # Default conditions: one year of growth, no random error, seed, endemic mort.. etc.
-project <- function(x,years=1,control=list(rand.err=0,rand.seed=0,endemic.mort=0,sdi.mort=0,genetic.gains=0)){
+project <- function(x,years=1,control=list(rand.err=0,rand.seed=0,endemic.mort=0,sdi.mort=0,genetic.gains=0,threads=1,fast.kernels=0)){
 	
 	  	# Make sure the class of the object passed into the function is a "sample.data" object
 	  	if( class( x ) != "sample.data" ) {
@@ -391,6 +394,34 @@ calc.max.sdi <- function( x )
   val
 }
 
+# volume and biomass per acre for the sample
+calc.yields <- function( x, per.plant=FALSE )
+{
+  
+  if( class( x ) != "sample.data" ) {
+    stop( "Rconifers Error: x is not a sample.data object." )
+    return
+  }
+
+    if( sum( names(  x$plants ) %in% c("plot","sp.code","d6","dbh","tht","cr","n.stems","expf","crown.width" ) ) != 9 )
+    {
+    stop( "Rconifers Error: the plant list data.frame does not have all the required columns. See impute help (?impute)" )
+    return
+  }
+
+  if( sum( names(  x$plots ) %in% c("plot","elevation","slope","aspect","whc","map","si30" ) ) != 7 )
+    {
+      stop( "Rconifers Error: the plot data.frame does not have all the required columns. See impute help (?impute)" )
+      return
+    }
+
+  x$plants$sp.code <- as.character( x$plants$sp.code )
+  val <- .Call( "r_calc_yields", x, as.logical( per.plant ), PACKAGE="rconifers" )
+  names( val ) <- c( "cfvolume4", "biomass" )
+  
+  val
+}
+
 ## print a few results of the whole system
 print.sample.data <- function( x, digits = max( 3, getOption("digits") - 1 ),... ) {
 
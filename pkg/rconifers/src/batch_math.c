@@ -0,0 +1,362 @@
+/********************************************************************************/
+/*                                                                              */
+/*  batch_math.c                                                                */
+/*  exp, log and pow over the columns of a growth batch                         */
+/*                                                                              */
+/********************************************************************************/
+
+/********************************************************************************/
+/*                          Revision History                                    */
+/*                                                                              */
+/*  Number  Date        Who     Revision Notes                                  */
+/********************************************************************************/
+/*  MOD000  Oct 17,2026         created file, batch_exp, batch_log and          */
+/*                              batch_pow with the optional fast kernels        */
+/*  MOD001  Oct 17,2026         added libm_exp_batch, libm_log_batch and        */
+/*                              libm_pow_batch for the math library only users  */
+/********************************************************************************/
+
+#include <math.h>
+#include <memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+
+#include "conifers.h"
+
+
+/* log2(e) and ln(2) split in two, so n*LN2_HI is exact for |n| < 2^11 */
+#define FAST_LOG2E          1.4426950408889634
+#define FAST_LN2_HI         6.93147180369123816490e-01
+#define FAST_LN2_LO         1.90821492927058770002e-10
+#define FAST_SQRT2          1.4142135623730951
+
+/* adding 1.5 * 2^52 rounds a double to an integer, which ends up in */
+/* the low bits of the sum                                           */
+#define FAST_ROUND_MAGIC    6755399441055744.0
+
+/* 2^52, and 2^54 for scaling up the subnormals */
+#define FAST_TWO_POW_52     4503599627370496.0
+#define FAST_TWO_POW_54     18014398509481984.0
+
+/* the limits of the exp argument that give a normal double */
+#define FAST_EXP_MAX        709.0
+#define FAST_EXP_MIN        -708.0
+
+/* use the fast kernels, see set_fast_kernels */
+static unsigned long fast_kernels = 0;
+
+static double bits_to_double( uint64_t bits );
+static uint64_t double_to_bits( double x );
+static double blend( int cond, double a, double b );
+
+static void fast_exp_batch(
+   unsigned long       n,
+   double              *x_ptr,
+   double              *y_ptr );
+
+static void fast_log_batch(
+   unsigned long       n,
+   double              *x_ptr,
+   double              *y_ptr );
+
+
+/********************************************************************************/
+/* set_fast_kernels, get_fast_kernels                                           */
+/********************************************************************************/
+/*  Description :   turns the fast kernels on (1) or off (0)                    */
+/*  Comments    :   with the fast kernels on, batch_exp, batch_log and          */
+/*                  batch_pow use the polynomial approximations below in place  */
+/*                  of the math library. the maximum relative errors are        */
+/*                      exp(x)      5e-16 for -708 <= x <= 709                  */
+/*                      log(x)      2e-15 for x > 0                             */
+/*                      pow(x,p)    1e-15 * (1 + |p log(x)|) for x > 0          */
+/*                  exp(x) is HUGE_VAL above 709 and 0 below -708, and pow      */
+/*                  is only defined for x >= 0. with them off (the default)     */
+/*                  the results are the same as calling exp, log and pow        */
+/********************************************************************************/
+void set_fast_kernels( unsigned long on )
+{
+   fast_kernels = on ? 1 : 0;
+}
+
+unsigned long get_fast_kernels( void )
+{
+   return fast_kernels;
+}
+
+
+/********************************************************************************/
+/* batch_exp, batch_log, batch_pow                                              */
+/********************************************************************************/
+/*  Description :   y_ptr[k] = exp( x_ptr[k] ), log( x_ptr[k] ) and             */
+/*                  pow( x_ptr[k], p ) for k < n                                */
+/*  Comments    :   x_ptr and y_ptr can be the same array                       */
+/********************************************************************************/
+void batch_exp(
+   unsigned long       n,
+   double              *x_ptr,
+   double              *y_ptr )
+{
+   if( fast_kernels )
+   {
+      fast_exp_batch( n, x_ptr, y_ptr );
+      return;
+   }
+
+   libm_exp_batch( n, x_ptr, y_ptr );
+}
+
+void batch_log(
+   unsigned long       n,
+   double              *x_ptr,
+   double              *y_ptr )
+{
+   if( fast_kernels )
+   {
+      fast_log_batch( n, x_ptr, y_ptr );
+      return;
+   }
+
+   libm_log_batch( n, x_ptr, y_ptr );
+}
+
+void batch_pow(
+   unsigned long       n,
+   double              *x_ptr,
+   double              p,
+   double              *y_ptr )
+{
+   unsigned long   k;
+
+   if( !fast_kernels )
+   {
+      libm_pow_batch( n, x_ptr, p, y_ptr );
+      return;
+   }
+
+   /* pow(x,0) is one for every x, even 0, inf and nan */
+   if( p == 0.0 )
+   {
+      for( k = 0; k < n; k++ )
+      {
+         y_ptr[k] = 1.0;
+      }
+      return;
+   }
+
+   /* exp( p * log(x) ), log(0) is -inf so pow(0,p) comes out */
+   /* 0 for p > 0 and inf for p < 0                            */
+   fast_log_batch( n, x_ptr, y_ptr );
+   for( k = 0; k < n; k++ )
+   {
+      y_ptr[k] *= p;
+   }
+   fast_exp_batch( n, y_ptr, y_ptr );
+}
+
+
+/********************************************************************************/
+/* libm_exp_batch, libm_log_batch, libm_pow_batch                               */
+/********************************************************************************/
+/*  Description :   same as batch_exp, batch_log and batch_pow with the fast    */
+/*                  kernels off                                                 */
+/*  Comments    :   for the callers that always use the math library, like the  */
+/*                  yields and the imputation, so they don't have to change the */
+/*                  fast kernels setting the growth equations use               */
+/********************************************************************************/
+void libm_exp_batch(
+   unsigned long       n,
+   double              *x_ptr,
+   double              *y_ptr )
+{
+   unsigned long   k;
+
+   for( k = 0; k < n; k++ )
+   {
+      y_ptr[k] = exp( x_ptr[k] );
+   }
+}
+
+void libm_log_batch(
+   unsigned long       n,
+   double              *x_ptr,
+   double              *y_ptr )
+{
+   unsigned long   k;
+
+   for( k = 0; k < n; k++ )
+   {
+      y_ptr[k] = log( x_ptr[k] );
+   }
+}
+
+void libm_pow_batch(
+   unsigned long       n,
+   double              *x_ptr,
+   double              p,
+   double              *y_ptr )
+{
+   unsigned long   k;
+
+   for( k = 0; k < n; k++ )
+   {
+      y_ptr[k] = pow( x_ptr[k], p );
+   }
+}
+
+
+/********************************************************************************/
+/* fast_exp_batch                                                               */
+/********************************************************************************/
+/*  Description :   exp(x) = 2^n * exp(r), with n the nearest integer to        */
+/*                  x/ln(2) and |r| <= ln(2)/2, and exp(r) from its taylor      */
+/*                  series to the r^12 term (truncation error below 2e-16)      */
+/*  Comments    :   there are no branches or calls, the special cases are       */
+/*                  picked with blend, so the loop is vectorized                */
+/********************************************************************************/
+SIMD_CLONES static void fast_exp_batch(
+   unsigned long       n,
+   double              *x_ptr,
+   double              *y_ptr )
+{
+   unsigned long   k;
+   double          x;
+   double          xc;
+   double          t;
+   double          m;
+   double          r;
+   double          p;
+
+#ifdef _OPENMP
+#pragma omp simd private( x, xc, t, m, r, p )
+#endif
+   for( k = 0; k < n; k++ )
+   {
+      x  = x_ptr[k];
+      xc = blend( isless( x, FAST_EXP_MIN ), FAST_EXP_MIN, x );
+      xc = blend( isgreater( xc, FAST_EXP_MAX ), FAST_EXP_MAX, xc );
+
+      t  = xc * FAST_LOG2E + FAST_ROUND_MAGIC;
+      m  = t - FAST_ROUND_MAGIC;
+      r  = ( xc - m * FAST_LN2_HI ) - m * FAST_LN2_LO;
+
+      p  = 1.0 / 479001600.0;
+      p  = p * r + 1.0 / 39916800.0;
+      p  = p * r + 1.0 / 3628800.0;
+      p  = p * r + 1.0 / 362880.0;
+      p  = p * r + 1.0 / 40320.0;
+      p  = p * r + 1.0 / 5040.0;
+      p  = p * r + 1.0 / 720.0;
+      p  = p * r + 1.0 / 120.0;
+      p  = p * r + 1.0 / 24.0;
+      p  = p * r + 1.0 / 6.0;
+      p  = p * r + 0.5;
+      p  = p * r + 1.0;
+      p  = p * r + 1.0;
+
+      /* 2^n from the low bits of t */
+      p  = p * bits_to_double( ( ( double_to_bits( t ) + 1023 ) & 0x7ff ) << 52 );
+
+      p  = blend( isgreater( x, FAST_EXP_MAX ), HUGE_VAL, p );
+      p  = blend( isless( x, FAST_EXP_MIN ), 0.0, p );
+      y_ptr[k] = blend( isunordered( x, x ), x, p );
+   }
+}
+
+
+/********************************************************************************/
+/* fast_log_batch                                                               */
+/********************************************************************************/
+/*  Description :   log(x) = e * ln(2) + log(m), with x = m * 2^e and           */
+/*                  sqrt(1/2) < m <= sqrt(2), and log(m) = 2 atanh(s) with      */
+/*                  s = (m-1)/(m+1), from its series to the s^17 term           */
+/*                  (truncation error below 1e-15)                              */
+/*  Comments    :   the subnormals are scaled up by 2^54 first. there are no    */
+/*                  branches or calls, so the loop is vectorized                */
+/********************************************************************************/
+SIMD_CLONES static void fast_log_batch(
+   unsigned long       n,
+   double              *x_ptr,
+   double              *y_ptr )
+{
+   unsigned long   k;
+   uint64_t        bits;
+   int             tiny;
+   int             high;
+   double          x;
+   double          e;
+   double          m;
+   double          s;
+   double          z;
+   double          p;
+   double          y;
+
+#ifdef _OPENMP
+#pragma omp simd private( bits, tiny, high, x, e, m, s, z, p, y )
+#endif
+   for( k = 0; k < n; k++ )
+   {
+      x    = x_ptr[k];
+      tiny = isless( x, DBL_MIN );
+      bits = double_to_bits( blend( tiny, x * FAST_TWO_POW_54, x ) );
+
+      /* the exponent and the mantissa in [1,2) */
+      e    = bits_to_double( ( bits >> 52 ) | 0x4330000000000000ULL ) - FAST_TWO_POW_52 - 1023.0;
+      e    = blend( tiny, e - 54.0, e );
+      m    = bits_to_double( ( bits & 0x000fffffffffffffULL ) | 0x3ff0000000000000ULL );
+
+      high = isgreater( m, FAST_SQRT2 );
+      e    = blend( high, e + 1.0, e );
+      m    = blend( high, m * 0.5, m );
+
+      s    = ( m - 1.0 ) / ( m + 1.0 );
+      z    = s * s;
+      p    = 1.0 / 17.0;
+      p    = p * z + 1.0 / 15.0;
+      p    = p * z + 1.0 / 13.0;
+      p    = p * z + 1.0 / 11.0;
+      p    = p * z + 1.0 / 9.0;
+      p    = p * z + 1.0 / 7.0;
+      p    = p * z + 1.0 / 5.0;
+      p    = p * z + 1.0 / 3.0;
+
+      y    = e * FAST_LN2_HI + ( e * FAST_LN2_LO + 2.0 * s + 2.0 * s * z * p );
+
+      y    = blend( isgreaterequal( x, HUGE_VAL ), x, y );
+      y    = blend( x == 0.0, -HUGE_VAL, y );
+      y    = blend( isless( x, 0.0 ), NAN, y );
+      y_ptr[k] = blend( isunordered( x, x ), x, y );
+   }
+}
+
+
+/* the bits of a double and back */
+static double bits_to_double( uint64_t bits )
+{
+   double  x;
+
+   memcpy( &x, &bits, sizeof( x ) );
+   return x;
+}
+
+static uint64_t double_to_bits( double x )
+{
+   uint64_t    bits;
+
+   memcpy( &bits, &x, sizeof( bits ) );
+   return bits;
+}
+
+/* cond ? a : b without a branch. gcc won't if-convert a select  */
+/* when one side could raise a floating point exception, so the  */
+/* selects in the loops above are done on the bits               */
+static double blend( int cond, double a, double b )
+{
+   uint64_t    mask;
+
+   mask = (uint64_t)0 - (uint64_t)( cond != 0 );
+   return bits_to_double( ( double_to_bits( a ) & mask ) | ( double_to_bits( b ) & ~mask ) );
+}
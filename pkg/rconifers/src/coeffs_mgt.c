@@ -17,7 +17,6 @@ static int compare_coeffs_by_fsp(
 
 /* this is an interface function that needs to be exposed at least      */
 /* when the library is being initialized                                */
-/* todo: step #5 - add init_coeffs function for each new variant here   */
 struct COEFFS_RECORD *con_init_coeffs( 
 	unsigned long				version,
 	unsigned long				*n_coeffs,
@@ -29,33 +28,8 @@ struct COEFFS_RECORD *con_init_coeffs(
 
     *n_coeffs = 0;
 
-   switch( version )
-   {
-      case CONIFERS_SWO:
-	    c = (struct COEFFS_RECORD *)con_swo_init_coeffs( n_coeffs, coeffs_version, model_version );
-	    break;
-
-      case CONIFERS_SMC:
-	    c = (struct COEFFS_RECORD *)con_smc_init_coeffs( n_coeffs, coeffs_version, model_version );
-	    break;
-
-      case CONIFERS_SWOHYBRID:
-	    c = (struct COEFFS_RECORD *)con_swo_hybrid_init_coeffs( n_coeffs, coeffs_version, model_version );
-	    break;
-
-      case CONIFERS_CIPS:
-	    c = (struct COEFFS_RECORD *)con_cips_init_coeffs( n_coeffs, coeffs_version, model_version );
-	    break;
-
-      /* todo: step #5 - put your init_coeffs() function call here */
-      //case CONIFERS_[VARIANT]:
-	  //  c = (struct COEFFS_RECORD *)con_[VARIANT]_init_coeffs( n_coeffs, coeffs_version, model_version );
-	  //  break;
-
-      default:
-	    c = (struct COEFFS_RECORD *)con_swo_init_coeffs( n_coeffs, coeffs_version, model_version );
-	    break;
-   }
+   /* the variants and their init_coeffs functions are in variants.c */
+   c = get_variant( version )->init_coeffs( n_coeffs, coeffs_version, model_version );
 
     /* now sort the coeffs for the lookup function */
     qsort(  (void*)c, 
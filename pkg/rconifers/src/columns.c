@@ -0,0 +1,240 @@
+/********************************************************************************/
+/*                                                                              */
+/*  columns.c                                                                   */
+/*  functions for the columnar copy of the plant list used by the plot and      */
+/*  stand summaries                                                             */
+/*                                                                              */
+/********************************************************************************/
+
+/********************************************************************************/
+/*                          Revision History                                    */
+/*                                                                              */
+/*  Number  Date        Who     Revision Notes                                  */
+/********************************************************************************/
+/*  MOD000  Oct 17,2026         created file, columnar copy of the plant list   */
+/*                              for the plot and stand summaries                */
+/*  MOD001  Oct 17,2026         added partition_plot_plants() and the type      */
+/*                              order of the plants on each plot                */
+/*  MOD002  Oct 17,2026         added the sp_idx column for the max sdi         */
+/********************************************************************************/
+
+#include <math.h>
+#include <memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "conifers.h"
+
+
+/* number of double columns in the PLANT_COLUMNS structure */
+#define N_DOUBLE_COLUMNS    11
+
+
+/********************************************************************************/
+/* alloc_plant_columns                                                          */
+/********************************************************************************/
+/*  Description :   allocates a columnar store for n_plants plant records       */
+/*  Returns     :   struct PLANT_COLUMNS * or NULL if the allocation failed     */
+/*  Comments    :   all the columns are carved out of a single block, so the    */
+/*                  store is released with one call to free_plant_columns       */
+/*  Arguments   :   unsigned long *return_code  - pointer to a return code      */
+/*                  unsigned long n_plants      - number of plant records       */
+/********************************************************************************/
+struct PLANT_COLUMNS *alloc_plant_columns(
+    unsigned long           *return_code,
+    unsigned long           n_plants )
+{
+
+    struct PLANT_COLUMNS    *cols_ptr;
+    double                  *block_ptr;
+
+    cols_ptr = (struct PLANT_COLUMNS *)calloc( 1, sizeof( struct PLANT_COLUMNS ) );
+    if( cols_ptr == NULL )
+    {
+        *return_code = FAILED_MEMORY_ALLOC;
+        return NULL;
+    }
+
+    /* one extra entry so an empty plant list still gets a block */
+    block_ptr = (double *)malloc( ( n_plants + 1 ) * N_DOUBLE_COLUMNS * sizeof( double ) );
+    cols_ptr->sp_idx = (unsigned long *)malloc( ( n_plants + 1 ) * sizeof( unsigned long ) );
+    cols_ptr->fsp_idx = (unsigned long *)malloc( ( n_plants + 1 ) * sizeof( unsigned long ) );
+    cols_ptr->type_order = (unsigned long *)malloc( ( n_plants + 1 ) * sizeof( unsigned long ) );
+    if( block_ptr == NULL || cols_ptr->sp_idx == NULL || 
+        cols_ptr->fsp_idx == NULL || cols_ptr->type_order == NULL )
+    {
+        free( block_ptr );
+        free( cols_ptr->sp_idx );
+        free( cols_ptr->fsp_idx );
+        free( cols_ptr->type_order );
+        free( cols_ptr );
+        *return_code = FAILED_MEMORY_ALLOC;
+        return NULL;
+    }
+
+    cols_ptr->n_plants          = n_plants;
+    cols_ptr->tht               = &block_ptr[0 * ( n_plants + 1 )];
+    cols_ptr->dbh               = &block_ptr[1 * ( n_plants + 1 )];
+    cols_ptr->d6                = &block_ptr[2 * ( n_plants + 1 )];
+    cols_ptr->cr                = &block_ptr[3 * ( n_plants + 1 )];
+    cols_ptr->expf              = &block_ptr[4 * ( n_plants + 1 )];
+    cols_ptr->crown_width       = &block_ptr[5 * ( n_plants + 1 )];
+    cols_ptr->max_crown_width   = &block_ptr[6 * ( n_plants + 1 )];
+    cols_ptr->crown_area        = &block_ptr[7 * ( n_plants + 1 )];
+    cols_ptr->basal_area        = &block_ptr[8 * ( n_plants + 1 )];
+    cols_ptr->d6_area           = &block_ptr[9 * ( n_plants + 1 )];
+    cols_ptr->d12_area          = &block_ptr[10 * ( n_plants + 1 )];
+
+    *return_code = CONIFERS_SUCCESS;
+    return cols_ptr;
+
+}
+
+
+/********************************************************************************/
+/* free_plant_columns                                                           */
+/********************************************************************************/
+void free_plant_columns( struct PLANT_COLUMNS *cols_ptr )
+{
+
+    if( cols_ptr == NULL )
+    {
+        return;
+    }
+
+    /* the tht column is the start of the block */
+    free( cols_ptr->tht );
+    free( cols_ptr->sp_idx );
+    free( cols_ptr->fsp_idx );
+    free( cols_ptr->type_order );
+    free( cols_ptr );
+
+}
+
+
+/********************************************************************************/
+/* gather_plant_columns                                                         */
+/********************************************************************************/
+/*  Description :   copies the plant records [first_plant,last_plant) into the  */
+/*                  same rows of the columnar store                             */
+/*  Returns     :   void                                                        */
+/*  Comments    :   called for the whole plant list when the store is built,    */
+/*                  and for a plot's range after the plot's plants have been    */
+/*                  projected                                                   */
+/*  Arguments   :   struct SPECIES_RECORD *species_ptr - species (for fsp_idx)  */
+/*                  unsigned long first_plant, last_plant - range of records    */
+/*                  struct PLANT_RECORD *plants_ptr - the plant list            */
+/*                  struct PLANT_COLUMNS *cols_ptr  - the columnar store        */
+/********************************************************************************/
+void gather_plant_columns(
+    struct SPECIES_RECORD   *species_ptr,
+    unsigned long           first_plant,
+    unsigned long           last_plant,
+    struct PLANT_RECORD     *plants_ptr,
+    struct PLANT_COLUMNS    *cols_ptr )
+{
+
+    unsigned long           i;
+    struct PLANT_RECORD     *plant_ptr;
+
+    plant_ptr = &plants_ptr[first_plant];
+    for( i = first_plant; i < last_plant; i++, plant_ptr++ )
+    {
+        cols_ptr->sp_idx[i]             = plant_ptr->sp_idx;
+        cols_ptr->fsp_idx[i]            = species_ptr[plant_ptr->sp_idx].fsp_idx;
+        cols_ptr->tht[i]                = plant_ptr->tht;
+        cols_ptr->dbh[i]                = plant_ptr->dbh;
+        cols_ptr->d6[i]                 = plant_ptr->d6;
+        cols_ptr->cr[i]                 = plant_ptr->cr;
+        cols_ptr->expf[i]               = plant_ptr->expf;
+        cols_ptr->crown_width[i]        = plant_ptr->crown_width;
+        cols_ptr->max_crown_width[i]    = plant_ptr->max_crown_width;
+        cols_ptr->crown_area[i]         = plant_ptr->crown_area;
+        cols_ptr->basal_area[i]         = plant_ptr->basal_area;
+        cols_ptr->d6_area[i]            = plant_ptr->d6_area;
+        cols_ptr->d12_area[i]           = plant_ptr->d12_area;
+    }
+
+}
+
+
+/********************************************************************************/
+/* build_plant_columns                                                          */
+/********************************************************************************/
+/*  Description :   allocates a columnar store and fills it from the plant list */
+/*  Returns     :   struct PLANT_COLUMNS * or NULL if the allocation failed     */
+/********************************************************************************/
+struct PLANT_COLUMNS *build_plant_columns(
+    unsigned long           *return_code,
+    struct SPECIES_RECORD   *species_ptr,
+    unsigned long           n_plants,
+    struct PLANT_RECORD     *plants_ptr )
+{
+
+    struct PLANT_COLUMNS    *cols_ptr;
+
+    cols_ptr = alloc_plant_columns( return_code, n_plants );
+    if( cols_ptr == NULL )
+    {
+        return NULL;
+    }
+
+    gather_plant_columns( species_ptr, 0, n_plants, plants_ptr, cols_ptr );
+
+    return cols_ptr;
+
+}
+
+
+/********************************************************************************/
+/* partition_plot_plants                                                        */
+/********************************************************************************/
+/*  Description :   groups the rows of the plot's plants by plant type          */
+/*  Returns     :   void                                                        */
+/*  Comments    :   a counting sort on the type, so the rows keep their order   */
+/*                  within each type. the rows go in the plot's own slots of    */
+/*                  type_order, [first_plant,last_plant), so each plot can be   */
+/*                  partitioned on its own thread. plot_ptr->type_order points  */
+/*                  into the columnar store, so it has to be set back to NULL   */
+/*                  before the store is freed                                   */
+/*  Arguments   :   struct COEFFS_RECORD *coeffs_ptr - coeffs (for the type)    */
+/*                  struct PLANT_COLUMNS *cols_ptr  - the plot sorted plants    */
+/*                  struct PLOT_RECORD  *plot_ptr   - the plot to partition     */
+/********************************************************************************/
+void partition_plot_plants(
+    struct COEFFS_RECORD    *coeffs_ptr,
+    struct PLANT_COLUMNS    *cols_ptr,
+    struct PLOT_RECORD      *plot_ptr )
+{
+
+    unsigned long           j;
+    unsigned long           t;
+    unsigned long           type;
+    unsigned long           next[PLANT_TYPES];
+    unsigned long           *order_ptr;
+
+    memset( plot_ptr->type_first, 0, sizeof( plot_ptr->type_first ) );
+
+    for( j = plot_ptr->first_plant; j < plot_ptr->last_plant; j++ )
+    {
+        type = coeffs_ptr[cols_ptr->fsp_idx[j]].type;
+        plot_ptr->type_first[type + 1]++;
+    }
+
+    for( t = 0; t < PLANT_TYPES; t++ )
+    {
+        plot_ptr->type_first[t + 1] += plot_ptr->type_first[t];
+        next[t] = plot_ptr->type_first[t];
+    }
+
+    order_ptr = &cols_ptr->type_order[plot_ptr->first_plant];
+    for( j = plot_ptr->first_plant; j < plot_ptr->last_plant; j++ )
+    {
+        type = coeffs_ptr[cols_ptr->fsp_idx[j]].type;
+        order_ptr[next[type]++] = j;
+    }
+
+    plot_ptr->type_order = order_ptr;
+
+}
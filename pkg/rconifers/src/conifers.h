@@ -27,8 +27,6 @@ extern "C" {
 #define NAME_LENGTH         40          /*  max length for long names       */   
 #define MAX_COEFFS          16          /*  current max coeffs for dynamic  */
 #define MIN_HEIGHT          0.5         /* minimum total height             */
-#define	AIT_BIN_RES         0.10        /* single array for bal/cat         */
-#define	AIT_SIZE            750         /* single array for bal/cat         */
 
 #ifndef FALSE                           /* if FALSE is not already defined  */
 #define FALSE               0
@@ -135,13 +133,34 @@ extern "C" {
 #define NON_STOCKED             4  
 #define PLANT_TYPES             5
 
+/* number of species a plot keeps the swohybrid SRT for */
+#define SRT_CACHE_SIZE          16
+
+/* number of plants the batched growth kernels work on at a time */
+#define GROWTH_BATCH_SIZE       64
+
+/* the batched growth kernels are built for avx512f, avx2 and the base  */
+/* instruction set with gcc on x86-64 linux, and the loader picks the   */
+/* best one the cpu has (see get_simd_path). gcc would fuse multiplies  */
+/* and adds into fma instructions in the avx512f version, so the clones */
+/* are built with fp-contract off and all versions give the same        */
+/* results. define CONIFERS_NO_CLONES to only build the base version    */
+#if defined( __GNUC__ ) && !defined( __clang__ ) && ( __GNUC__ >= 6 ) && \
+    defined( __x86_64__ ) && defined( __linux__ ) && !defined( CONIFERS_NO_CLONES )
+#define CONIFERS_SIMD_CLONES    1
+#define SIMD_CLONES             __attribute__(( target_clones( "avx512f", "avx2", "default" ), \
+                                        optimize( "fp-contract=off" ) ))
+#else
+#define SIMD_CLONES
+#endif
+
 /* variants added for conifers 4.0 */
 /* todo: step #1 - add new variant #define here */
 #define CONIFERS_SWO            0
 #define CONIFERS_SMC            1
 #define CONIFERS_SWOHYBRID      2
 #define CONIFERS_CIPS           3
-// #define N_VARIANTS              (CONIFERS_CIPS+1)
+#define N_VARIANTS              (CONIFERS_CIPS+1)
 
 /*
 variant_id,
@@ -158,6 +177,7 @@ citation,
 
 /* todo: step #2 - create new coeffs_[VARIANT].c file, enter, and verify the coefficients */
 /* todo: step #3 - create new model_[VARIANT].c file, code, and verify the functions  */
+/* todo: step #4 - add a VARIANT_RECORD for the new variant to the table in variants.c */
 
 
 
@@ -275,10 +295,18 @@ citation,
 	 double         d12_growth;		 /* change in diameter at 30 cm		*/
 	 double         d12_area;		 /* area (ft^2) of d12 cross section */
 
-	 /* spares. these are reserved for debugging, new variables, etc.    */
+	 /* debugging spares, NULL unless the package is built with _DEBUG */
+	 /* see attach_plant_diagnostics()                                 */
+	 struct PLANT_DIAGNOSTICS *diag;
+
+   };
+
+/* the spares for debugging variants. these are kept out of the plant  */
+/* record so the records that are sorted and copied stay small         */
+   struct PLANT_DIAGNOSTICS
+   {
 	 long           INT_SPARE[30];   /*  generic spares, reserved        */
 	 double         DBL_SPARE[30];	 /*  for debugging variants          */
-
    };
 
    struct PLOT_RECORD
@@ -315,8 +343,6 @@ citation,
 	 double         ca_c;                   /*  crown area in conifers          */
 	 double         ca_h;                   /*  crown area in hardwoods         */
 	 double         ca_s;                   /*  crown area in shrubs            */
-	 double         bait[PLANT_TYPES][AIT_SIZE];  /* basal area in taller       */
-	 double         cait[PLANT_TYPES][AIT_SIZE];  /* crown area in taller       */
 	 
 
 	 /* variables added for the CONIFERS_CIPS model */
@@ -324,17 +350,49 @@ citation,
 											/* basal area for "conifers"		*/
 											/* (aka DF) at 30 cm (15 inches)	*/
 											/* above the ground					*/
-	 double         bal[PLANT_TYPES][AIT_SIZE];  /* basal area in larger */
-                                                 /* diameter trees */
 
 	 /* variables added for the CONIFERS_SWOHYBRID model */
      double			growing_season_precip;  /* this is not mean annual precip */
 	 double			solar_radiation[12];	/*	solar radiation, MegaJoules/m^2	*/
 	 double			mean_monthly_temp[12];	/*	mean monthly temp in C			*/
 
-	 /* spares. these are reserved for debugging, new variables, etc.    */
-	 long           INT_SPARE[30];   /*  generic spares, reserved        */
-	 double         DBL_SPARE[30];	 /*  for debugging variants          */
+	 /* range of the plant records on the plot, [first_plant,last_plant)	*/
+	 /* in the plot sorted plant array. see build_plot_plant_index()	*/
+	 unsigned long	first_plant;		/*  index of first plant on plot    */
+	 unsigned long	last_plant;		/*  one past the last plant on plot */
+
+	 /* the in taller and in larger tables for the plot, last_plant -	*/
+	 /* first_plant entries each, while the plot is being grown or		*/
+	 /* imputed, NULL otherwise. see calc_plot_stats_for_plot()		*/
+	 struct COMPETITION_RECORD	*in_taller;
+	 struct COMPETITION_RECORD	*in_larger;
+
+	 /* the rows of the plot's plants grouped by plant type, in plant	*/
+	 /* order within each type, while the plot is being grown or		*/
+	 /* summarized, NULL otherwise. the plants of type t are the rows	*/
+	 /* type_order[type_first[t]] up to type_order[type_first[t+1]]	*/
+	 /* see partition_plot_plants()					*/
+	 unsigned long	*type_order;
+	 unsigned long	type_first[PLANT_TYPES + 1];
+
+	 /* non zero when the plot totals above are current for the plants */
+	 /* on the plot, see calc_plot_aggregates()				*/
+	 unsigned long	aggregates_current;
+
+	 /* psi and the potential height growth for the CONIFERS_CIPS	*/
+	 /* model, for the site_30 and h40 they were computed from	*/
+	 unsigned long	cips_psi_valid;
+	 double		cips_psi_site_30;
+	 double		cips_psi_h40;
+	 double		cips_psi;
+	 double		cips_delta_h_pot;
+
+	 /* the solar radiation temperature modifier (SRT) for the	*/
+	 /* CONIFERS_SWOHYBRID model, by species, for the year the plot	*/
+	 /* is being grown. see swo_hybrid_get_srt()			*/
+	 unsigned long	n_srt;
+	 unsigned long	srt_sp_idx[SRT_CACHE_SIZE];
+	 double		srt[SRT_CACHE_SIZE];
 
    };
 
@@ -384,6 +442,186 @@ citation,
 
    };
 
+/* the stand summaries at the end of the last year projected, so the next */
+/* year can start from them instead of summarizing the plant list again.  */
+/* they're only used while current is set and the plots' aggregates are  */
+/* all current, since thinning and the sdi mortality clear those. see    */
+/* project_plant_list                                                     */
+   struct SUMMARY_CACHE
+   {
+	 unsigned long          current;        /*  non zero when sums can be used  */
+	 unsigned long          n_plants;       /*  size of the summarized list     */
+	 struct SUMMARY_RECORD  sums;           /*  the after growth summaries      */
+   };
+
+/* one entry in the in taller (in larger) table for a plot. the entries  */
+/* are sorted by height (dbh) and hold the totals, by plant type, for    */
+/* that entry and all the entries after it in the table (see stats.c)    */
+   struct COMPETITION_RECORD
+   {
+	 double         value;                  /*  tht or dbh of the plant         */
+	 double         ba[PLANT_TYPES];        /*  basal area in taller (larger)   */
+	 double         ca[PLANT_TYPES];        /*  crown area in taller            */
+   };
+
+/* a columnar copy of the plant attributes read by the plot and stand     */
+/* summaries, one array per attribute, in the same (plot sorted) order as */
+/* the plant records. the growth functions still work on the plant        */
+/* records, see columns.c                                                 */
+   struct PLANT_COLUMNS
+   {
+	 unsigned long  n_plants;               /*  number of rows                  */
+	 unsigned long  *sp_idx;                /*  species index                   */
+	 unsigned long  *fsp_idx;               /*  coeffs index for the species    */
+	 double         *tht;                   /*  total height                    */
+	 double         *dbh;                   /*  diameter at breast height       */
+	 double         *d6;                    /*  basal diameter                  */
+	 double         *cr;                    /*  crown ratio                     */
+	 double         *expf;                  /*  expansion factor                */
+	 double         *crown_width;           /*  crown width                     */
+	 double         *max_crown_width;       /*  max crown width                 */
+	 double         *crown_area;            /*  crown area                      */
+	 double         *basal_area;            /*  basal area at breast height     */
+	 double         *d6_area;               /*  basal area at 6 inches          */
+	 double         *d12_area;              /*  basal area at 12 inches         */
+	 unsigned long  *type_order;            /*  rows by plant type, per plot    */
+   };
+
+/* a stream of random deviates for one plant in one year of a projection. */
+/* the deviates are computed from (seed, run, plot, plant, year, draw) by */
+/* a counter based generator (see sample.c), so they don't depend on the  */
+/* order the plants are projected in or on the number of threads used    */
+   struct RANDOM_STREAM
+   {
+	 unsigned long  seed;                   /*  key for the generator           */
+	 unsigned long  run;                    /*  projection since the seed (key) */
+	 unsigned long  plot;                   /*  plot number of the plant        */
+	 unsigned long  plant;                  /*  plant number on the plot        */
+	 unsigned long  year;                   /*  years after planting            */
+	 unsigned long  draw;                   /*  index of the next deviate       */
+   };
+
+/* up to GROWTH_BATCH_SIZE plants from one plot that share a functional   */
+/* species, with the inputs and results of the growth equations laid out  */
+/* by column. project_plot (grow.c) fills in the plants and their random  */
+/* streams, the variant's batch projection function fills in the rest and */
+/* runs each growth equation over the whole batch                         */
+   struct GROWTH_BATCH
+   {
+	 unsigned long          n;              /*  number of plants in the batch   */
+	 struct COEFFS_RECORD   *c_ptr;         /*  the shared functional species   */
+	 struct PLANT_RECORD    *plant_ptr[GROWTH_BATCH_SIZE];
+	 struct RANDOM_STREAM   stream[GROWTH_BATCH_SIZE];
+
+	 /* the plant attributes at the start of the year */
+	 double         tht[GROWTH_BATCH_SIZE];
+	 double         cr[GROWTH_BATCH_SIZE];
+	 double         d6[GROWTH_BATCH_SIZE];
+	 double         dbh[GROWTH_BATCH_SIZE];
+	 double         crown_width[GROWTH_BATCH_SIZE];
+
+	 /* crown area in taller, by plant type */
+	 double         cat_c[GROWTH_BATCH_SIZE];
+	 double         cat_h[GROWTH_BATCH_SIZE];
+	 double         cat_s[GROWTH_BATCH_SIZE];
+
+	 /* species level inputs for the plant */
+	 double         prob_browse[GROWTH_BATCH_SIZE];
+	 double         prob_top_damage[GROWTH_BATCH_SIZE];
+	 double         srt[GROWTH_BATCH_SIZE];
+
+	 /* the random deviates for the plant */
+	 double         normal[GROWTH_BATCH_SIZE];
+	 double         browse_unif[GROWTH_BATCH_SIZE];
+	 double         top_dam_unif[GROWTH_BATCH_SIZE];
+	 double         cr_unif[GROWTH_BATCH_SIZE];
+	 double         cw_unif[GROWTH_BATCH_SIZE];
+
+	 /* the predicted growth */
+	 double         tht_growth[GROWTH_BATCH_SIZE];
+	 double         d6_growth[GROWTH_BATCH_SIZE];
+	 double         dbh_growth[GROWTH_BATCH_SIZE];
+	 double         cr_growth[GROWTH_BATCH_SIZE];
+	 double         cw_growth[GROWTH_BATCH_SIZE];
+   };
+
+/* up to GROWTH_BATCH_SIZE plants that share a functional species and are */
+/* missing the same value. impute_in_batches (impute.c) fills in the      */
+/* plants, the kernel computes the value for each of them, writes it back */
+/* to the plant and sets the plant's return code                          */
+   struct IMPUTE_BATCH
+   {
+	 unsigned long          n;              /*  number of plants in the batch   */
+	 struct COEFFS_RECORD   *c_ptr;         /*  the shared functional species   */
+	 struct PLANT_RECORD    *plant_ptr[GROWTH_BATCH_SIZE];
+	 unsigned long          return_code[GROWTH_BATCH_SIZE];
+   };
+
+/* the batched imputation equations of a variant, see impute_in_batches */
+   struct IMPUTE_KERNELS
+   {
+	 void (*d6_from_total_height)( struct IMPUTE_BATCH *batch_ptr );     /* S4 */
+	 void (*d6_from_ht_and_dbh)( struct IMPUTE_BATCH *batch_ptr );       /* S5 */
+	 void (*dbh_from_height_and_d6)( struct IMPUTE_BATCH *batch_ptr );   /* S7 */
+	 void (*crown_width)( struct IMPUTE_BATCH *batch_ptr );              /* S1 */
+	 void (*exp_from_cover_and_ca)( struct IMPUTE_BATCH *batch_ptr );    /* S8 */
+	 void (*crown_ratio)( struct IMPUTE_BATCH *batch_ptr );              /* S3 */
+	 void (*max_crown_width)( struct IMPUTE_BATCH *batch_ptr );          /* S2 */
+   };
+
+/* a simulator variant, the functions that implement it and what it needs */
+/* from the plot records. the variants are kept in a table in variants.c  */
+/* and looked up once for each call into the library, so adding a        */
+/* variant only means adding its entry to the table                       */
+   struct VARIANT_RECORD
+   {
+	 unsigned long  id;                     /*  CONIFERS_SWO, CONIFERS_SMC, ... */
+	 char           *label;                 /*  "CONIFERS_SWO", ...             */
+	 unsigned long  requires_site_30;       /*  1 if the plots need a site_30   */
+
+	 /* loads the coefficients for the variant */
+	 struct COEFFS_RECORD *(*init_coeffs)(
+	    unsigned long           *n_coeffs,
+	    double                  *coeffs_version,
+	    double                  *model_version );
+
+	 /* fills in the missing values in the plant list */
+	 void (*impute)(
+	    unsigned long           *return_code,
+	    unsigned long           n_species,
+	    struct SPECIES_RECORD   *species_ptr,
+	    unsigned long           n_coeffs,
+	    struct COEFFS_RECORD    *coeffs_ptr,
+	    unsigned long           variant,
+	    unsigned long           n_plants,
+	    struct PLANT_RECORD     *plants_ptr,
+	    unsigned long           n_points,
+	    struct PLOT_RECORD      *plots_ptr,
+	    double                  fixed_plot_radius,
+	    double                  min_dbh,
+	    double                  baf );
+
+	 /* projects all the plants on a plot forward one year and adds */
+	 /* the growth to the plant records (see update_grown_plant)    */
+	 void (*project_plot)(
+	    unsigned long           *return_code,
+	    struct PLANT_RECORD     *plants_ptr,
+	    struct PLOT_RECORD      *plot_ptr,
+	    unsigned long           n_species,
+	    struct SPECIES_RECORD   *species_ptr,
+	    unsigned long           n_coeffs,
+	    struct COEFFS_RECORD    *coeffs_ptr,
+	    unsigned long           endemic_mortality,
+	    int                     hcb_growth_on,
+	    unsigned long           use_precip_in_hg,
+	    unsigned long           use_rand_err,
+	    struct SUMMARY_RECORD   *before_sums,
+	    unsigned long           use_genetic_gains,
+	    unsigned long           plantation_age,
+	    unsigned long           yrst,
+	    unsigned long           *n_years_projected );
+   };
+
 
 
 
@@ -675,7 +913,34 @@ void __stdcall project_plant_list(
    unsigned long            use_genetic_gains,
    unsigned long			plantation_age,
    unsigned long            yrst,
-   unsigned long            *n_years_projected );
+   unsigned long            *n_years_projected,
+   unsigned long            n_threads,
+   struct SUMMARY_CACHE     *sums_cache_ptr );
+
+void attach_plant_diagnostics(
+   unsigned long           *return_code,
+   unsigned long           n_plants,
+   struct PLANT_RECORD     *plants_ptr );
+
+char *get_simd_path( void );
+
+void project_plot_in_batches(
+   unsigned long           *return_code,
+   struct PLANT_RECORD     *plants_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   struct SPECIES_RECORD   *species_ptr,
+   unsigned long           n_coeffs,
+   struct COEFFS_RECORD    *coeffs_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err,
+   unsigned long           plantation_age,
+   void                    (*project_batch)(
+      unsigned long *, struct SPECIES_RECORD *, struct PLOT_RECORD *,
+      struct GROWTH_BATCH *, unsigned long, int, unsigned long, unsigned long ) );
+
+void update_grown_plant( struct PLANT_RECORD *plant_ptr );
 
 void get_taller_attribs( 
     double                  height,
@@ -718,8 +983,51 @@ void swo_project_plant(
    unsigned long           endemic_mortality,      
    int                     hbc_growth_on,          
    unsigned long           use_precip_in_hg,       
+   unsigned long           use_rand_err,
+   struct RANDOM_STREAM    *rand_stream );
+
+void swo_project_plant_batch(
+   unsigned long           *return_code,
+   struct SPECIES_RECORD   *species_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   struct GROWTH_BATCH     *batch_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
    unsigned long           use_rand_err );
 
+void swo_calc_dbh_growth_batch(
+   unsigned long           *return_code,
+   struct GROWTH_BATCH     *batch_ptr,
+   double                  *coeffs_ptr );
+
+void swo_calc_cr_growth_batch(
+   unsigned long           *return_code,
+   struct GROWTH_BATCH     *batch_ptr,
+   int                     hcb_growth_on,
+   double                  conifer_ca,
+   double                  hardwood_ca,
+   double                  shrub_ca,
+   double                  *coeffs_ptr );
+
+void swo_project_plot(
+   unsigned long           *return_code,
+   struct PLANT_RECORD     *plants_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   unsigned long           n_species,
+   struct SPECIES_RECORD   *species_ptr,
+   unsigned long           n_coeffs,
+   struct COEFFS_RECORD    *coeffs_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err,
+   struct SUMMARY_RECORD   *before_sums,
+   unsigned long           use_genetic_gains,
+   unsigned long           plantation_age,
+   unsigned long           yrst,
+   unsigned long           *n_years_projected );
+
 
 /****************************************************************************/
 /* functions in smc_model.c                                                 */
@@ -753,7 +1061,26 @@ void smc_project_plant(
    unsigned long           use_rand_err, 
    struct SUMMARY_RECORD   *before_sums,
    unsigned long            use_genetic_gains,
-   unsigned long            genetics_age_cut);
+   unsigned long            genetics_age_cut,
+   struct RANDOM_STREAM     *rand_stream );
+
+void smc_project_plot(
+   unsigned long           *return_code,
+   struct PLANT_RECORD     *plants_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   unsigned long           n_species,
+   struct SPECIES_RECORD   *species_ptr,
+   unsigned long           n_coeffs,
+   struct COEFFS_RECORD    *coeffs_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err,
+   struct SUMMARY_RECORD   *before_sums,
+   unsigned long           use_genetic_gains,
+   unsigned long           plantation_age,
+   unsigned long           yrst,
+   unsigned long           *n_years_projected );
 
 
 /****************************************************************************/
@@ -793,6 +1120,24 @@ void cips_project_plant(
    unsigned long            yrst,
    unsigned long            *n_years_projected );
 
+void cips_project_plot(
+   unsigned long           *return_code,
+   struct PLANT_RECORD     *plants_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   unsigned long           n_species,
+   struct SPECIES_RECORD   *species_ptr,
+   unsigned long           n_coeffs,
+   struct COEFFS_RECORD    *coeffs_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err,
+   struct SUMMARY_RECORD   *before_sums,
+   unsigned long           use_genetic_gains,
+   unsigned long           plantation_age,
+   unsigned long           yrst,
+   unsigned long           *n_years_projected );
+
 
 /****************************************************************************/
 /* functions in swo_hybrid_model.c                                          */
@@ -823,8 +1168,37 @@ void swo_hybrid_project_plant(
     unsigned long           endemic_mortality,  
     int                     hcb_growth_on,      
     unsigned long           use_precip_in_hg,   
+    unsigned long           use_rand_err,
+    struct RANDOM_STREAM    *rand_stream );
+
+void swo_hybrid_project_plant_batch(
+    unsigned long           *return_code,
+    struct SPECIES_RECORD   *species_ptr,
+    struct PLOT_RECORD      *plot_ptr,
+    struct GROWTH_BATCH     *batch_ptr,
+    unsigned long           endemic_mortality,
+    int                     hcb_growth_on,
+    unsigned long           use_precip_in_hg,
     unsigned long           use_rand_err );
 
+void swo_hybrid_project_plot(
+    unsigned long           *return_code,
+    struct PLANT_RECORD     *plants_ptr,
+    struct PLOT_RECORD      *plot_ptr,
+    unsigned long           n_species,
+    struct SPECIES_RECORD   *species_ptr,
+    unsigned long           n_coeffs,
+    struct COEFFS_RECORD    *coeffs_ptr,
+    unsigned long           endemic_mortality,
+    int                     hcb_growth_on,
+    unsigned long           use_precip_in_hg,
+    unsigned long           use_rand_err,
+    struct SUMMARY_RECORD   *before_sums,
+    unsigned long           use_genetic_gains,
+    unsigned long           plantation_age,
+    unsigned long           yrst,
+    unsigned long           *n_years_projected );
+
 
 
 /****************************************************************************/
@@ -887,6 +1261,18 @@ void swo_hybrid_project_plant(
       unsigned long       n_records,
       struct PLOT_RECORD  *plots_ptr );
 
+   void build_plot_plant_index( 
+      unsigned long       *return_code,
+      unsigned long       n_plants,
+      struct PLANT_RECORD *plants_ptr,
+      unsigned long       n_points,
+      struct PLOT_RECORD  *plots_ptr );
+
+   void sort_plants_by_plot_plant( 
+      unsigned long       *return_code,
+      unsigned long       n_plants,
+      struct PLANT_RECORD *plants_ptr );
+
    void reduce_pct_cover( 
       unsigned long           *return_code,
       double                  target_pct,
@@ -898,6 +1284,109 @@ void swo_hybrid_project_plant(
       struct PLOT_RECORD      *plots_ptr);
 
 
+/****************************************************************************/
+/* functions in columns.c                                                   */
+/****************************************************************************/
+   struct PLANT_COLUMNS *alloc_plant_columns(
+      unsigned long           *return_code,
+      unsigned long           n_plants );
+
+   void free_plant_columns( struct PLANT_COLUMNS *cols_ptr );
+
+   void gather_plant_columns(
+      struct SPECIES_RECORD   *species_ptr,
+      unsigned long           first_plant,
+      unsigned long           last_plant,
+      struct PLANT_RECORD     *plants_ptr,
+      struct PLANT_COLUMNS    *cols_ptr );
+
+   struct PLANT_COLUMNS *build_plant_columns(
+      unsigned long           *return_code,
+      struct SPECIES_RECORD   *species_ptr,
+      unsigned long           n_plants,
+      struct PLANT_RECORD     *plants_ptr );
+
+   void partition_plot_plants(
+      struct COEFFS_RECORD    *coeffs_ptr,
+      struct PLANT_COLUMNS    *cols_ptr,
+      struct PLOT_RECORD      *plot_ptr );
+
+/****************************************************************************/
+/* functions in batch_math.c                                                */
+/****************************************************************************/
+   void set_fast_kernels( unsigned long on );
+   unsigned long get_fast_kernels( void );
+
+   void batch_exp(
+      unsigned long           n,
+      double                  *x_ptr,
+      double                  *y_ptr );
+
+   void batch_log(
+      unsigned long           n,
+      double                  *x_ptr,
+      double                  *y_ptr );
+
+   void batch_pow(
+      unsigned long           n,
+      double                  *x_ptr,
+      double                  p,
+      double                  *y_ptr );
+
+   void libm_exp_batch(
+      unsigned long           n,
+      double                  *x_ptr,
+      double                  *y_ptr );
+
+   void libm_log_batch(
+      unsigned long           n,
+      double                  *x_ptr,
+      double                  *y_ptr );
+
+   void libm_pow_batch(
+      unsigned long           n,
+      double                  *x_ptr,
+      double                  p,
+      double                  *y_ptr );
+
+/****************************************************************************/
+/* functions in impute.c                                                    */
+/****************************************************************************/
+   void impute_in_batches(
+      unsigned long           *return_code,
+      unsigned long           n_species,
+      struct SPECIES_RECORD   *species_ptr,
+      unsigned long           n_coeffs,
+      struct COEFFS_RECORD    *coeffs_ptr,
+      unsigned long           n_plants,
+      struct PLANT_RECORD     *plants_ptr,
+      unsigned long           n_points,
+      struct PLOT_RECORD      *plots_ptr,
+      double                  fixed_plot_radius,
+      double                  min_dbh,
+      double                  baf,
+      const struct IMPUTE_KERNELS *kernels_ptr );
+
+   void calc_crown_width_batch( struct IMPUTE_BATCH *batch_ptr );
+
+   void calc_crown_width_batch_to_max(
+      struct IMPUTE_BATCH     *batch_ptr,
+      double                  max_crown_area );
+
+   void calc_max_crown_width_batch( struct IMPUTE_BATCH *batch_ptr );
+   void calc_crown_ratio_batch( struct IMPUTE_BATCH *batch_ptr );
+   void calc_d6_from_total_height_batch( struct IMPUTE_BATCH *batch_ptr );
+   void calc_d6_from_ht_and_dbh_batch( struct IMPUTE_BATCH *batch_ptr );
+   void calc_dbh_from_height_and_d6_batch( struct IMPUTE_BATCH *batch_ptr );
+   void calc_exp_from_cover_and_ca_batch( struct IMPUTE_BATCH *batch_ptr );
+
+/****************************************************************************/
+/* functions in variants.c                                                  */
+/****************************************************************************/
+   struct VARIANT_RECORD *find_variant( unsigned long variant );
+
+   struct VARIANT_RECORD *get_variant( unsigned long variant );
+
 /****************************************************************************/
 /* functions in sample.c                                                    */
 /****************************************************************************/
@@ -924,6 +1413,49 @@ void swo_hybrid_project_plant(
    float gauss_dev();
    float uniform_0_1();
 
+   void set_random_seed( unsigned long seed );
+   unsigned long get_random_seed( void );
+   void start_random_run( void );
+   unsigned long get_random_run( void );
+
+   void init_random_stream(
+      struct RANDOM_STREAM    *stream_ptr,
+      unsigned long           seed,
+      unsigned long           run,
+      unsigned long           plot,
+      unsigned long           plant,
+      unsigned long           year );
+
+   double stream_uniform_0_1( struct RANDOM_STREAM *stream_ptr );
+   double stream_gauss_dev( struct RANDOM_STREAM *stream_ptr );
+
+   void fill_uniform_0_1(
+      struct RANDOM_STREAM    *stream_ptr,
+      unsigned long           n,
+      double                  *deviates );
+
+   void fill_gauss_dev(
+      struct RANDOM_STREAM    *stream_ptr,
+      unsigned long           n,
+      double                  *deviates );
+
+   void fill_batch_uniform_0_1(
+      unsigned long           n_streams,
+      struct RANDOM_STREAM    *stream_ptr,
+      unsigned long           n_draws,
+      double                  *deviates );
+
+   void calc_gauss_devs(
+      unsigned long           n,
+      double                  *u1_ptr,
+      double                  *u2_ptr,
+      double                  *deviates );
+
+   void fill_growth_batch_deviates(
+      struct GROWTH_BATCH     *batch_ptr,
+      unsigned long           tree,
+      unsigned long           shrub );
+
    void fill_in_missing_tree_expf(
       unsigned long       *return_code, 
       double              fixed_plot_radius,
@@ -984,6 +1516,22 @@ void swo_hybrid_project_plant(
       unsigned long           n_points,
       struct PLOT_RECORD      *plots_ptr );
 
+   void calc_plot_stats_for_plot( 
+      unsigned long               n_species,
+      struct SPECIES_RECORD       *species_ptr,
+      unsigned long               n_coeffs,
+      struct COEFFS_RECORD        *coeffs_ptr,
+      struct PLANT_COLUMNS        *cols_ptr,
+      struct PLOT_RECORD          *plot_ptr,
+      struct COMPETITION_RECORD   *in_taller_ptr,
+      struct COMPETITION_RECORD   *in_larger_ptr );
+
+   void calc_plot_aggregates( 
+      unsigned long               n_coeffs,
+      struct COEFFS_RECORD        *coeffs_ptr,
+      struct PLANT_COLUMNS        *cols_ptr,
+      struct PLOT_RECORD          *plot_ptr );
+
    void calc_values_in_taller_2( 
       unsigned long                       *return_code,
       unsigned long           n_species,
@@ -1014,7 +1562,8 @@ void swo_hybrid_project_plant(
       struct PLANT_RECORD     *plants_ptr,
       unsigned long           n_points,
       unsigned long           n_summaries,
-      struct SUMMARY_RECORD   *summaries_ptr );
+      struct SUMMARY_RECORD   *summaries_ptr,
+      unsigned long           with_yields );
 
 /* this function will return a pointer to a structure that has          */
 /* the code, all the entries in teh summaries_ptr should have a unique  */
@@ -1036,6 +1585,31 @@ void swo_hybrid_project_plant(
       struct PLANT_RECORD     *plants_ptr,
       struct SUMMARY_RECORD   *sum_ptr );
 
+   void update_total_summaries_from_columns( 
+      unsigned long           *return_code,
+      unsigned long           n_points,
+      unsigned long           n_plants,
+      unsigned long           n_species,
+      struct SPECIES_RECORD   *species_ptr,
+      unsigned long           n_coeffs,
+      struct COEFFS_RECORD    *coeffs_ptr,
+      struct PLANT_RECORD     *plants_ptr,
+      struct PLANT_COLUMNS    *cols_ptr,
+      struct SUMMARY_RECORD   *sum_ptr,
+      unsigned long           with_yields );
+
+   void calc_yields_per_plant( 
+      unsigned long           *return_code,
+      unsigned long           n_points,
+      unsigned long           n_plants,
+      unsigned long           n_species,
+      struct SPECIES_RECORD   *species_ptr,
+      unsigned long           n_coeffs,
+      struct COEFFS_RECORD    *coeffs_ptr,
+      struct PLANT_RECORD     *plants_ptr,
+      double                  *cfvolume4_ptr,
+      double                  *biomass_ptr );
+
 
    struct SUMMARY_RECORD *build_fsp_summaries( 
       unsigned long           *return_code,
@@ -1093,27 +1667,32 @@ void swo_hybrid_project_plant(
       unsigned long           n_plants,
       struct PLANT_RECORD     *plants_ptr );
 
-void set_in_taller_attribs(
-    struct PLANT_RECORD     *plant_ptr,
-    struct COEFFS_RECORD    *c_ptr,
-    struct PLOT_RECORD      *plot_ptr );
-
 void get_in_taller_attribs(
     struct PLANT_RECORD     *plants_ptr,
     struct PLOT_RECORD      *plot_ptr,
     double                  *bait,
     double                  *cait );
 
-void set_in_larger_attribs(
-   struct PLANT_RECORD     *plant_ptr,
-    struct COEFFS_RECORD    *c_ptr,
-    struct PLOT_RECORD      *plot_ptr );
+void get_in_taller_attribs_for_height(
+    double                  tht,
+    struct PLOT_RECORD      *plot_ptr,
+    double                  *bait,
+    double                  *cait );
 
 void get_in_larger_attribs(
     struct PLANT_RECORD     *plants_ptr,
     struct PLOT_RECORD      *plot_ptr,
     double                  *bal);
 
+void get_in_larger_attribs_for_dbh(
+    double                  dbh,
+    struct PLOT_RECORD      *plot_ptr,
+    double                  *bal);
+
+void free_competition_tables(
+    unsigned long               n_points,
+    struct PLOT_RECORD          *plots_ptr );
+
 
 void __stdcall impute_missing_values( 
       unsigned long           *return_code,
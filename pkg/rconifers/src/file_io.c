@@ -3192,6 +3192,9 @@ void __stdcall dump_larger_to_file(
 	FILE	            *fp;
     struct PLOT_RECORD  *plot_ptr;
     unsigned long       i;
+    unsigned long       j;
+    unsigned long       k;
+    double              bal[PLANT_TYPES];
 
     if( ( fp = fopen( filename, "wt" ) ) == NULL )
     {
@@ -3206,62 +3209,21 @@ void __stdcall dump_larger_to_file(
     {
         fprintf( fp, 
             "plot\n" );
-        fprintf( fp, 
-            "%4ld, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf\n", 
-            plot_ptr->plot,          
-            plot_ptr->bal[0][0], 
-            plot_ptr->bal[0][1], 
-            plot_ptr->bal[0][2], 
-            plot_ptr->bal[0][3], 
-            plot_ptr->bal[0][4], 
-            plot_ptr->bal[0][5], 
-            plot_ptr->bal[0][6], 
-            plot_ptr->bal[0][7], 
-            plot_ptr->bal[0][8],
-            plot_ptr->bal[0][9] 
-            );
-        fprintf( fp, 
-            "%4ld, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf\n", 
-            plot_ptr->plot,          
-            plot_ptr->bal[0][10], 
-            plot_ptr->bal[0][11], 
-            plot_ptr->bal[0][12], 
-            plot_ptr->bal[0][13], 
-            plot_ptr->bal[0][14], 
-            plot_ptr->bal[0][15], 
-            plot_ptr->bal[0][16], 
-            plot_ptr->bal[0][17], 
-            plot_ptr->bal[0][18],
-            plot_ptr->bal[0][19] 
-            );
-        fprintf( fp, 
-            "%4ld, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf\n", 
-            plot_ptr->plot,          
-            plot_ptr->bal[0][20], 
-            plot_ptr->bal[0][21], 
-            plot_ptr->bal[0][22], 
-            plot_ptr->bal[0][23], 
-            plot_ptr->bal[0][24], 
-            plot_ptr->bal[0][25], 
-            plot_ptr->bal[0][26], 
-            plot_ptr->bal[0][27], 
-            plot_ptr->bal[0][28],
-            plot_ptr->bal[0][29] 
-            );
-        fprintf( fp, 
-            "%4ld, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf, %8.2lf\n", 
-            plot_ptr->plot,          
-            plot_ptr->bal[0][30], 
-            plot_ptr->bal[0][31], 
-            plot_ptr->bal[0][32], 
-            plot_ptr->bal[0][33], 
-            plot_ptr->bal[0][34], 
-            plot_ptr->bal[0][35], 
-            plot_ptr->bal[0][36], 
-            plot_ptr->bal[0][37], 
-            plot_ptr->bal[0][38],
-            plot_ptr->bal[0][39] 
-            );
+
+        /* conifer basal area in larger than 0.0 to 3.9 inches dbh, */
+        /* ten 0.1 inch steps to a line                              */
+        for( j = 0; j < 4; j++ )
+        {
+            fprintf( fp, "%4ld", plot_ptr->plot );
+            for( k = 0; k < 10; k++ )
+            {
+                get_in_larger_attribs_for_dbh( (double)( j * 10 + k ) * 0.1, 
+                                               plot_ptr, 
+                                               bal );
+                fprintf( fp, ", %8.2lf", bal[CONIFER] );
+            }
+            fprintf( fp, "\n" );
+        }
 
     }
 
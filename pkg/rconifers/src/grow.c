@@ -15,9 +15,9 @@
 
 #include "conifers.h"
 
-static int compare_plants_by_plot_plant(
-				 const void *ptr1,
-				 const void *ptr2 );
+/* the side table for the debugging spares, see attach_plant_diagnostics */
+static struct PLANT_DIAGNOSTICS *plant_diagnostics_table = NULL;
+static unsigned long            plant_diagnostics_size = 0;
 
 /* local function declarations */
 void __stdcall project_plant_list( 
@@ -40,28 +40,29 @@ void __stdcall project_plant_list(
    unsigned long            use_genetic_gains,
    unsigned long			plantation_age,
    unsigned long            yrst,
-   unsigned long            *n_years_after_planting );
+   unsigned long            *n_years_after_planting,
+   unsigned long            n_threads,
+   struct SUMMARY_CACHE     *sums_cache_ptr );
 
 
-static void project_plot( 
-   unsigned long           *return_code,
+static unsigned long summary_cache_is_current(
+   struct SUMMARY_CACHE    *sums_cache_ptr,
    unsigned long           n_plants,
-   struct PLANT_RECORD     *plants_ptr,
-   struct PLOT_RECORD      *plot_ptr,
-   unsigned long           n_species,
+   unsigned long           n_points,
+   struct PLOT_RECORD      *plots_ptr );
+
+static void project_growth_batch(
+   unsigned long           *return_code,
    struct SPECIES_RECORD   *species_ptr,
-   unsigned long           n_coeffs,
-   struct COEFFS_RECORD    *coeffs_ptr,
-   unsigned long           endemic_mortality,      
-   int                     hcb_growth_on,          
-   unsigned long           use_precip_in_hg,       
+   struct PLOT_RECORD      *plot_ptr,
+   struct GROWTH_BATCH     *batch_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
    unsigned long           use_rand_err,
-   unsigned long	        variant,
-   struct SUMMARY_RECORD   *before_sums,
-   unsigned long           use_genetic_gains,
-   unsigned long			plantation_age,
-   unsigned long            yrst,
-   unsigned long            *n_years_after_planting );
+   void                    (*project_batch)(
+      unsigned long *, struct SPECIES_RECORD *, struct PLOT_RECORD *,
+      struct GROWTH_BATCH *, unsigned long, int, unsigned long, unsigned long ) );
 
 
 /********************************************************************************/
@@ -69,6 +70,15 @@ static void project_plot(
 /* this function will project each plot for one year                            */
 /* to project the entire sample for more than one year, this function           */
 /* needs to be called once for each year                                        */
+/* each plot only reads its own PLOT_RECORD and writes its own plants, so the   */
+/* plots are projected concurrently on n_threads threads when the library is    */
+/* built with OpenMP. the plot statistics and the in taller/larger tables for   */
+/* a plot are computed right before the plot is projected, into a scratch       */
+/* buffer owned by the thread, so only one plot's tables per thread exist at    */
+/* any time. the stand level summaries and sdi mortality are computed after     */
+/* all the plots have been projected. when sums_cache_ptr isn't NULL the        */
+/* summaries after growth are kept in it, and the next year starts from them    */
+/* if nothing has changed the plants since (see summary_cache_is_current)       */
 /********************************************************************************/
 void __stdcall project_plant_list( 
    unsigned long           *return_code,
@@ -90,10 +100,18 @@ void __stdcall project_plant_list(
    unsigned long            use_genetic_gains,
    unsigned long			plantation_age,
    unsigned long            yrst,
-   unsigned long            *n_years_after_planting )
+   unsigned long            *n_years_after_planting,
+   unsigned long            n_threads,
+   struct SUMMARY_CACHE     *sums_cache_ptr )
 {
-   unsigned long           i;
+   long                    i;
    struct  PLOT_RECORD     *plot_ptr;
+   unsigned long           plot_return_code;
+   long                    failed_plot;
+   unsigned long           max_plot_plants;
+   struct COMPETITION_RECORD   *scratch_ptr;
+   struct PLANT_COLUMNS    *cols_ptr;
+   struct VARIANT_RECORD   *variant_ptr;
    double                  max_sdi;
    struct SUMMARY_RECORD   before_sums;
    struct SUMMARY_RECORD   after_sums;
@@ -102,19 +120,21 @@ void __stdcall project_plant_list(
    double  plants_removed;
    double  ba_removed;
 
-    qsort(   plants_ptr, 
-       n_plants, 
-       sizeof( struct PLANT_RECORD ), 
-       compare_plants_by_plot_plant ); 
+   /* the functions that project the plots for the variant */
+   variant_ptr = get_variant( variant );
 
+   /* only sorts the list when the order has changed, thinning */
+   /* reorders the plants on a plot by dbh                     */
+   sort_plants_by_plot_plant( return_code, n_plants, plants_ptr );
+   if( *return_code != CONIFERS_SUCCESS )
+   {
+      return;
+   }
 
-   /* update the plot variabels before you procede */
+   /* index the plant records for each plot, the plot variables */
+   /* are updated as each plot is projected                     */
    //Rprintf( "%s, %d\n", __FILE__, __LINE__ );
-   calc_plot_stats_2(   return_code, 
-                           n_species,
-                           species_ptr,
-                           n_coeffs,
-                           coeffs_ptr,
+   build_plot_plant_index( return_code,
                            n_plants,
                            plants_ptr,
                            n_points,
@@ -125,56 +145,173 @@ void __stdcall project_plant_list(
       return;
    }
 
-   /* update the total summaries before the plant list is projected */
-   update_total_summaries(  return_code,
-                               n_points,
-                               n_plants,
-                               n_species,
-                               species_ptr,
-                               n_coeffs,
-                               coeffs_ptr,
-                               plants_ptr,
-                               &before_sums );
-
+#ifdef _DEBUG
+   attach_plant_diagnostics( return_code, n_plants, plants_ptr );
    if( *return_code != CONIFERS_SUCCESS )
    {
       return;
    }
+#endif
 
-
-   /* for each plot, project it forward one year */
+   /* the scratch tables need room for the largest plot */
+   max_plot_plants = 0;
    plot_ptr = &plots_ptr[0];
-   for( i = 0; i < n_points; i++, plot_ptr++ )
+   for( i = 0; i < (long)n_points; i++, plot_ptr++ )
    {
+      if( plot_ptr->last_plant - plot_ptr->first_plant > max_plot_plants )
+      {
+         max_plot_plants = plot_ptr->last_plant - plot_ptr->first_plant;
+      }
+   }
+
+   /* the summaries and the plot statistics are computed from a */
+   /* columnar copy of the plant list, the rows for each plot   */
+   /* are refreshed once the plot has been projected            */
+   cols_ptr = build_plant_columns( return_code,
+                                   species_ptr,
+                                   n_plants,
+                                   plants_ptr );
+   if( cols_ptr == NULL )
+   {
+      return;
+   }
 
-      project_plot( return_code,
-                      n_plants,
-                      plants_ptr,
-                      plot_ptr,
-                      n_species,
-                      species_ptr,
-                      n_coeffs,
-                      coeffs_ptr,
-                      endemic_mortality,
-                      hcb_growth_on,          
-                      use_precip_in_hg,  
-                      use_rand_err,
-                      variant,    
-                      &before_sums,
-                      use_genetic_gains,
-	                  plantation_age,
-	                  yrst,
-                      n_years_after_planting );
+   /* update the total summaries before the plant list is projected, */
+   /* last year's summaries after growth are the same if the plants   */
+   /* haven't changed since                                           */
+   if( summary_cache_is_current( sums_cache_ptr, n_plants, n_points, plots_ptr ) )
+   {
+      before_sums = sums_cache_ptr->sums;
+   }
+   else
+   {
+      update_total_summaries_from_columns(  return_code,
+                                  n_points,
+                                  n_plants,
+                                  n_species,
+                                  species_ptr,
+                                  n_coeffs,
+                                  coeffs_ptr,
+                                  plants_ptr,
+                                  cols_ptr,
+                                  &before_sums,
+                                  0 );
 
       if( *return_code != CONIFERS_SUCCESS )
       {
-            /* todo: should set some warning in here */
-            //* warning = WARNING_TYPE;
-	 return;
-	 //continue;
+         free_plant_columns( cols_ptr );
+         return;
+      }
+   }
+
+   /* the plants are about to change */
+   if( sums_cache_ptr != NULL )
+   {
+      sums_cache_ptr->current = 0;
+   }
+
+
+   /* for each plot, project it forward one year */
+   failed_plot = -1;
+#ifdef _OPENMP
+#pragma omp parallel private( plot_ptr, plot_return_code, scratch_ptr ) num_threads( n_threads > 1 ? (int)n_threads : 1 ) if( n_threads > 1 )
+#endif
+   {
+      /* the in taller and in larger tables for this thread's plots */
+      scratch_ptr = (struct COMPETITION_RECORD *)malloc( 
+                        ( 2 * max_plot_plants + 1 ) * sizeof( struct COMPETITION_RECORD ) );
+
+#ifdef _OPENMP
+#pragma omp for schedule( dynamic )
+#endif
+      for( i = 0; i < (long)n_points; i++ )
+      {
+         plot_ptr = &plots_ptr[i];
+         plot_return_code = CONIFERS_SUCCESS;
+
+         if( scratch_ptr == NULL )
+         {
+            plot_return_code = CONIFERS_ERROR;
+         }
+         else
+         {
+            /* update the plot variables before you procede */
+            calc_plot_stats_for_plot( n_species,
+                                      species_ptr,
+                                      n_coeffs,
+                                      coeffs_ptr,
+                                      cols_ptr,
+                                      plot_ptr,
+                                      &scratch_ptr[0],
+                                      &scratch_ptr[max_plot_plants] );
+
+            variant_ptr->project_plot( &plot_return_code,
+                                      plants_ptr,
+                                      plot_ptr,
+                                      n_species,
+                                      species_ptr,
+                                      n_coeffs,
+                                      coeffs_ptr,
+                                      endemic_mortality,
+                                      hcb_growth_on,
+                                      use_precip_in_hg,
+                                      use_rand_err,
+                                      &before_sums,
+                                      use_genetic_gains,
+                                      plantation_age,
+                                      yrst,
+                                      n_years_after_planting );
+
+            /* the scratch tables are reused for the next plot */
+            plot_ptr->in_taller = NULL;
+            plot_ptr->in_larger = NULL;
+
+            gather_plant_columns( species_ptr,
+                                  plot_ptr->first_plant,
+                                  plot_ptr->last_plant,
+                                  plants_ptr,
+                                  cols_ptr );
+
+            /* total the grown plot while its plants are in cache, */
+            /* next year's plot statistics can then skip the totals */
+            if( plot_return_code == CONIFERS_SUCCESS )
+            {
+               calc_plot_aggregates( n_coeffs, coeffs_ptr, cols_ptr, plot_ptr );
+               plot_ptr->aggregates_current = 1;
+            }
+            else
+            {
+               plot_ptr->aggregates_current = 0;
+            }
+            plot_ptr->type_order = NULL;
+         }
+
+         /* keep the return code for the first plot that failed */
+         if( plot_return_code != CONIFERS_SUCCESS )
+         {
+#ifdef _OPENMP
+#pragma omp critical( project_plot_failed )
+#endif
+            {
+               if( failed_plot < 0 || i < failed_plot )
+               {
+                  failed_plot = i;
+                  *return_code = plot_return_code;
+               }
+            }
+         }
+
       }
 
+      free( scratch_ptr );
+   }
 
+   if( failed_plot >= 0 )
+   {
+      free_plant_columns( cols_ptr );
+      /* todo: should set some warning in here */
+      //* warning = WARNING_TYPE;
+      return;
    }
 
    /* now, calculate the limiting sdi mortality value for  */
@@ -184,7 +321,7 @@ void __stdcall project_plant_list(
 
    /* calcuate rd */
    /* update the total summaries before the plant list is projected */
-   update_total_summaries(  return_code,
+   update_total_summaries_from_columns(  return_code,
                                n_points,
                                n_plants,
                                n_species,
@@ -192,7 +329,20 @@ void __stdcall project_plant_list(
                                n_coeffs,
                                coeffs_ptr,
                                plants_ptr,
-                               &after_sums );
+                               cols_ptr,
+                               &after_sums,
+                               0 );
+
+   free_plant_columns( cols_ptr );
+
+   /* keep the summaries for next year, the sdi mortality below */
+   /* clears the aggregates for the plots it thins              */
+   if( sums_cache_ptr != NULL && *return_code == CONIFERS_SUCCESS )
+   {
+      sums_cache_ptr->sums     = after_sums;
+      sums_cache_ptr->n_plants = n_plants;
+      sums_cache_ptr->current  = 1;
+   }
 
    /* need_error_trap_here */
    /* if max sdi limit switch is on, then      */
@@ -200,23 +350,18 @@ void __stdcall project_plant_list(
    //Rprintf( "if( sdi_mortality ) check == 1 @ %s, %d, then ()\n", __FILE__, __LINE__ );
    if( sdi_mortality )
    {
-      calc_max_sdi( return_code,
-                      n_species,
-                      species_ptr,
-                      n_coeffs,
-                      coeffs_ptr,
-                      n_plants,
-                      plants_ptr,
-                      n_points,
-                      &max_sdi  );
-
       /* it is choking here. */
       if( *return_code != CONIFERS_SUCCESS )
       {
-	 //Rprintf( "calc_max_sdi *return_code != CONIFERS_SUCCESS @ %s, %d\n", __FILE__, __LINE__ );
+	 //Rprintf( "update_total_summaries *return_code != CONIFERS_SUCCESS @ %s, %d\n", __FILE__, __LINE__ );
 	 return;
       }
 
+      /* the summaries after growth have the max sdi for the plant  */
+      /* list whenever there's basal area, otherwise calc_max_sdi    */
+      /* would fall back to 450                                      */
+      max_sdi = ( after_sums.sdimax > 0.0 ) ? after_sums.sdimax : 450.0;
+
 
       /* this might have been changed since the code was ported */
       /* to the R interface, but a check needs to happen to	*/
@@ -263,10 +408,15 @@ void __stdcall project_plant_list(
 	 }
 
 	 /*    this next section does the sdi mortality   */
-	 plot_ptr = &plots_ptr[0];
-	 for( i = 0; i < n_points; i++, plot_ptr++ )
+	 /*    which, like the growth, is local to a plot */
+#ifdef _OPENMP
+#pragma omp parallel for private( plot_ptr, plot_return_code, plants_removed, ba_removed ) num_threads( n_threads > 1 ? (int)n_threads : 1 ) if( n_threads > 1 )
+#endif
+	 for( i = 0; i < (long)n_points; i++ )
 	 {
-	    thin_plot(  return_code,
+	    plot_ptr = &plots_ptr[i];
+	    plot_return_code = CONIFERS_SUCCESS;
+	    thin_plot(  &plot_return_code,
 	                n_plants,
 	                plants_ptr,
 	                plot_ptr,
@@ -281,7 +431,7 @@ void __stdcall project_plant_list(
 	                &plants_removed, 
 	                &ba_removed );
             
-	    if( *return_code != CONIFERS_SUCCESS )
+	    if( plot_return_code != CONIFERS_SUCCESS )
 	    {
 	       continue;/* error trap here */
 	    }
@@ -301,267 +451,373 @@ void __stdcall project_plant_list(
 
 
 
+/* the cached summaries can stand in for the summaries of the plant list */
+/* when they were taken from the same number of plants and no plot has    */
+/* changed since. every plot's aggregates are marked current after it's   */
+/* grown, and thin_plot and build_plot_plant_index clear them when the    */
+/* plants on the plot change, so a plot that's still current has the     */
+/* plants the summaries were taken from, in the same order                */
+static unsigned long summary_cache_is_current(
+   struct SUMMARY_CACHE    *sums_cache_ptr,
+   unsigned long           n_plants,
+   unsigned long           n_points,
+   struct PLOT_RECORD      *plots_ptr )
+{
+   unsigned long           i;
+
+   if( sums_cache_ptr == NULL || 
+       !sums_cache_ptr->current || 
+       sums_cache_ptr->n_plants != n_plants )
+   {
+      return 0;
+   }
+
+   for( i = 0; i < n_points; i++ )
+   {
+      if( !plots_ptr[i].aggregates_current )
+      {
+         return 0;
+      }
+   }
+
+   return 1;
+}
+
+
 /********************************************************************************/
-/* project_plot                                                                 */
+/* project_plot_in_batches                                                      */
 /********************************************************************************/
-/*  Description :   projects all the plants on the plot forward one year        */
-/*                  into the future                                             */
-/*  Author      :   Jeff D. Hamann                                              */
-/*  Date        :   September 12, 1999                                          */
+/*  Description :   projects all the plants on the plot forward one year, in    */
+/*                  batches of plants that share a functional species           */
 /*  Returns     :   void                                                        */
-/*  Comments    :   this function updates the following variables for each		*/
-/* plant on the plot that is projected											*/
-/*      plant_ptr->d6           += plant_ptr->d6_growth;						*/
-/*      plant_ptr->d12          += plant_ptr->d12_growth;						*/
-/*      plant_ptr->dbh          += plant_ptr->dbh_growth;						*/
-/*      plant_ptr->tht          += plant_ptr->tht_growth;						*/
-/*      plant_ptr->cr           += plant_ptr->cr_growth;						*/
-/*      plant_ptr->crown_width  += plant_ptr->cw_growth;						*/
-/*      plant_ptr->expf         -= plant_ptr->expf_change;						*/
-/*  Arguments   :   unsigned long *return_code  - pointer to a return code      */
-/*                  unsigned long n_plants      - total number fo plants in the */
-/*                      plants pointer array                                    */
-/*                  struct PLANT_RECORD *plants_ptr - array of plants in the    */
-/*                      sample to be projected                                  */
-/*                  struct PLOT_RECORD  *plot_ptr   - pointer to the current    */
-/*                      plot that is to be grown                                */
-/*                  unsigned long n_species - size of the species_ptr           */
-/*                  struct SPECIES_RECORD   *species_ptr - array of             */
-/*                      SPECIES_RECORD's that hold species specific information */
-/*                  unsigned long   n_coeffs - sizes of the coeffs_ptr array    */
-/*                  struct COEFFS_RECORD *coeffs_ptr - array of coefficients    */
-/*                      that are used to project the individual plants on the   */
-/*                      plot.                                                   */
+/*  Comments    :   the plants are grouped by a counting sort on the            */
+/*                  functional species, keeping the plant order within each     */
+/*                  species, and handed to the variant's batch projection       */
+/*                  function GROWTH_BATCH_SIZE at a time. the plants on a plot  */
+/*                  are grown from the plot statistics and the in taller        */
+/*                  tables, not from each other, so the order they are grown    */
+/*                  in doesn't change the results. the conifers, hardwoods and  */
+/*                  shrubs are batched first, from the plot's type partition    */
+/*                  (see partition_plot_plants), and then the forbs and non     */
+/*                  stocked records, which don't grow and don't need random     */
+/*                  streams. used by the project_plot functions of the          */
+/*                  variants that have batch functions                          */
+/*  Arguments   :   the same as VARIANT_RECORD project_plot, along with         */
+/*                  project_batch - the variant's batch projection function,    */
+/*                      swo_project_plant_batch, ...                            */
 /********************************************************************************/
-static void project_plot( 
+void project_plot_in_batches(
    unsigned long           *return_code,
-   unsigned long           n_plants,
    struct PLANT_RECORD     *plants_ptr,
    struct PLOT_RECORD      *plot_ptr,
-   unsigned long           n_species,
    struct SPECIES_RECORD   *species_ptr,
    unsigned long           n_coeffs,
    struct COEFFS_RECORD    *coeffs_ptr,
-   unsigned long           endemic_mortality,      
-   int                     hcb_growth_on,          
-   unsigned long           use_precip_in_hg,       
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
    unsigned long           use_rand_err,
-   unsigned long	       variant,
-   struct SUMMARY_RECORD   *before_sums,
-   unsigned long           use_genetic_gains,
-   unsigned long			plantation_age,
-   unsigned long            yrst,
-   unsigned long            *n_years_projected )
+   unsigned long           plantation_age,
+   void                    (*project_batch)(
+      unsigned long *, struct SPECIES_RECORD *, struct PLOT_RECORD *,
+      struct GROWTH_BATCH *, unsigned long, int, unsigned long, unsigned long ) )
 {
 
-   unsigned long   i;
-   struct  PLANT_RECORD    *plant_ptr;
-   double                  si_30;
-   double                  h40;
-   unsigned long           genetics_age_cut;
-
+   unsigned long           i;
+   unsigned long           n_plot_plants;
+   unsigned long           fsp_idx;
+   unsigned long           pass;
+   unsigned long           first;
+   unsigned long           last;
+   unsigned long           *start_ptr;
+   unsigned long           *order_ptr;
+   struct PLANT_RECORD     *plant_ptr;
+   struct COEFFS_RECORD    *c_ptr;
+   struct GROWTH_BATCH     batch;
+
+   *return_code  = CONIFERS_SUCCESS;
+   n_plot_plants = plot_ptr->last_plant - plot_ptr->first_plant;
+   if( n_plot_plants == 0 )
+   {
+      return;
+   }
 
-   genetics_age_cut=0;
-   /* for each plot, project it forward one year */
-   if(variant == CONIFERS_SMC)
+   if( plot_ptr->type_order == NULL )
    {
-      h40   =  before_sums->height_40;
-      si_30 =  plot_ptr->site_30;
-      get_age_cut(return_code,
-                  h40,
-                  si_30,
-                  &genetics_age_cut);
+      *return_code = CONIFERS_ERROR;
+      return;
    }
 
+   start_ptr = (unsigned long *)malloc( ( n_coeffs + 1 ) * sizeof( unsigned long ) );
+   order_ptr = (unsigned long *)malloc( n_plot_plants * sizeof( unsigned long ) );
+   if( start_ptr == NULL || order_ptr == NULL )
+   {
+      free( start_ptr );
+      free( order_ptr );
+      *return_code = FAILED_MEMORY_ALLOC;
+      return;
+   }
 
-    /* loop over the trees and if the plant is on the current plot  */
-    /* then project the plant forward for one year                   */
-   plant_ptr = &plants_ptr[0];
-   for( i = 0; i < n_plants; i++, plant_ptr++ )
+   /* the types that grow, [CONIFER,FORB), then the rest */
+   for( pass = 0; pass < 2 && *return_code == CONIFERS_SUCCESS; pass++ )
    {
+      first = plot_ptr->type_first[pass == 0 ? CONIFER : FORB];
+      last  = plot_ptr->type_first[pass == 0 ? FORB : PLANT_TYPES];
+      if( first == last )
+      {
+         continue;
+      }
 
-      /* if you're not on the plot, don't grow it */
-      /* you should really be using the function  */
-      /* that returns the index values for the    */
-      /* trees on the plot to get the thing done  */
-      /* just iterate through the plant list and  */
-      /* pitch the plant if it's not on the plot  */
-      if( plant_ptr->plot != plot_ptr->plot )
+      /* count the plants for each functional species */
+      memset( start_ptr, 0, ( n_coeffs + 1 ) * sizeof( unsigned long ) );
+      for( i = first; i < last; i++ )
       {
-	    continue;
+         fsp_idx = species_ptr[plants_ptr[plot_ptr->type_order[i]].sp_idx].fsp_idx;
+         if( fsp_idx >= n_coeffs )
+         {
+            free( start_ptr );
+            free( order_ptr );
+            *return_code = FAILED_PROJECT_PLANT;
+            return;
+         }
+         start_ptr[fsp_idx + 1]++;
       }
 
-      /* for each tree on the plot....    */
-      switch( variant )
+      for( i = 0; i < n_coeffs; i++ )
       {
-	    case CONIFERS_SWO:
-	      swo_project_plant(return_code,
-			                n_species, 
-			                species_ptr, 
-			                n_coeffs, 
-			                coeffs_ptr,
-			                plant_ptr, 
-			                plot_ptr,
-			                endemic_mortality,  
-			                hcb_growth_on,      
-			                use_precip_in_hg,    
-			                use_rand_err  );  
-		break;
-
-	    case CONIFERS_SMC:
-	      smc_project_plant(return_code,
-			                n_species, 
-			                species_ptr, 
-			                n_coeffs, 
-			                coeffs_ptr,
-			                plant_ptr, 
-			                plot_ptr,
-			                endemic_mortality,  
-			                hcb_growth_on,      
-			                use_precip_in_hg,    
-			                use_rand_err,
-			                before_sums,
-                            use_genetic_gains,
-                            genetics_age_cut);   
-		break;
-
-		/* todo: add the code to project each plant for your variant */
-	    case CONIFERS_SWOHYBRID:
-			swo_hybrid_project_plant( return_code,
-			                n_species, 
-			                species_ptr, 
-			                n_coeffs, 
-			                coeffs_ptr,
-			                plant_ptr, 
-			                plot_ptr,
-			                endemic_mortality,  
-			                hcb_growth_on,      
-			                use_precip_in_hg,    
-			                use_rand_err );
-			break;
-
-		
-		/* todo: add the code to project each plant for your variant */
-	    case CONIFERS_CIPS:
-	      cips_project_plant(return_code,
-			                n_species, 
-			                species_ptr, 
-			                n_coeffs, 
-			                coeffs_ptr,
-			                plant_ptr, 
-			                plot_ptr,
-			                endemic_mortality,  
-			                hcb_growth_on,      
-			                use_precip_in_hg,    
-			                use_rand_err,
-			                before_sums,
-                            use_genetic_gains,
-                            genetics_age_cut,
-							plantation_age,
-							yrst,
-                            n_years_projected ); 
-          
-
-        /* todo: put a loop in here and update the dbh using the */
-          /* check in project_plant to impute the missing dbh   */
-          /* values and make sure you get the end of cycle veg cover    */
-
-
-		break;
-
-
-	    default:
-	      swo_project_plant(return_code,
-			                n_species, 
-			                species_ptr, 
-			                n_coeffs, 
-			                coeffs_ptr,
-			                plant_ptr, 
-			                plot_ptr,
-			                endemic_mortality,  
-			                hcb_growth_on,      
-			                use_precip_in_hg,    
-			                use_rand_err  );     
-		break;
+         start_ptr[i + 1] += start_ptr[i];
       }
 
-      if( *return_code != CONIFERS_SUCCESS )
+      for( i = first; i < last; i++ )
       {
-	     *return_code = FAILED_PROJECT_PLANT;  
-	     return;
+         fsp_idx = species_ptr[plants_ptr[plot_ptr->type_order[i]].sp_idx].fsp_idx;
+         order_ptr[start_ptr[fsp_idx]++] = plot_ptr->type_order[i];
       }
 
-      
-      /* update the current tree values...                      */
-      /* todo: this should be moved to a increment/add function */
-      plant_ptr->d6           += plant_ptr->d6_growth;
-      plant_ptr->d12          += plant_ptr->d12_growth;
-      plant_ptr->dbh          += plant_ptr->dbh_growth;
-      plant_ptr->tht          += plant_ptr->tht_growth;
-      plant_ptr->cr           += plant_ptr->cr_growth;
-      plant_ptr->crown_width  += plant_ptr->cw_growth;
-      plant_ptr->expf         -= plant_ptr->expf_change;
+      /* fill and grow the batches */
+      batch.n     = 0;
+      batch.c_ptr = NULL;
+      for( i = 0; i < last - first; i++ )
+      {
+         plant_ptr = &plants_ptr[order_ptr[i]];
+         c_ptr     = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
+
+         if( batch.n == GROWTH_BATCH_SIZE || ( batch.n > 0 && c_ptr != batch.c_ptr ) )
+         {
+            project_growth_batch( return_code,
+                                  species_ptr,
+                                  plot_ptr,
+                                  &batch,
+                                  endemic_mortality,
+                                  hcb_growth_on,
+                                  use_precip_in_hg,
+                                  use_rand_err,
+                                  project_batch );
+            if( *return_code != CONIFERS_SUCCESS )
+            {
+               break;
+            }
+         }
+
+         /* the random deviates for the plant only depend on the    */
+         /* seed, the run, the plot, the plant and the stand age,   */
+         /* so they don't change with the plant order or number of  */
+         /* threads                                                 */
+         if( pass == 0 )
+         {
+            init_random_stream( &batch.stream[batch.n],
+                                get_random_seed(),
+                                get_random_run(),
+                                plot_ptr->plot,
+                                plant_ptr->plant,
+                                plantation_age );
+         }
+
+         batch.c_ptr               = c_ptr;
+         batch.plant_ptr[batch.n]  = plant_ptr;
+         batch.n++;
+      }
 
-      /* update the extra data for the tree                     */
-      /* TODO: we should probably put this into another function */
-      plant_ptr->basal_area    = plant_ptr->dbh * plant_ptr->dbh * FC_I;
-      plant_ptr->d6_area       = plant_ptr->d6 * plant_ptr->d6 * FC_I;
-      plant_ptr->d12_area       = plant_ptr->d12 * plant_ptr->d12 * FC_I;
-      plant_ptr->crown_area    = plant_ptr->crown_width * 
-                                    plant_ptr->crown_width * MY_PI / 4.0;
-      plant_ptr->pct_cover     = 100.0 * plant_ptr->expf * 
-                                    plant_ptr->crown_area/SQ_FT_PER_ACRE;
-   
-    }
+      if( *return_code == CONIFERS_SUCCESS && batch.n > 0 )
+      {
+         project_growth_batch( return_code,
+                               species_ptr,
+                               plot_ptr,
+                               &batch,
+                               endemic_mortality,
+                               hcb_growth_on,
+                               use_precip_in_hg,
+                               use_rand_err,
+                               project_batch );
+      }
+   }
 
+   free( start_ptr );
+   free( order_ptr );
+
+}
 
 
+/********************************************************************************/
+/* project_growth_batch                                                         */
+/********************************************************************************/
+/*  Description :   grows a batch of plants with the variant's batch            */
+/*                  projection function, updates the plant records and          */
+/*                  empties the batch                                           */
+/*  Returns     :   void                                                        */
+/********************************************************************************/
+static void project_growth_batch(
+   unsigned long           *return_code,
+   struct SPECIES_RECORD   *species_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   struct GROWTH_BATCH     *batch_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err,
+   void                    (*project_batch)(
+      unsigned long *, struct SPECIES_RECORD *, struct PLOT_RECORD *,
+      struct GROWTH_BATCH *, unsigned long, int, unsigned long, unsigned long ) )
+{
+
+   unsigned long   k;
+
+   project_batch( return_code,
+                  species_ptr,
+                  plot_ptr,
+                  batch_ptr,
+                  endemic_mortality,
+                  hcb_growth_on,
+                  use_precip_in_hg,
+                  use_rand_err );
+
+   if( *return_code != CONIFERS_SUCCESS )
+   {
+      *return_code = FAILED_PROJECT_PLANT;
+      return;
+   }
+
+   for( k = 0; k < batch_ptr->n; k++ )
+   {
+      update_grown_plant( batch_ptr->plant_ptr[k] );
+   }
 
+   batch_ptr->n = 0;
 
 }
 
 
+/********************************************************************************/
+/* update_grown_plant                                                           */
+/********************************************************************************/
+/*  Description :   adds the predicted growth to the plant record and updates   */
+/*                  the values derived from the plant's size                    */
+/*  Returns     :   void                                                        */
+/*  Comments    :   called by the variants' project_plot functions once each    */
+/*                  plant has been projected                                    */
+/********************************************************************************/
+void update_grown_plant( struct PLANT_RECORD *plant_ptr )
+{
 
+   plant_ptr->d6           += plant_ptr->d6_growth;
+   plant_ptr->d12          += plant_ptr->d12_growth;
+   plant_ptr->dbh          += plant_ptr->dbh_growth;
+   plant_ptr->tht          += plant_ptr->tht_growth;
+   plant_ptr->cr           += plant_ptr->cr_growth;
+   plant_ptr->crown_width  += plant_ptr->cw_growth;
+   plant_ptr->expf         -= plant_ptr->expf_change;
+
+   plant_ptr->basal_area    = plant_ptr->dbh * plant_ptr->dbh * FC_I;
+   plant_ptr->d6_area       = plant_ptr->d6 * plant_ptr->d6 * FC_I;
+   plant_ptr->d12_area      = plant_ptr->d12 * plant_ptr->d12 * FC_I;
+   plant_ptr->crown_area    = plant_ptr->crown_width * 
+                                 plant_ptr->crown_width * MY_PI / 4.0;
+   plant_ptr->pct_cover     = 100.0 * plant_ptr->expf * 
+                                 plant_ptr->crown_area/SQ_FT_PER_ACRE;
 
+}
 
 
 
-static int compare_plants_by_plot_plant(
-				 const void *ptr1,
-				 const void *ptr2 )
+
+/********************************************************************************/
+/* get_simd_path                                                                */
+/********************************************************************************/
+/*  Description :   returns which version of the batched growth kernels is      */
+/*                  used on this machine                                        */
+/*  Returns     :   "avx512f", "avx2" or "default"                              */
+/*  Comments    :   checks the cpu features in the same order the loader        */
+/*                  picks the SIMD_CLONES versions in, so it's always           */
+/*                  "default" when the package was built without them           */
+/********************************************************************************/
+char *get_simd_path( void )
 {
-  struct PLANT_RECORD   *pt1_ptr;
-  struct PLANT_RECORD   *pt2_ptr;
-
-  pt1_ptr = (struct PLANT_RECORD*)ptr1;
-  pt2_ptr = (struct PLANT_RECORD*)ptr2;
-
-  if( pt1_ptr->plot < pt2_ptr->plot )
-    {
-      return -1;
-    }
-  if( pt1_ptr->plot > pt2_ptr->plot )
-    {
-      return 1;
-    }
-  else
-    {
-
-      if( pt1_ptr->plant < pt2_ptr->plant )
-        {
-          return -1;
-        }
-      if( pt1_ptr->plant > pt2_ptr->plant )
-        {
-          return 1;
-        }
-        else
-        {
-          return 0;
-        }
-
-  }
 
+#ifdef CONIFERS_SIMD_CLONES
+   __builtin_cpu_init();
+   if( __builtin_cpu_supports( "avx512f" ) )
+   {
+      return "avx512f";
+   }
+
+   if( __builtin_cpu_supports( "avx2" ) )
+   {
+      return "avx2";
+   }
+#endif
+
+   return "default";
 
 }
 
+
+
+
+/********************************************************************************/
+/* attach_plant_diagnostics                                                     */
+/********************************************************************************/
+/*  Description :   points each plant record at a cleared entry in the side     */
+/*                  table for the debugging spares                              */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the table is shared by all the plant lists and reused, so   */
+/*                  the spares are only good until the next plant list is       */
+/*                  projected. only called when the package is built with       */
+/*                  _DEBUG, otherwise the diag pointers stay NULL               */
+/*  Arguments   :   unsigned long *return_code  - pointer to a return code      */
+/*                  unsigned long n_plants      - number of plant records       */
+/*                  struct PLANT_RECORD *plants_ptr - the plant list            */
+/********************************************************************************/
+void attach_plant_diagnostics(
+   unsigned long           *return_code,
+   unsigned long           n_plants,
+   struct PLANT_RECORD     *plants_ptr )
+{
+
+   unsigned long               i;
+   struct PLANT_RECORD         *plant_ptr;
+   struct PLANT_DIAGNOSTICS    *new_table_ptr;
+
+   if( n_plants > plant_diagnostics_size )
+   {
+      new_table_ptr = (struct PLANT_DIAGNOSTICS *)realloc( plant_diagnostics_table,
+                        n_plants * sizeof( struct PLANT_DIAGNOSTICS ) );
+      if( new_table_ptr == NULL )
+      {
+         *return_code = FAILED_MEMORY_ALLOC;
+         return;
+      }
+      plant_diagnostics_table = new_table_ptr;
+      plant_diagnostics_size  = n_plants;
+   }
+
+   memset( plant_diagnostics_table, 0, n_plants * sizeof( struct PLANT_DIAGNOSTICS ) );
+
+   plant_ptr = &plants_ptr[0];
+   for( i = 0; i < n_plants; i++, plant_ptr++ )
+   {
+      plant_ptr->diag = &plant_diagnostics_table[i];
+   }
+
+   *return_code = CONIFERS_SUCCESS;
+
+}
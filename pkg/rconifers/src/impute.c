@@ -0,0 +1,988 @@
+/********************************************************************************/
+/*                                                                              */
+/*  impute.c                                                                    */
+/*  fills in the missing plant values in batches of plants                      */
+/*                                                                              */
+/********************************************************************************/
+
+/********************************************************************************/
+/*                          Revision History                                    */
+/*                                                                              */
+/*  Number  Date        Who     Revision Notes                                  */
+/********************************************************************************/
+/*  MOD000  Oct 17,2026         created file, the imputation equations are run  */
+/*                              over batches of plants (impute_in_batches)      */
+/*  MOD001  Oct 17,2026         the batches call the libm_*_batch functions     */
+/*                              instead of turning the fast kernels off         */
+/********************************************************************************/
+
+#include <math.h>
+#include <memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "conifers.h"
+
+
+/* the batched equations, in the order a plant goes through them */
+#define IMPUTE_D6_HT_DBH            0       /* d6 from height and dbh, S5   */
+#define IMPUTE_D6_HT                1       /* d6 from height, S4           */
+#define IMPUTE_DBH                  2       /* dbh from height and d6, S7   */
+#define IMPUTE_CW                   3       /* crown width, S1              */
+#define IMPUTE_EXPF                 4       /* expf from cover, S8          */
+#define IMPUTE_CR                   5       /* crown ratio, S3              */
+#define IMPUTE_MCW                  6       /* max crown width, S2          */
+#define IMPUTE_EQUATIONS            7
+
+/* the steps of the first pass for a plant, see first_pass_for_plant */
+#define STEP_CHECK                  0       /* check the plant, d6          */
+#define STEP_DBH                    1       /* dbh                          */
+#define STEP_CW                     2       /* expf, areas, crown width     */
+#define STEP_EXPF                   3       /* crown area, expf from cover  */
+#define STEP_DONE                   4
+
+/* the plant flags for the second pass */
+#define FLAG_CR                     0x01    /* the crown ratio was imputed  */
+#define FLAG_CR_FAILED              0x02
+#define FLAG_TREE                   0x04    /* so was the max crown width   */
+#define FLAG_MCW_FAILED             0x08
+
+/* what goes with each equation */
+struct IMPUTE_STATE
+{
+   struct SPECIES_RECORD   *species_ptr;
+   unsigned long           n_coeffs;
+   struct COEFFS_RECORD    *coeffs_ptr;
+   struct PLANT_RECORD     *plants_ptr;
+   unsigned char           *flags_ptr;
+   unsigned long           error_count;
+   double                  fixed_plot_radius;
+   double                  min_dbh;
+   double                  baf;
+
+   /* the kernel, the errors bit for a failure and the next step */
+   /* of the first pass, and a batch for each functional species */
+   void                    (*kernel[IMPUTE_EQUATIONS])( struct IMPUTE_BATCH * );
+   unsigned long           error[IMPUTE_EQUATIONS];
+   unsigned long           next_step[IMPUTE_EQUATIONS];
+   struct IMPUTE_BATCH     *batches_ptr[IMPUTE_EQUATIONS];
+};
+
+static void first_pass_for_plant(
+   struct IMPUTE_STATE     *state_ptr,
+   struct PLANT_RECORD     *plant_ptr,
+   unsigned long           step );
+
+static void add_to_impute_batch(
+   struct IMPUTE_STATE     *state_ptr,
+   unsigned long           equation,
+   struct PLANT_RECORD     *plant_ptr );
+
+static void run_impute_batch(
+   struct IMPUTE_STATE     *state_ptr,
+   unsigned long           equation,
+   struct IMPUTE_BATCH     *batch_ptr );
+
+static void run_impute_batches(
+   struct IMPUTE_STATE     *state_ptr,
+   unsigned long           first,
+   unsigned long           last );
+
+
+/********************************************************************************/
+/* impute_in_batches                                                            */
+/********************************************************************************/
+/*  Description :   fills in the missing values in the plant list, for the      */
+/*                  variants that impute with the swo equations (S1-S8) or      */
+/*                  their own versions of them                                  */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the equations are run over GROWTH_BATCH_SIZE plants from    */
+/*                  one functional species at a time. in the first pass each    */
+/*                  plant goes through the steps of first_pass_for_plant until  */
+/*                  it's missing a value, and waits in the batch for that       */
+/*                  equation and its functional species. when the batch is      */
+/*                  full it's run and its plants go on to their next step, so   */
+/*                  the plant list is only read once for each pass. the         */
+/*                  equations for a plant only depend on the plant, so the      */
+/*                  values and the errors bits come out the same as filling     */
+/*                  in one plant at a time. the one exception is the crown      */
+/*                  ratio error, which has always been set from the last        */
+/*                  return code, so a plant that didn't need a crown ratio      */
+/*                  gets E_INVALID_CR when the max crown width of the tree      */
+/*                  before it (or calc_plot_stats_2 for the plants before the   */
+/*                  first tree) failed. that's replayed in plant order at the   */
+/*                  end. the imputation always uses the math library, not the   */
+/*                  fast kernels (see libm_exp_batch)                           */
+/*  Arguments   :   the same as VARIANT_RECORD impute, along with               */
+/*                  kernels_ptr - the variant's batched imputation equations    */
+/********************************************************************************/
+void impute_in_batches(
+   unsigned long           *return_code,
+   unsigned long           n_species,
+   struct SPECIES_RECORD   *species_ptr,
+   unsigned long           n_coeffs,
+   struct COEFFS_RECORD    *coeffs_ptr,
+   unsigned long           n_plants,
+   struct PLANT_RECORD     *plants_ptr,
+   unsigned long           n_points,
+   struct PLOT_RECORD      *plots_ptr,
+   double                  fixed_plot_radius,
+   double                  min_dbh,
+   double                  baf,
+   const struct IMPUTE_KERNELS *kernels_ptr )
+{
+
+   unsigned long           i;
+   unsigned long           j;
+   unsigned long           failed;
+   struct IMPUTE_BATCH     *batches_ptr;
+   struct PLANT_RECORD     *plant_ptr;
+   struct COEFFS_RECORD    *c_ptr;
+   struct IMPUTE_STATE     state;
+
+   *return_code = CONIFERS_SUCCESS;
+
+   /* first check to make sure there are plants in the array */
+   if( n_plants <= 0 || plants_ptr == NULL )
+   {
+      *return_code = INVALID_PLANT_COUNT;
+      return;
+   }
+
+   /* and plots */
+   if( n_points <= 0 || plots_ptr == NULL )
+   {
+      *return_code = INVALID_PLOT_COUNT;
+      return;
+   }
+
+   /* the batches are kept by functional species */
+   for( i = 0; i < n_plants; i++ )
+   {
+      if( plants_ptr[i].sp_idx >= n_species ||
+          species_ptr[plants_ptr[i].sp_idx].fsp_idx >= n_coeffs )
+      {
+         *return_code = INVALID_FSP;
+         return;
+      }
+   }
+
+   state.flags_ptr = (unsigned char *)malloc( n_plants * sizeof( unsigned char ) );
+   batches_ptr     = (struct IMPUTE_BATCH *)malloc(
+                        IMPUTE_EQUATIONS * n_coeffs * sizeof( struct IMPUTE_BATCH ) );
+   if( state.flags_ptr == NULL || batches_ptr == NULL )
+   {
+      free( state.flags_ptr );
+      free( batches_ptr );
+      *return_code = FAILED_MEMORY_ALLOC;
+      return;
+   }
+
+   state.species_ptr       = species_ptr;
+   state.n_coeffs          = n_coeffs;
+   state.coeffs_ptr        = coeffs_ptr;
+   state.plants_ptr        = plants_ptr;
+   state.error_count       = 0;
+   state.fixed_plot_radius = fixed_plot_radius;
+   state.min_dbh           = min_dbh;
+   state.baf               = baf;
+
+   state.kernel[IMPUTE_D6_HT_DBH] = kernels_ptr->d6_from_ht_and_dbh;
+   state.kernel[IMPUTE_D6_HT]     = kernels_ptr->d6_from_total_height;
+   state.kernel[IMPUTE_DBH]       = kernels_ptr->dbh_from_height_and_d6;
+   state.kernel[IMPUTE_CW]        = kernels_ptr->crown_width;
+   state.kernel[IMPUTE_EXPF]      = kernels_ptr->exp_from_cover_and_ca;
+   state.kernel[IMPUTE_CR]        = kernels_ptr->crown_ratio;
+   state.kernel[IMPUTE_MCW]       = kernels_ptr->max_crown_width;
+
+   state.error[IMPUTE_D6_HT_DBH]  = E_INVALID_D6;
+   state.error[IMPUTE_D6_HT]      = E_INVALID_D6;
+   state.error[IMPUTE_DBH]        = E_INVALID_DBH;
+   state.error[IMPUTE_CW]         = E_INVALID_CW;
+   state.error[IMPUTE_EXPF]       = E_INVALID_EXPF;
+   state.error[IMPUTE_CR]         = E_OKDOKEY;      /* see the replay below */
+   state.error[IMPUTE_MCW]        = E_INVALID_MCW;
+
+   state.next_step[IMPUTE_D6_HT_DBH] = STEP_DBH;
+   state.next_step[IMPUTE_D6_HT]     = STEP_DBH;
+   state.next_step[IMPUTE_DBH]       = STEP_CW;
+   state.next_step[IMPUTE_CW]        = STEP_EXPF;
+   state.next_step[IMPUTE_EXPF]      = STEP_DONE;
+   state.next_step[IMPUTE_CR]        = STEP_DONE;
+   state.next_step[IMPUTE_MCW]       = STEP_DONE;
+
+   for( j = 0; j < IMPUTE_EQUATIONS; j++ )
+   {
+      state.batches_ptr[j] = &batches_ptr[j * n_coeffs];
+      for( i = 0; i < n_coeffs; i++ )
+      {
+         state.batches_ptr[j][i].n     = 0;
+         state.batches_ptr[j][i].c_ptr = &coeffs_ptr[i];
+      }
+   }
+
+   /* FIRST PASS */
+   /* fill in missing dbh, d6, crown widths and expansion      */
+   /* factors. the batches that aren't full are run at the end */
+   plant_ptr = &plants_ptr[0];
+   for( i = 0; i < n_plants; i++, plant_ptr++ )
+   {
+      first_pass_for_plant( &state, plant_ptr, STEP_CHECK );
+   }
+   run_impute_batches( &state, IMPUTE_D6_HT_DBH, IMPUTE_EXPF );
+
+   calc_plot_stats_2( return_code,
+                      n_species,
+                      species_ptr,
+                      n_coeffs,
+                      coeffs_ptr,
+                      n_plants,
+                      plants_ptr,
+                      n_points,
+                      plots_ptr );
+
+   /* SECOND PASS */
+   /* The second pass is required becuase the crown values are */
+   /* dependent on the basic plot summary statistics which are */
+   /* calculated for the plot before hand. calc_plot_stats_2   */
+   /* can sort the plant list, so the flags are set here       */
+   plant_ptr = &plants_ptr[0];
+   for( i = 0; i < n_plants; i++, plant_ptr++ )
+   {
+      state.flags_ptr[i] = 0;
+
+      /* fill in the percent cover for the plant record */
+      if( plant_ptr->pct_cover == 0.0 )
+      {
+         plant_ptr->pct_cover = 100.0 * plant_ptr->expf * plant_ptr->crown_area / SQ_FT_PER_ACRE;
+      }
+
+      plant_ptr->max_crown_width = 0.0;
+
+      c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
+      if( is_tree( c_ptr ) )
+      {
+         if( plant_ptr->cr <= 0.0 || plant_ptr->cr > 1.0 )
+         {
+            state.flags_ptr[i] |= FLAG_CR;
+            add_to_impute_batch( &state, IMPUTE_CR, plant_ptr );
+         }
+
+         state.flags_ptr[i] |= FLAG_TREE;
+         add_to_impute_batch( &state, IMPUTE_MCW, plant_ptr );
+      }
+   }
+   run_impute_batches( &state, IMPUTE_CR, IMPUTE_MCW );
+
+   /* the crown ratio errors, from the last return code */
+   failed = ( *return_code != CONIFERS_SUCCESS );
+   for( i = 0; i < n_plants; i++ )
+   {
+      if( state.flags_ptr[i] & FLAG_CR )
+      {
+         failed = ( state.flags_ptr[i] & FLAG_CR_FAILED ) != 0;
+      }
+
+      if( failed )
+      {
+         plants_ptr[i].errors |= E_INVALID_CR;
+         state.error_count += 1;
+      }
+
+      if( state.flags_ptr[i] & FLAG_TREE )
+      {
+         failed = ( state.flags_ptr[i] & FLAG_MCW_FAILED ) != 0;
+      }
+   }
+
+   free( state.flags_ptr );
+   free( batches_ptr );
+
+   if( state.error_count > 0 )
+   {
+      *return_code = FILL_VALUES_ERROR;
+      return;
+   }
+   *return_code = CONIFERS_SUCCESS;
+
+}
+
+
+/* the first pass for a plant, from step until it's done or */
+/* waiting in a batch for one of the equations              */
+static void first_pass_for_plant(
+   struct IMPUTE_STATE     *state_ptr,
+   struct PLANT_RECORD     *plant_ptr,
+   unsigned long           step )
+{
+
+   struct COEFFS_RECORD    *c_ptr;
+
+   c_ptr = &state_ptr->coeffs_ptr[state_ptr->species_ptr[plant_ptr->sp_idx].fsp_idx];
+
+   if( step == STEP_CHECK )
+   {
+      plant_ptr->errors = E_OKDOKEY; /* default value for error is set=ok */
+
+      /* only fill in missing values for stocked plots */
+      if( is_non_stocked( c_ptr ) )
+      {
+         return;
+      }
+
+      /* if the stem is all below d6  */
+      if( plant_ptr->tht < 0.50 )
+      {
+         plant_ptr->errors |= E_INVALID_HEIGHT;
+         state_ptr->error_count += 1;
+      }
+
+      /* if the total height <= 4.5 and there's a dbh obs */
+      /* this error triggers on plants that are exactly 4.5 feet tall */
+      /* and have a positive dbh observation                          */
+      if( plant_ptr->tht < 4.5 && plant_ptr->dbh > 0.0 )
+      {
+         plant_ptr->errors |= E_INVALID_DBH;
+         state_ptr->error_count += 1;
+      }
+
+      /* if it's not a tree and has a dbh obs */
+      if( !is_tree( c_ptr ) && plant_ptr->dbh > 0.0 )
+      {
+         plant_ptr->errors |= E_INVALID_DBH;
+         state_ptr->error_count += 1;
+      }
+
+      /* the d6 for the trees and shrubs that are at least 6" tall */
+      if( plant_ptr->tht >= 0.50 && plant_ptr->d6 == 0.0 )
+      {
+         if( is_tree( c_ptr ) && plant_ptr->dbh > 0.0 && plant_ptr->tht > 4.5 )
+         {
+            add_to_impute_batch( state_ptr, IMPUTE_D6_HT_DBH, plant_ptr );
+            return;
+         }
+
+         if( is_tree( c_ptr ) || is_shrub( c_ptr ) )
+         {
+            add_to_impute_batch( state_ptr, IMPUTE_D6_HT, plant_ptr );
+            return;
+         }
+      }
+
+      step = STEP_DBH;
+   }
+
+   if( step == STEP_DBH )
+   {
+      /* the dbh for the trees taller than 4.5 feet */
+      if( is_tree( c_ptr ) &&
+          plant_ptr->d6 > 0.0 && plant_ptr->dbh == 0.0 && plant_ptr->tht > 4.5 )
+      {
+         add_to_impute_batch( state_ptr, IMPUTE_DBH, plant_ptr );
+         return;
+      }
+
+      step = STEP_CW;
+   }
+
+   if( step == STEP_CW )
+   {
+      /* the expansion factor from the sample design */
+      if( is_tree( c_ptr ) && plant_ptr->tht >= 0.50 &&
+          plant_ptr->expf <= 0.0 && state_ptr->fixed_plot_radius > 0.0 )
+      {
+         if( plant_ptr->errors & E_INVALID_DBH )
+         {
+            plant_ptr->expf = 0;
+            plant_ptr->errors |= E_INVALID_EXPF;
+            state_ptr->error_count += 1;
+         }
+         else if( plant_ptr->dbh > state_ptr->min_dbh )
+         {
+            plant_ptr->expf = state_ptr->baf / ( plant_ptr->dbh * plant_ptr->dbh * FC_I );
+         }
+         else
+         {
+            plant_ptr->expf = SQ_FT_PER_ACRE /
+               ( state_ptr->fixed_plot_radius * state_ptr->fixed_plot_radius * MY_PI );
+         }
+
+         /* multiply the expansion factor by the number of   */
+         /* stems that this plant record represents          */
+         plant_ptr->expf *= plant_ptr->n_stems;
+      }
+
+      /* fill in the remaining values */
+      plant_ptr->d6_area    = plant_ptr->d6 * plant_ptr->d6 * FC_I;
+      plant_ptr->basal_area = plant_ptr->dbh * plant_ptr->dbh * FC_I;
+      plant_ptr->d12_area   = plant_ptr->d12 * plant_ptr->d12 * FC_I;
+
+      if( plant_ptr->crown_width <= 0.0 )
+      {
+         add_to_impute_batch( state_ptr, IMPUTE_CW, plant_ptr );
+         return;
+      }
+
+      step = STEP_EXPF;
+   }
+
+   if( step == STEP_EXPF )
+   {
+      /* this should happen no matter what... */
+      plant_ptr->crown_area = plant_ptr->crown_width * plant_ptr->crown_width * MY_PI / 4.0;
+
+      /* the expansion factors for the plants entered by cover, */
+      /* mostly shrubs                                          */
+      if( plant_ptr->expf <= 0.0 )
+      {
+         add_to_impute_batch( state_ptr, IMPUTE_EXPF, plant_ptr );
+         return;
+      }
+   }
+
+}
+
+
+/* adds the plant to the equation's batch for its functional */
+/* species, and runs the batch when it's full                */
+static void add_to_impute_batch(
+   struct IMPUTE_STATE     *state_ptr,
+   unsigned long           equation,
+   struct PLANT_RECORD     *plant_ptr )
+{
+
+   struct IMPUTE_BATCH     *batch_ptr;
+
+   batch_ptr = &state_ptr->batches_ptr[equation][state_ptr->species_ptr[plant_ptr->sp_idx].fsp_idx];
+   batch_ptr->plant_ptr[batch_ptr->n++] = plant_ptr;
+
+   if( batch_ptr->n == GROWTH_BATCH_SIZE )
+   {
+      run_impute_batch( state_ptr, equation, batch_ptr );
+   }
+
+}
+
+
+/* runs the equation over the batch and empties it. the plants  */
+/* it fails on get the equation's error, and the plants go on   */
+/* to the next step of the first pass. a plant only goes on to  */
+/* later equations, so the batch isn't added to while its       */
+/* plants are on their next step                                */
+static void run_impute_batch(
+   struct IMPUTE_STATE     *state_ptr,
+   unsigned long           equation,
+   struct IMPUTE_BATCH     *batch_ptr )
+{
+
+   unsigned long           k;
+   unsigned long           n;
+   unsigned long           plant_idx;
+   struct PLANT_RECORD     *plant_ptr;
+
+   state_ptr->kernel[equation]( batch_ptr );
+
+   n            = batch_ptr->n;
+   batch_ptr->n = 0;
+
+   for( k = 0; k < n; k++ )
+   {
+      plant_ptr = batch_ptr->plant_ptr[k];
+      plant_idx = (unsigned long)( plant_ptr - state_ptr->plants_ptr );
+
+      if( batch_ptr->return_code[k] != CONIFERS_SUCCESS )
+      {
+         if( equation == IMPUTE_CR )
+         {
+            state_ptr->flags_ptr[plant_idx] |= FLAG_CR_FAILED;
+         }
+         if( equation == IMPUTE_MCW )
+         {
+            state_ptr->flags_ptr[plant_idx] |= FLAG_MCW_FAILED;
+         }
+
+         if( state_ptr->error[equation] != E_OKDOKEY )
+         {
+            plant_ptr->errors |= state_ptr->error[equation];
+            state_ptr->error_count += 1;
+         }
+      }
+
+      if( state_ptr->next_step[equation] != STEP_DONE )
+      {
+         first_pass_for_plant( state_ptr, plant_ptr, state_ptr->next_step[equation] );
+      }
+   }
+
+}
+
+
+/* runs the batches that aren't empty for the equations first */
+/* to last, in order, since the plants in the earlier batches  */
+/* can go on to the later ones                                 */
+static void run_impute_batches(
+   struct IMPUTE_STATE     *state_ptr,
+   unsigned long           first,
+   unsigned long           last )
+{
+
+   unsigned long   equation;
+   unsigned long   i;
+
+   for( equation = first; equation <= last; equation++ )
+   {
+      for( i = 0; i < state_ptr->n_coeffs; i++ )
+      {
+         if( state_ptr->batches_ptr[equation][i].n > 0 )
+         {
+            run_impute_batch( state_ptr, equation, &state_ptr->batches_ptr[equation][i] );
+         }
+      }
+   }
+
+}
+
+
+/********************************************************************************/
+/* calc_crown_width_batch                                   S1                  */
+/********************************************************************************/
+/*  Description :   crown width and area for the plants in the batch            */
+/*  Comments    :   calc_crown_width_batch_to_max caps the crown area at        */
+/*                  max_crown_area, calc_crown_width_batch at 2827 square       */
+/*                  feet (a 60 foot crown width)                                */
+/********************************************************************************/
+/*  Formula : CA = exp( b0 + b1 * ln( 144 * d6 area ) + b2 * ln( H ) )          */
+/*            CW = sqrt( 4 * CA / pi )                                          */
+/*  Coeffs  : CW                                                                */
+/********************************************************************************/
+void calc_crown_width_batch( struct IMPUTE_BATCH *batch_ptr )
+{
+   calc_crown_width_batch_to_max( batch_ptr, 2827.0 );
+}
+
+void calc_crown_width_batch_to_max(
+   struct IMPUTE_BATCH     *batch_ptr,
+   double                  max_crown_area )
+{
+
+   unsigned long   k;
+   unsigned long   n;
+   double          b0;
+   double          b1;
+   double          b2;
+   double          tht[GROWTH_BATCH_SIZE];
+   double          log_d6_area[GROWTH_BATCH_SIZE];
+   double          log_tht[GROWTH_BATCH_SIZE];
+   double          crown_area[GROWTH_BATCH_SIZE];
+   double          crown_width[GROWTH_BATCH_SIZE];
+
+   n  = batch_ptr->n;
+   b0 = batch_ptr->c_ptr->crown_width[0];
+   b1 = batch_ptr->c_ptr->crown_width[1];
+   b2 = batch_ptr->c_ptr->crown_width[2];
+
+   for( k = 0; k < n; k++ )
+   {
+      tht[k]         = batch_ptr->plant_ptr[k]->tht;
+      log_d6_area[k] = tht[k] < 0.51 ? 1.0 : batch_ptr->plant_ptr[k]->d6_area * 144.0;
+      log_tht[k]     = tht[k] < 0.51 ? 1.0 : tht[k];
+   }
+
+   libm_log_batch( n, log_d6_area, log_d6_area );
+   libm_log_batch( n, log_tht, log_tht );
+
+   for( k = 0; k < n; k++ )
+   {
+      crown_area[k] = b0 + b1 * log_d6_area[k] + b2 * log_tht[k];
+   }
+
+   libm_exp_batch( n, crown_area, crown_area );
+
+   for( k = 0; k < n; k++ )
+   {
+      if( crown_area[k] > max_crown_area )
+      {
+         crown_area[k] = max_crown_area;
+      }
+      crown_width[k] = sqrt( crown_area[k] * ONE_OVER_PI * 4.0 );
+
+      if( tht[k] < 0.51 )
+      {
+         crown_width[k] = 0.25;
+         crown_area[k]  = 0.04908739;
+      }
+
+      batch_ptr->return_code[k] = CONIFERS_SUCCESS;
+      if( tht[k] <= 0.0 || crown_width[k] < 0.0 )
+      {
+         crown_width[k] = 0.0;
+         crown_area[k]  = 0.0;
+         batch_ptr->return_code[k] = tht[k] <= 0.0 ? INVALID_INPUT_VAL : CONIFERS_ERROR;
+      }
+   }
+
+   for( k = 0; k < n; k++ )
+   {
+      batch_ptr->plant_ptr[k]->crown_width = crown_width[k];
+      batch_ptr->plant_ptr[k]->crown_area  = crown_area[k];
+   }
+
+}
+
+
+/********************************************************************************/
+/* calc_max_crown_width_batch                               S2                  */
+/********************************************************************************/
+/*  Description :   max crown width for the plants in the batch                 */
+/********************************************************************************/
+/*  Formula : mcw = b0 + b1 * dbh + b2 * dbh * dbh                              */
+/*            mcw = b0 * H / 4.5 for plants up to 4.5 feet tall                 */
+/*  Source  : Paine and Hann                                                    */
+/*  Coeffs  : MW                                                                */
+/********************************************************************************/
+void calc_max_crown_width_batch( struct IMPUTE_BATCH *batch_ptr )
+{
+
+   unsigned long   k;
+   unsigned long   n;
+   double          b0;
+   double          b1;
+   double          b2;
+   double          dbh;
+   double          tht;
+   double          mcw[GROWTH_BATCH_SIZE];
+
+   n  = batch_ptr->n;
+   b0 = batch_ptr->c_ptr->max_crown_width[0];
+   b1 = batch_ptr->c_ptr->max_crown_width[1];
+   b2 = batch_ptr->c_ptr->max_crown_width[2];
+
+   for( k = 0; k < n; k++ )
+   {
+      dbh = batch_ptr->plant_ptr[k]->dbh;
+      tht = batch_ptr->plant_ptr[k]->tht;
+
+      if( tht <= 4.5 )
+      {
+         mcw[k] = b0 * ( tht / 4.5 );
+      }
+      else
+      {
+         mcw[k] = b0 + b1 * dbh + b2 * dbh * dbh;
+      }
+
+      batch_ptr->return_code[k] = CONIFERS_SUCCESS;
+      if( dbh < 0.0 || mcw[k] < 0.0 )
+      {
+         mcw[k] = 0.0;
+         batch_ptr->return_code[k] = dbh < 0.0 ? INVALID_INPUT_VAL : CONIFERS_ERROR;
+      }
+   }
+
+   for( k = 0; k < n; k++ )
+   {
+      batch_ptr->plant_ptr[k]->max_crown_width = mcw[k];
+   }
+
+}
+
+
+/********************************************************************************/
+/* calc_crown_ratio_batch                                   S3                  */
+/********************************************************************************/
+/*  Description :   crown ratio for the plants in the batch                     */
+/********************************************************************************/
+/*  Formula : CL = b0 * H^b1 * exp( b3 * d6 / H ), CL = b0 * H for H <= 1       */
+/*            CR = CL / H, between 0 and 1                                      */
+/*  Source  : Ritchie May 2008                                                  */
+/*  Coeffs  : CR                                                                */
+/********************************************************************************/
+void calc_crown_ratio_batch( struct IMPUTE_BATCH *batch_ptr )
+{
+
+   unsigned long   k;
+   unsigned long   n;
+   double          b0;
+   double          b1;
+   double          b3;
+   double          tht[GROWTH_BATCH_SIZE];
+   double          d6[GROWTH_BATCH_SIZE];
+   double          pow_tht[GROWTH_BATCH_SIZE];
+   double          exp_term[GROWTH_BATCH_SIZE];
+   double          cr[GROWTH_BATCH_SIZE];
+
+   n  = batch_ptr->n;
+   b0 = batch_ptr->c_ptr->crown_ratio[0];
+   b1 = batch_ptr->c_ptr->crown_ratio[1];
+   b3 = batch_ptr->c_ptr->crown_ratio[3];
+
+   for( k = 0; k < n; k++ )
+   {
+      tht[k]      = batch_ptr->plant_ptr[k]->tht;
+      d6[k]       = batch_ptr->plant_ptr[k]->d6;
+      exp_term[k] = b3 * ( d6[k] / tht[k] );
+   }
+
+   libm_pow_batch( n, tht, b1, pow_tht );
+   libm_exp_batch( n, exp_term, exp_term );
+
+   for( k = 0; k < n; k++ )
+   {
+      cr[k] = b0 * pow_tht[k] * exp_term[k];
+      if( tht[k] <= 1.0 )
+      {
+         cr[k] = b0 * tht[k];
+      }
+
+      cr[k] = cr[k] / tht[k];
+      if( cr[k] < 0.0 )
+      {
+         cr[k] = 0.0;
+      }
+      if( cr[k] > 1.0 )
+      {
+         cr[k] = 1.0;
+      }
+
+      batch_ptr->return_code[k] = CONIFERS_SUCCESS;
+      if( tht[k] <= 0.0 || d6[k] <= 0.0 )
+      {
+         cr[k] = 0.0;
+         batch_ptr->return_code[k] = INVALID_INPUT_VAL;
+      }
+   }
+
+   for( k = 0; k < n; k++ )
+   {
+      batch_ptr->plant_ptr[k]->cr = cr[k];
+   }
+
+}
+
+
+/********************************************************************************/
+/* calc_d6_from_total_height_batch                          S4                  */
+/********************************************************************************/
+/*  Description :   basal diameter from the total height for the plants in     */
+/*                  the batch                                                   */
+/********************************************************************************/
+/*  Formula : ln( D6 ) = b0 + b1 * ln( H - 0.5 ), D6 = 0.1 for H <= 0.5         */
+/*  Source  : Ritchie, Static Height Diameter Equations S3                      */
+/*  Coeffs  : MS                                                                */
+/********************************************************************************/
+void calc_d6_from_total_height_batch( struct IMPUTE_BATCH *batch_ptr )
+{
+
+   unsigned long   k;
+   unsigned long   n;
+   double          b0;
+   double          b1;
+   double          tht[GROWTH_BATCH_SIZE];
+   double          d6[GROWTH_BATCH_SIZE];
+
+   n  = batch_ptr->n;
+   b0 = batch_ptr->c_ptr->d6_ht[0];
+   b1 = batch_ptr->c_ptr->d6_ht[1];
+
+   for( k = 0; k < n; k++ )
+   {
+      tht[k] = batch_ptr->plant_ptr[k]->tht;
+      d6[k]  = tht[k] > 0.5 ? tht[k] - 0.5 : 1.0;
+   }
+
+   libm_log_batch( n, d6, d6 );
+
+   for( k = 0; k < n; k++ )
+   {
+      d6[k] = b0 + b1 * d6[k];
+   }
+
+   libm_exp_batch( n, d6, d6 );
+
+   for( k = 0; k < n; k++ )
+   {
+      batch_ptr->return_code[k] = CONIFERS_SUCCESS;
+      if( !( tht[k] > 0.5 ) )
+      {
+         d6[k] = 0.1;
+         batch_ptr->return_code[k] = CONIFERS_ERROR;
+      }
+      if( d6[k] < 0.0 )
+      {
+         d6[k] = 0.0;
+         batch_ptr->return_code[k] = CONIFERS_ERROR;
+      }
+   }
+
+   for( k = 0; k < n; k++ )
+   {
+      batch_ptr->plant_ptr[k]->d6 = d6[k];
+   }
+
+}
+
+
+/********************************************************************************/
+/* calc_d6_from_ht_and_dbh_batch                            S5                  */
+/********************************************************************************/
+/*  Description :   basal diameter from the total height and dbh for the       */
+/*                  plants in the batch                                         */
+/*  Comments    :   the d6 isn't changed for plants up to 4.5 feet tall         */
+/********************************************************************************/
+/*  Formula : D6 = dbh / ( b0 - b1 * exp( -b2 * ( H - 4.5 ) ) )                 */
+/*  Source  : Ritchie Static Height Diameter Equations, S5                      */
+/*  Coeffs  : DH                                                                */
+/********************************************************************************/
+void calc_d6_from_ht_and_dbh_batch( struct IMPUTE_BATCH *batch_ptr )
+{
+
+   unsigned long   k;
+   unsigned long   n;
+   double          b0;
+   double          b1;
+   double          b2;
+   double          tht[GROWTH_BATCH_SIZE];
+   double          d6[GROWTH_BATCH_SIZE];
+   double          exp_term[GROWTH_BATCH_SIZE];
+
+   n  = batch_ptr->n;
+   b0 = batch_ptr->c_ptr->d6_ht_dbh[0];
+   b1 = batch_ptr->c_ptr->d6_ht_dbh[1];
+   b2 = batch_ptr->c_ptr->d6_ht_dbh[2];
+
+   for( k = 0; k < n; k++ )
+   {
+      tht[k]      = batch_ptr->plant_ptr[k]->tht;
+      exp_term[k] = -b2 * ( tht[k] - 4.5 );
+   }
+
+   libm_exp_batch( n, exp_term, exp_term );
+
+   for( k = 0; k < n; k++ )
+   {
+      d6[k] = batch_ptr->plant_ptr[k]->dbh / ( b0 - b1 * exp_term[k] );
+
+      batch_ptr->return_code[k] = CONIFERS_SUCCESS;
+      if( d6[k] < 0.0 )
+      {
+         d6[k] = 0.0;
+         batch_ptr->return_code[k] = CONIFERS_ERROR;
+      }
+      if( tht[k] <= 4.5 )
+      {
+         d6[k] = batch_ptr->plant_ptr[k]->d6;
+         batch_ptr->return_code[k] = INVALID_INPUT_VAL;
+      }
+   }
+
+   for( k = 0; k < n; k++ )
+   {
+      batch_ptr->plant_ptr[k]->d6 = d6[k];
+   }
+
+}
+
+
+/********************************************************************************/
+/* calc_dbh_from_height_and_d6_batch                        S7                  */
+/********************************************************************************/
+/*  Description :   dbh from the total height and basal diameter for the       */
+/*                  plants in the batch                                         */
+/*  Comments    :   the dbh isn't changed for plants up to 4.5 feet tall        */
+/********************************************************************************/
+/*  Formula : dbh = d6 * ( b0 - b1 * exp( -b2 * ( H - 4.5 ) ) ), at least 0.1   */
+/*  Source  : Ritchie, see d6_from_height_and_dbh                               */
+/*  Coeffs  : DH                                                                */
+/********************************************************************************/
+void calc_dbh_from_height_and_d6_batch( struct IMPUTE_BATCH *batch_ptr )
+{
+
+   unsigned long   k;
+   unsigned long   n;
+   double          b0;
+   double          b1;
+   double          b2;
+   double          tht[GROWTH_BATCH_SIZE];
+   double          dbh[GROWTH_BATCH_SIZE];
+   double          exp_term[GROWTH_BATCH_SIZE];
+
+   n  = batch_ptr->n;
+   b0 = batch_ptr->c_ptr->d6_ht_dbh[0];
+   b1 = batch_ptr->c_ptr->d6_ht_dbh[1];
+   b2 = batch_ptr->c_ptr->d6_ht_dbh[2];
+
+   for( k = 0; k < n; k++ )
+   {
+      tht[k]      = batch_ptr->plant_ptr[k]->tht;
+      exp_term[k] = -b2 * ( tht[k] - 4.5 );
+   }
+
+   libm_exp_batch( n, exp_term, exp_term );
+
+   for( k = 0; k < n; k++ )
+   {
+      dbh[k] = batch_ptr->plant_ptr[k]->d6 * ( b0 - b1 * exp_term[k] );
+      if( dbh[k] < 0.0 )
+      {
+         dbh[k] = 0.1;
+      }
+
+      batch_ptr->return_code[k] = CONIFERS_SUCCESS;
+      if( tht[k] <= 4.5 )
+      {
+         dbh[k] = batch_ptr->plant_ptr[k]->dbh;
+         batch_ptr->return_code[k] = INVALID_INPUT_VAL;
+      }
+   }
+
+   for( k = 0; k < n; k++ )
+   {
+      batch_ptr->plant_ptr[k]->dbh = dbh[k];
+   }
+
+}
+
+
+/********************************************************************************/
+/* calc_exp_from_cover_and_ca_batch                         S8                  */
+/********************************************************************************/
+/*  Description :   expansion factor from the percent cover and crown area     */
+/*                  for the plants in the batch                                 */
+/*  Comments    :   the expf is 0 for a cover outside of [0,100] or a crown     */
+/*                  area that isn't positive                                    */
+/********************************************************************************/
+/*  Formula : expf = ( 43560 * pct_cover / 100 ) / CA                           */
+/*  Coeffs  : none                                                              */
+/********************************************************************************/
+void calc_exp_from_cover_and_ca_batch( struct IMPUTE_BATCH *batch_ptr )
+{
+
+   unsigned long   k;
+   unsigned long   n;
+   double          pct_cover;
+   double          crown_area;
+   double          expf[GROWTH_BATCH_SIZE];
+
+   n = batch_ptr->n;
+   for( k = 0; k < n; k++ )
+   {
+      pct_cover  = batch_ptr->plant_ptr[k]->pct_cover;
+      crown_area = batch_ptr->plant_ptr[k]->crown_area;
+
+      expf[k] = SQ_FT_PER_ACRE * pct_cover * 0.01 / crown_area;
+
+      batch_ptr->return_code[k] = CONIFERS_SUCCESS;
+      if( pct_cover < 0.0 || pct_cover > 100.0 || crown_area <= 0.0 )
+      {
+         expf[k] = 0.0;
+         batch_ptr->return_code[k] = CONIFERS_ERROR;
+      }
+   }
+
+   for( k = 0; k < n; k++ )
+   {
+      batch_ptr->plant_ptr[k]->expf = expf[k];
+   }
+
+}
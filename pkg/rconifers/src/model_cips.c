@@ -32,6 +32,7 @@
 
 
 
+#include <float.h>
 #include <math.h>
 #include <memory.h>
 #include <stdio.h>
@@ -52,6 +53,29 @@
 #define BOUND(X, L, U) ( (X) < (L) ? (L) : ( (X) > (U) ? (U) : (X) ) )
 #define INCDOWN(X, place) X -= pow(10.0f, -(place) )
 
+/* steps of the psi and age searches that land closer than this to the */
+/* root are checked against the curve, see flewelling_digit_search     */
+#define FLEWELLING_ROOT_TOL 1.0e-9
+
+/* the parameters of the Flewelling et al. (2002) top height curve for */
+/* one psi. they don't depend on the age, so a curve that is evaluated */
+/* at several ages only has to be built once                           */
+struct FLEWELLING_CURVE
+{
+    double  psi;        /* PSI  = PSI computed elsewhere                */
+    double  ht0;        /* HT0  = average height of the planted stock   */
+    double  b1;         /* growth rate at origin is b1 * PSI            */
+    double  c;          /* shape of the below-inflection curve          */
+    double  xk1;        /* start of the straight segment                */
+    double  xk2;        /* end of the straight segment                  */
+    double  yk1;        /* top height at xk1                            */
+    double  yk2;        /* top height at xk2                            */
+    double  alpha;
+    double  beta;
+    double  lambda1;
+    double  lambda2;
+};
+
 void get_delta_h_pot (
     double    psi,          /* PSI  = PSI computed elsewhere                */
     double    ht0,          /* HT0  = avg ht of the planted stock (ft)      */
@@ -76,6 +100,21 @@ static void flewelling_site_index(
 		double  x,
         double  *htop_output );
 
+static void build_flewelling_curve(
+		double                  psi,
+		double                  ht0,
+		struct FLEWELLING_CURVE *curve_ptr );
+
+static double eval_flewelling_curve(
+		struct FLEWELLING_CURVE *curve_ptr,
+		double                  x );
+
+static void cips_get_potential_height_growth(
+    struct PLOT_RECORD      *plot_ptr,
+    double                  h40,
+    double                  *psi,
+    double                  *delta_h_pot );
+
 /****************************************************************************/
 /* functions defining the model bahavior                                    */
 /****************************************************************************/
@@ -739,11 +778,10 @@ void cips_calc_height_growth(
         // stock_age = STOCK_AGE
         // x = 30.0 - STOCK_AGE, which in this case is assumed to be 2.0
         //get_psi( 28.0, FLEWELLING_ET_AL_2002_STOCK_HT0, flew_site, &psi );
-        get_psi( 28.0, FLEWELLING_ET_AL_2002_STOCK_HT0, plot_ptr->site_30, &psi );
-
-
         /*Get growth effective age and compute 1-year h40 growth (in feet) this year*/
-        get_delta_h_pot( psi, FLEWELLING_ET_AL_2002_STOCK_HT0, h40, &delta_h_pot );
+        /* both only depend on the plot's site index and h40, so they are */
+        /* computed once for the plot                                     */
+        cips_get_potential_height_growth( plot_ptr, h40, &psi, &delta_h_pot );
 
         /* Convert to centimeters */
         delta_h_pot *= FT2CM;
@@ -789,14 +827,17 @@ void cips_calc_height_growth(
     /* assign the debugging/test output variables to the spares */
     /* I need a mapping between the spare and the debugging variable */
     /* lables for integer variables */
-    plant_ptr->DBL_SPARE[0]         =   rel_height;
-    plant_ptr->DBL_SPARE[1]         =   rh_mod_hg;
-    plant_ptr->DBL_SPARE[2]         =   cv_mod_hg;
-    plant_ptr->DBL_SPARE[3]         =   delta_h_pot;
-    plant_ptr->DBL_SPARE[4]         =   psi;
-
-    /* assign the integer spares and debugging labels */
-    plant_ptr->INT_SPARE[0]         =   after_first_season;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[0] =   rel_height;
+        plant_ptr->diag->DBL_SPARE[1] =   rh_mod_hg;
+        plant_ptr->diag->DBL_SPARE[2] =   cv_mod_hg;
+        plant_ptr->diag->DBL_SPARE[3] =   delta_h_pot;
+        plant_ptr->diag->DBL_SPARE[4] =   psi;
+
+        /* assign the integer spares and debugging labels */
+        plant_ptr->diag->INT_SPARE[0] =   after_first_season;
+    }
 
 
 #endif
@@ -924,9 +965,12 @@ static void cips_calc_dbh_growth(
 #ifdef _DEBUG
 /* assign the debugging/test output variables to the spares */
 
-    plant_ptr->DBL_SPARE[5]         =   base_model;
-    plant_ptr->DBL_SPARE[6]         =   cv_mod_dg;
-//    plant_ptr->DBL_SPARE[7]         =   rh_mod_dg;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[5] =   base_model;
+        plant_ptr->diag->DBL_SPARE[6] =   cv_mod_dg;
+//        plant_ptr->diag->DBL_SPARE[7] =   rh_mod_dg;
+    }
 
 #endif
 
@@ -1388,7 +1432,10 @@ static void cips_calc_endemic_mortality(
 
 #ifdef _DEBUG
     /* assign the debugging/test output variables to the spares */
-    plant_ptr->DBL_SPARE[8]         =   prob_of_mortality;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[8] = prob_of_mortality;
+    }
 
 #endif
 
@@ -1449,7 +1496,10 @@ static void cips_calc_cw_growth(
     {
         plant_ptr->cw_growth    = 0.0;
 #ifdef _DEBUG
-    plant_ptr->DBL_SPARE[9]         =   plant_ptr->cw_growth;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    }
 #endif
         *return_code        = INVALID_COEFF;
         return;
@@ -1461,7 +1511,10 @@ static void cips_calc_cw_growth(
     {
  	    plant_ptr->cw_growth	=   0.0f;
 #ifdef _DEBUG
-    	plant_ptr->DBL_SPARE[9] =   plant_ptr->cw_growth;
+    	if( plant_ptr->diag != NULL )
+    	{
+    	    plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    	}
 #endif
 	    *return_code	        =   INVALID_INPUT_VAL;
 	    return;
@@ -1471,7 +1524,10 @@ static void cips_calc_cw_growth(
     {
  	    plant_ptr->cw_growth	=   0.0f;
 #ifdef _DEBUG
-    	plant_ptr->DBL_SPARE[9] =   plant_ptr->cw_growth;
+    	if( plant_ptr->diag != NULL )
+    	{
+    	    plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    	}
 #endif
 	    *return_code	        =   INVALID_INPUT_VAL;
 	    return;
@@ -1481,7 +1537,10 @@ static void cips_calc_cw_growth(
     {
         plant_ptr->cw_growth    = 0.0f;
 #ifdef _DEBUG
-    plant_ptr->DBL_SPARE[9]         =   plant_ptr->cw_growth;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    }
 #endif
 	    *return_code	        = CONIFERS_SUCCESS;
 	    return;
@@ -1528,7 +1587,10 @@ static void cips_calc_cw_growth(
 		 //*pred_cw_growth    = 0.10;  
           plant_ptr->cw_growth  = 0.10f;    /* Growth will be set to 0.10 */
 #ifdef _DEBUG
-    	  plant_ptr->DBL_SPARE[9]         =   plant_ptr->cw_growth;
+    	  if( plant_ptr->diag != NULL )
+    	  {
+    	      plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    	  }
 #endif
 		  *return_code           = CONIFERS_ERROR;
 		  return;
@@ -1536,7 +1598,10 @@ static void cips_calc_cw_growth(
 
         plant_ptr->cw_growth    = temp_cwg;
 #ifdef _DEBUG
-    	plant_ptr->DBL_SPARE[9]         =   plant_ptr->cw_growth;
+    	if( plant_ptr->diag != NULL )
+    	{
+    	    plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    	}
 #endif
 	    *return_code              = CONIFERS_SUCCESS;
 	    return;
@@ -1606,7 +1671,10 @@ static void cips_calc_cw_growth(
             //plant_ptr->crown_width  = 0.0f;
             plant_ptr->cw_growth  = 0.0f;
 #ifdef _DEBUG
-    plant_ptr->DBL_SPARE[9]         =   plant_ptr->cw_growth;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    }
 #endif
             *return_code            = CONIFERS_SUCCESS;
             return;
@@ -1626,7 +1694,10 @@ static void cips_calc_cw_growth(
             plant_ptr->cw_growth = temp_cwg;
 
 #ifdef _DEBUG
-    plant_ptr->DBL_SPARE[9]         =   plant_ptr->cw_growth;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    }
 #endif
             *return_code    = CONIFERS_SUCCESS;
             return;
@@ -1637,7 +1708,10 @@ static void cips_calc_cw_growth(
 
 
 #ifdef _DEBUG
-    plant_ptr->DBL_SPARE[9]         =   plant_ptr->cw_growth;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    }
 #endif
 
         *return_code     = CONIFERS_SUCCESS;
@@ -1648,7 +1722,10 @@ static void cips_calc_cw_growth(
 	{
       plant_ptr->cw_growth   =   0.0f;
 #ifdef _DEBUG
-    plant_ptr->DBL_SPARE[9]         =   plant_ptr->cw_growth;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    }
 #endif
 	  *return_code      =   INVALID_PLANT_TYPE;
 	  return;
@@ -1656,7 +1733,10 @@ static void cips_calc_cw_growth(
 
 
 #ifdef _DEBUG
-    plant_ptr->DBL_SPARE[9]         =   plant_ptr->cw_growth;
+    if( plant_ptr->diag != NULL )
+    {
+        plant_ptr->diag->DBL_SPARE[9] = plant_ptr->cw_growth;
+    }
 #endif
 
 }
@@ -1665,6 +1745,36 @@ static void cips_calc_cw_growth(
 
 
 
+/* returns psi and the potential height growth (ft) for the plot.    */
+/* get_psi and get_delta_h_pot each take dozens of evaluations of   */
+/* the site index curve, but only depend on the plot's site index   */
+/* and the stand's h40, so the values are kept on the plot and only */
+/* recomputed when either one changes                               */
+static void cips_get_potential_height_growth(
+    struct PLOT_RECORD      *plot_ptr,
+    double                  h40,
+    double                  *psi,
+    double                  *delta_h_pot )
+{
+
+    if( !plot_ptr->cips_psi_valid ||
+        plot_ptr->cips_psi_site_30 != plot_ptr->site_30 ||
+        plot_ptr->cips_psi_h40 != h40 )
+    {
+        get_psi( 28.0, FLEWELLING_ET_AL_2002_STOCK_HT0, plot_ptr->site_30, &plot_ptr->cips_psi );
+        get_delta_h_pot( plot_ptr->cips_psi, FLEWELLING_ET_AL_2002_STOCK_HT0, h40, &plot_ptr->cips_delta_h_pot );
+
+        plot_ptr->cips_psi_site_30  = plot_ptr->site_30;
+        plot_ptr->cips_psi_h40      = h40;
+        plot_ptr->cips_psi_valid    = 1;
+    }
+
+    *psi            = plot_ptr->cips_psi;
+    *delta_h_pot    = plot_ptr->cips_delta_h_pot;
+
+}
+
+
 /* this function computes the potential height growth, given the    */
 /* average height of the planted seedlings, the current top height  */
 /* and the psi value, which is computed elsewhere                   */
@@ -1692,6 +1802,211 @@ void get_delta_h_pot (
 }
 
 
+/* the age (and stock height) to evaluate the curve at, while */
+/* solving for psi                                            */
+struct FLEWELLING_AGE
+{
+    double  ht0;
+    double  x;
+};
+
+/* top height of the curve for psi at age x, for the root solver */
+static double flewelling_htop_at_psi(
+    double  psi,
+    void    *ctx_ptr )
+{
+    struct FLEWELLING_CURVE curve;
+    struct FLEWELLING_AGE   *at_ptr;
+
+    at_ptr = (struct FLEWELLING_AGE *)ctx_ptr;
+
+    build_flewelling_curve( psi, at_ptr->ht0, &curve );
+    return eval_flewelling_curve( &curve, at_ptr->x );
+}
+
+/* top height of a built curve at age x, for the root solver */
+static double flewelling_htop_at_age(
+    double  x,
+    void    *ctx_ptr )
+{
+    return eval_flewelling_curve( (struct FLEWELLING_CURVE *)ctx_ptr, x );
+}
+
+
+/* Brent's method for the v in [a,b] where htop_fn(v) == target. the  */
+/* root has to be bracketed, fa = htop_fn(a) - target <= 0 < fb.      */
+/* returns 1 and the root in *root once it's found to within tol,     */
+/* 0 if it doesn't converge                                           */
+static int solve_flewelling_root(
+    double  (*htop_fn)( double, void * ),
+    void    *ctx_ptr,
+    double  target,
+    double  a,
+    double  b,
+    double  fa,
+    double  fb,
+    double  tol,
+    double  *root )
+{
+    double  c, fc, d, e;
+    double  p, q, r, s;
+    double  tol1, xm, min1, min2;
+    int     iter;
+
+    c   = b;
+    fc  = fb;
+    d   = b - a;
+    e   = d;
+
+    for( iter = 0; iter < 100; iter++ )
+    {
+        if( ( fb > 0.0 && fc > 0.0 ) || ( fb < 0.0 && fc < 0.0 ) )
+        {
+            c   = a;
+            fc  = fa;
+            d   = b - a;
+            e   = d;
+        }
+        if( fabs( fc ) < fabs( fb ) )
+        {
+            a   = b;
+            b   = c;
+            c   = a;
+            fa  = fb;
+            fb  = fc;
+            fc  = fa;
+        }
+
+        tol1 = 2.0 * DBL_EPSILON * fabs( b ) + 0.5 * tol;
+        xm   = 0.5 * ( c - b );
+        if( fabs( xm ) <= tol1 || fb == 0.0 )
+        {
+            *root = b;
+            return 1;
+        }
+
+        if( fabs( e ) >= tol1 && fabs( fa ) > fabs( fb ) )
+        {
+            /* inverse quadratic interpolation, or secant */
+            s = fb / fa;
+            if( a == c )
+            {
+                p = 2.0 * xm * s;
+                q = 1.0 - s;
+            }
+            else
+            {
+                q = fa / fc;
+                r = fb / fc;
+                p = s * ( 2.0 * xm * q * ( q - r ) - ( b - a ) * ( r - 1.0 ) );
+                q = ( q - 1.0 ) * ( r - 1.0 ) * ( s - 1.0 );
+            }
+            if( p > 0.0 )
+            {
+                q = -q;
+            }
+            p    = fabs( p );
+            min1 = 3.0 * xm * q - fabs( tol1 * q );
+            min2 = fabs( e * q );
+            if( 2.0 * p < ( min1 < min2 ? min1 : min2 ) )
+            {
+                e = d;
+                d = p / q;
+            }
+            else
+            {
+                d = xm;
+                e = d;
+            }
+        }
+        else
+        {
+            /* bisection */
+            d = xm;
+            e = d;
+        }
+
+        a  = b;
+        fa = fb;
+        if( fabs( d ) > tol1 )
+        {
+            b += d;
+        }
+        else
+        {
+            b += ( xm >= 0.0 ? tol1 : -tol1 );
+        }
+        fb = htop_fn( b, ctx_ptr ) - target;
+    }
+
+    return 0;
+}
+
+
+/* the value the original digit by digit search (from the SAS macros)  */
+/* stops at: starting at start, step down by 10^-place while htop is   */
+/* above target, back up one step, and go on to the next place. the    */
+/* steps are taken the same way so the result is exactly the same,    */
+/* but when the root is known the curve only has to be evaluated for   */
+/* the steps that land within FLEWELLING_ROOT_TOL of it, since htop    */
+/* increases with both psi and age                                     */
+static double flewelling_digit_search(
+    double  (*htop_fn)( double, void * ),
+    void    *ctx_ptr,
+    double  target,
+    double  start,
+    int     first_place,
+    int     last_place,
+    double  init_last,
+    double  init_last_htop,
+    int     have_root,
+    double  root )
+{
+    double  cur;
+    double  last;
+    int     above;
+    int     last_above;
+    int     place;
+
+    cur         = start;
+    last        = init_last;
+    last_above  = ( init_last_htop > target );
+
+    if( have_root && fabs( cur - root ) > FLEWELLING_ROOT_TOL )
+    {
+        above = ( cur > root );
+    }
+    else
+    {
+        above = ( htop_fn( cur, ctx_ptr ) > target );
+    }
+
+    for( place = first_place; place <= last_place; place++ )
+    {
+        while( above )
+        {
+            last        = cur;
+            last_above  = above;
+            INCDOWN( cur, place );
+
+            if( have_root && fabs( cur - root ) > FLEWELLING_ROOT_TOL )
+            {
+                above = ( cur > root );
+            }
+            else
+            {
+                above = ( htop_fn( cur, ctx_ptr ) > target );
+            }
+        }
+
+        cur     = last;
+        above   = last_above;
+    }
+
+    return cur;
+}
+
+
 /* this function computes the growth effective age */
 void get_gea (
     double    psi, /* PSI  = PSI computed elsewhere                       */
@@ -1700,9 +2015,11 @@ void get_gea (
     double   *gea_output /* output growth effective age                 */
 )
 {
-    double x = 50.0f, last_age = 60.0f; /*Will store age to compute growth effective age */
-    double tmp_htop = 0.0f, last_htop = 0.0f; /*Will store height output from _flewsi*/ 
-    int place = -1; /*Store current decimal place*/
+    struct FLEWELLING_CURVE curve;
+    double  f_lo;
+    double  f_hi;
+    double  root = 0.0;
+    int     have_root = 0;
 
     /* If supplied height is less than stock height, give stock age as gea*/
     if ( htx < ht0 ) 
@@ -1711,28 +2028,24 @@ void get_gea (
         return;
     }
 
-    /*Compute growth effective age (from findgea SAS macro)*/
-    flewelling_site_index( psi, ht0, x, &tmp_htop );
+    /* the curve only depends on psi, build it once for all the ages */
+    build_flewelling_curve( psi, ht0, &curve );
 
-    /*Decrement by 10, then 1, then 0.1, then 0.01, etc*/
-    while ( place <= 3 ) 
+    /* find the age where the curve reaches htx, between 0 and 50 */
+    f_lo = eval_flewelling_curve( &curve, 0.0 ) - htx;
+    f_hi = eval_flewelling_curve( &curve, 50.0f ) - htx;
+    if( f_lo <= 0.0 && f_hi > 0.0 )
     {
-        /*Drop psi until htop drops below our observed height*/
-        while ( tmp_htop > htx ) 
-        {
-            last_age = x;
-            last_htop = tmp_htop;
-            INCDOWN(x, place);
-            flewelling_site_index( psi, ht0, x, &tmp_htop );
-        }
-
-        x = last_age;
-        tmp_htop = last_htop;
-        place += 1;
-
+        have_root = solve_flewelling_root( flewelling_htop_at_age, &curve, htx,
+                                           0.0, 50.0f, f_lo, f_hi,
+                                           FLEWELLING_ROOT_TOL * 1.0e-3, &root );
     }
 
-    *gea_output = x - 0.0005f;
+    /*Compute growth effective age (from findgea SAS macro)*/
+    /*Decrement by 10, then 1, then 0.1, then 0.01, etc*/
+    *gea_output = flewelling_digit_search( flewelling_htop_at_age, &curve, htx,
+                                           50.0f, -1, 3, 60.0f, 0.0f,
+                                           have_root, root ) - 0.0005f;
     return;
 }
 
@@ -1749,12 +2062,11 @@ void get_psi (
    double *psi_output   /* output estimate of psi                               */
 )
 {
-    /*Start with a real high value of psi (5)*/
-    double  cur_psi = 5.0f;
-    double  last_psi = 0.0f;
-    double  htop = 0.0;
-    double  last_htop = 0.0;
-    int     place = 0;
+    struct FLEWELLING_AGE   at;
+    double  f_lo;
+    double  f_hi;
+    double  root = 0.0;
+    int     have_root = 0;
 
     /*If supplied height is less than stock height, output really low psi
      *which should drop growth to near 0, indicating a problem */
@@ -1764,27 +2076,25 @@ void get_psi (
         return;
     }
 
-    /* compute the initial value for htop */ 
-    flewelling_site_index( cur_psi, ht0, x, &htop );
-    
-    /* solve htop to six decimal places             */
-    /* Decrement by 1, then 0.1, then 0.01, etc     */
-    while ( place <= 6 ) 
+    /* flewelling_htop_at_psi evaluates the curve at this age */
+    at.ht0  = ht0;
+    at.x    = x;
+
+    /* find the psi where the curve reaches htx, between 0 and 5 */
+    f_lo = flewelling_htop_at_psi( 0.0, &at ) - htx;
+    f_hi = flewelling_htop_at_psi( 5.0f, &at ) - htx;
+    if( f_lo <= 0.0 && f_hi > 0.0 )
     {
-        /*Drop psi until htop drops below our observed height*/
-        while ( htop > htx ) 
-        {
-            last_psi = cur_psi;
-            last_htop = htop;
-            INCDOWN(cur_psi, place);
-            flewelling_site_index(cur_psi, ht0, x, &htop);
-        }
-        
-        cur_psi = last_psi;
-        htop = last_htop;
-        place += 1;
+        have_root = solve_flewelling_root( flewelling_htop_at_psi, &at, htx,
+                                           0.0, 5.0f, f_lo, f_hi,
+                                           FLEWELLING_ROOT_TOL * 1.0e-3, &root );
     }
-    *psi_output = cur_psi - 0.0000005f;
+
+    /* solve htop to six decimal places             */
+    /* Decrement by 1, then 0.1, then 0.01, etc     */
+    *psi_output = flewelling_digit_search( flewelling_htop_at_psi, &at, htx,
+                                           5.0f, 0, 6, 0.0f, 0.0,
+                                           have_root, root ) - 0.0000005f;
     return;
 }
 
@@ -1817,23 +2127,30 @@ void flewelling_site_index(
       )
 {
 
+    struct FLEWELLING_CURVE curve;
+
+    build_flewelling_curve( psi, ht0, &curve );
+    *htop_output = eval_flewelling_curve( &curve, x );
+    return;
+}
+
+
+/* computes the curve parameters for psi, the parameters don't depend  */
+/* on the age, see flewelling_site_index                               */
+static void build_flewelling_curve(
+		double                  psi,    /* PSI	= PSI computed elsewhere        */
+		double                  ht0,    /* HT0  = avg ht of the planted stock   */
+		struct FLEWELLING_CURVE *curve_ptr )
+{
+
     /*Variable names taken from original Fortran code in DF_PSET.FOR */
     double fp[14] = { 0, 6464.0f, -1691.0f, -29.23f, 7.510f, 0.9075f,
                      0.1788f, -102.4f, 31.93f, 39.67f, 66.58f, -42.79f,
                      16.57f, 0.3505f };
-    double term, temp, z;
+    double term, temp;
     double b1, c, xk1, xk2, yk1, yk2, xstraight;
     double top, shape;
     double lambda1, ll, alpha, beta, lambda2;
-    double htop  = 0.0;
-
-    /*Check for early age, return simply stock height at planting*/
-    if ( x < 0.0 ) {
-        *htop_output = FLEWELLING_ET_AL_2002_STOCK_HT0;
-        return;
-    }
-
-    *htop_output = 0.0;
 
     /*Growth rate at origin (x=0, age=2) is b1 * PSI*/
     term = BOUND(fp[3] + fp[4] * psi, -8.0f, 8.0f);
@@ -1878,31 +2195,58 @@ void flewelling_site_index(
     beta = yk2 - top - alpha;
     lambda2 = exp( ( psi - alpha * ll ) / beta );
 
+    curve_ptr->psi      = psi;
+    curve_ptr->ht0      = ht0;
+    curve_ptr->b1       = b1;
+    curve_ptr->c        = c;
+    curve_ptr->xk1      = xk1;
+    curve_ptr->xk2      = xk2;
+    curve_ptr->yk1      = yk1;
+    curve_ptr->yk2      = yk2;
+    curve_ptr->alpha    = alpha;
+    curve_ptr->beta     = beta;
+    curve_ptr->lambda1  = lambda1;
+    curve_ptr->lambda2  = lambda2;
+
+}
+
+
+/* the top height at age x on a curve from build_flewelling_curve */
+static double eval_flewelling_curve(
+		struct FLEWELLING_CURVE *curve_ptr,
+		double                  x )     /* x = years since planting     */
+{
+
+    double z;
+    double htop  = 0.0;
+
+    /*Check for early age, return simply stock height at planting*/
+    if ( x < 0.0 ) {
+        return FLEWELLING_ET_AL_2002_STOCK_HT0;
+    }
+
     /*Coefficients are computed as in DF_PSET.FOR, now use these to get htop*/
-    if( x < xk1 )
+    if( x < curve_ptr->xk1 )
     {
-        htop = ht0 + psi * 
-            ( x + ( 1 - b1 ) * xk1 / ( c + 1 ) * 
-            ( pow( 1 - x / xk1 , ( c + 1 ) ) - 1 ) );
+        htop = curve_ptr->ht0 + curve_ptr->psi * 
+            ( x + ( 1 - curve_ptr->b1 ) * curve_ptr->xk1 / ( curve_ptr->c + 1 ) * 
+            ( pow( 1 - x / curve_ptr->xk1 , ( curve_ptr->c + 1 ) ) - 1 ) );
     }
 
-    if( xk1 <= x && x <= xk2 )
+    if( curve_ptr->xk1 <= x && x <= curve_ptr->xk2 )
     {
-        htop = yk1 + ( x - xk1 ) * psi;
+        htop = curve_ptr->yk1 + ( x - curve_ptr->xk1 ) * curve_ptr->psi;
     }
 
-    if( x > xk2 ) 
+    if( x > curve_ptr->xk2 ) 
     {
-    	z = x - xk2;
-    	htop = yk2 + 
-               alpha * ( ( pow( lambda1, z ) ) -1 ) + 
-               beta *  ( ( pow( lambda2, z ) ) -1 );
+    	z = x - curve_ptr->xk2;
+    	htop = curve_ptr->yk2 + 
+               curve_ptr->alpha * ( ( pow( curve_ptr->lambda1, z ) ) -1 ) + 
+               curve_ptr->beta *  ( ( pow( curve_ptr->lambda2, z ) ) -1 );
     }
 
-
-    /* assign the output variable */
-    *htop_output = htop;
-    return;
+    return htop;
 }
 
 
@@ -1962,6 +2306,73 @@ static void cips_calc_exp_from_cover_and_ca(
 
 
 
+/********************************************************************************/
+/* cips_project_plot                                                            */
+/********************************************************************************/
+/*  Description :   projects all the plants on the plot forward one year with   */
+/*                  the CONIFERS_CIPS equations                                 */
+/*  Returns     :   void                                                        */
+/*  Arguments   :   see VARIANT_RECORD project_plot in conifers.h               */
+/********************************************************************************/
+void cips_project_plot(
+   unsigned long           *return_code,
+   struct PLANT_RECORD     *plants_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   unsigned long           n_species,
+   struct SPECIES_RECORD   *species_ptr,
+   unsigned long           n_coeffs,
+   struct COEFFS_RECORD    *coeffs_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err,
+   struct SUMMARY_RECORD   *before_sums,
+   unsigned long           use_genetic_gains,
+   unsigned long           plantation_age,
+   unsigned long           yrst,
+   unsigned long           *n_years_projected )
+{
+
+   unsigned long           i;
+   struct PLANT_RECORD     *plant_ptr;
+
+   /* loop over the plant records on the current plot, using the  */
+   /* plot index built in calc_plot_stats_2, and project each      */
+   /* plant forward for one year                                   */
+   plant_ptr = &plants_ptr[plot_ptr->first_plant];
+   for( i = plot_ptr->first_plant; i < plot_ptr->last_plant; i++, plant_ptr++ )
+   {
+
+      cips_project_plant( return_code,
+                          n_species,
+                          species_ptr,
+                          n_coeffs,
+                          coeffs_ptr,
+                          plant_ptr,
+                          plot_ptr,
+                          endemic_mortality,
+                          hcb_growth_on,
+                          use_precip_in_hg,
+                          use_rand_err,
+                          before_sums,
+                          use_genetic_gains,
+                          0,
+                          plantation_age,
+                          yrst,
+                          n_years_projected );
+
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         *return_code = FAILED_PROJECT_PLANT;
+         return;
+      }
+
+      update_grown_plant( plant_ptr );
+   }
+
+}
+
+
 /********************************************************************************/
 /* cips_impute                                                                   */
 /********************************************************************************/
@@ -2726,7 +3137,7 @@ void write_cips_test_file(
                 {
                     if( strcmp( "", INT_SPARE_LABEL[k] ) != 0 )
                     {
-                        fprintf( fp, "%ld,", plant_ptr->INT_SPARE[k] );
+                        fprintf( fp, "%ld,", plant_ptr->diag != NULL ? plant_ptr->diag->INT_SPARE[k] : 0L );
                     }
 
                 }
@@ -2737,7 +3148,7 @@ void write_cips_test_file(
                 {
                     if( strcmp( "", DBL_SPARE_LABEL[k] ) != 0 )
                     {
-                        fprintf( fp, "%.10lf,", plant_ptr->DBL_SPARE[k] );
+                        fprintf( fp, "%.10lf,", plant_ptr->diag != NULL ? plant_ptr->diag->DBL_SPARE[k] : 0.0 );
                     }
                 }
 
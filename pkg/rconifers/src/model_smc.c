@@ -177,6 +177,25 @@ void smc_calc_dbh_from_height_and_d6(
     double          *coeffs_ptr );
 
 
+/* S1 for the imputation, the crown area of the shrubs is capped at 50.1 */
+/* square feet (an 8 foot crown width), see smc_calc_crown_width          */
+static void smc_calc_crown_width_batch( struct IMPUTE_BATCH *batch_ptr )
+{
+   calc_crown_width_batch_to_max( batch_ptr,
+                                  batch_ptr->c_ptr->type == SHRUB ? 50.1 : 2827.0 );
+}
+
+/* the imputation equations, see impute_in_batches */
+static const struct IMPUTE_KERNELS smc_impute_kernels = {
+      calc_d6_from_total_height_batch,
+      calc_d6_from_ht_and_dbh_batch,
+      calc_dbh_from_height_and_d6_batch,
+      smc_calc_crown_width_batch,
+      calc_exp_from_cover_and_ca_batch,
+      calc_crown_ratio_batch,
+      calc_max_crown_width_batch };
+
+
 /********************************************************************************/
 /* smc_impute                                                                   */
 /********************************************************************************/
@@ -189,7 +208,8 @@ void smc_calc_dbh_from_height_and_d6(
 /*  Author      :   Jeff D. Hamann                                              */
 /*  Date        :   September 12, 1999                                          */
 /*  Returns     :   void                                                        */
-/*  Comments    :   NONE                                                        */
+/*  Comments    :   the equations are run over batches of plants, see           */
+/*                  impute_in_batches (impute.c)                                */
 /*  Arguments   :   unsigned long *return_code  - pointer to a return code      */
 /*                  unsigned long n_plants      - total number fo plants in the */
 /*                      plants pointer array                                    */
@@ -222,373 +242,105 @@ void smc_impute(
 			    double                  baf )
 {
 
-  unsigned long   i;
-  struct  PLANT_RECORD    *plant_ptr = NULL;
-  struct  PLOT_RECORD     *plot_ptr = NULL;
-  struct  COEFFS_RECORD   *c_ptr = NULL;
-  unsigned long   error_count = 0;
-
-  double  bait[PLANT_TYPES];
-  double  cait[PLANT_TYPES];
-
-  //double        cait_c;   // unused removed jan 2014 mwr;
-  //double        cait_h;   // unused removed jan 2014 mwr;
-  //double        cait_s;   // unused removed jan 2014 mwr;
-
-  error_count  = 0;
-  *return_code = CONIFERS_SUCCESS;
-
-  /* first check to make sure there are plants in the array */
-  if( n_plants <= 0 || plants_ptr == NULL ) 
-    {
-      *return_code = INVALID_PLANT_COUNT;
-      return;
-    }
-
-  /* first check to make sure there are plants in the array */
-  if( n_points <= 0 || plots_ptr == NULL ) 
-    {
-      *return_code = INVALID_PLOT_COUNT;
-      return;
-    }
-
-  /* FIRST PASS */
-  /* make a first pass to calculate the basic data for the plants */
-  /* fill in missing dbh, d6, and total heights */
-  plant_ptr = &plants_ptr[0];
-  for( i = 0; i < n_plants; i++, plant_ptr++ )
-    {
-
-      plant_ptr->errors = E_OKDOKEY; /* default value for error is set=ok */ 
+  impute_in_batches( return_code,
+		     n_species,
+		     species_ptr,
+		     n_coeffs,
+		     coeffs_ptr,
+		     n_plants,
+		     plants_ptr,
+		     n_points,
+		     plots_ptr,
+		     fixed_plot_radius,
+		     min_dbh,
+		     baf,
+		     &smc_impute_kernels );
 
-      c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
-
-      /* don't go any further if you don't have a functional species code */
-      if( c_ptr == NULL )
-	{
-	  plant_ptr->errors |= E_INVALID_SPECIES;
-	  error_count += 1;
-	  continue;
-	}
-
-      /* only fill in missing values for stocked plots */
-      if( is_non_stocked( c_ptr ) )
-	{
-	  continue;
-	}
-
-      /* if the stem is all below d6  */
-      if( plant_ptr->tht < 0.50 && !is_non_stocked( c_ptr ) )
-	{        
-	  plant_ptr->errors |= E_INVALID_HEIGHT;
-	  error_count += 1;
-	}
-
-      /* if the total height <= 4.5 and there's a dbh obs */
-      /* this error triggers on plants that are exactly 4.5 feet tall */
-	/* and have a positive dbh observation                          */
-	if( plant_ptr->tht < 4.5 && plant_ptr->dbh > 0.0 )
-	  {
-	    plant_ptr->errors |= E_INVALID_DBH;
-	    error_count += 1;
-	  }
-
-	/* if it's a tree with a dbh obs */
-	if(!is_tree( c_ptr) && plant_ptr->dbh > 0.0)
-	  {
-	    plant_ptr->errors |= E_INVALID_DBH;
-	    error_count += 1;
-	  }
-
-
-	/* if the plant doesn't have a dbh, fill that in    */ 
-	/* if the stem is between 6" and 4.5 feet tall      */
-	if( plant_ptr->tht >= 0.50 )
-	  {
-	    if( is_tree( c_ptr ) )
-	      {
-		if( plant_ptr->d6 == 0.0 )
-		  {
-		    if(plant_ptr->dbh > 0.0 && plant_ptr->tht >4.5)
-		      {
-			*return_code = CONIFERS_SUCCESS;
-			
-			      smc_calc_d6_from_ht_and_dbh(return_code,
-							  plant_ptr->tht,
-							  plant_ptr->dbh,
-							  &plant_ptr->d6,
-							  c_ptr->d6_ht_dbh);
-
-                  if( *return_code != CONIFERS_SUCCESS)
-			      {
-				    plant_ptr->errors |= E_INVALID_D6;
-				    error_count += 1;
-			      }
-		      }
-		    else
-		      {
-		          /* if the dbh != 0 and tht < 4.5? */
-			    *return_code = CONIFERS_SUCCESS;
-
-			  
-			      smc_calc_d6_from_total_height(  return_code, 
-							      plant_ptr->tht, 
-							      &plant_ptr->d6, 
-							      c_ptr->d6_ht);
-			    
-			    if( *return_code != CONIFERS_SUCCESS)
-			      {
-				plant_ptr->errors |= E_INVALID_D6;
-				error_count += 1;
-			      }
-		      }
-		  }
-
-
-            /* you need to impute a d12 from height and veg cover (or anything) here */
-
-        /* this is the code for computing the missing dbh when the tree */
-          /* is taller than 4.5 feet                                        */
-          /* if the plant record has a missing d12 and the total height is > 30 CM */
-          /* this only applies to the CONIFERS_CIPS variant */
-		if( plant_ptr->d12 == 0.0 && plant_ptr->tht > ( 30.0 * CM2FT ) )
-		{
-		    *return_code = CONIFERS_SUCCESS;
-            /* this function might need plot level stats too. */            
-            //plot_ptr = get_plot( plant_ptr->plot, n_points, plots_ptr );
-            //cips_calc_d12_from_ht_and_veg_cov(  return_code,
-			//            plant_ptr->tht,
-			//            plot_ptr->shrub_pct_cover,
-			//            &plant_ptr->d12,
-			//            c_ptr->dbh_ht_veg_cov );
-        }
-
-          /* this is the code for computing the missing dbh when the tree */
-          /* is taller than 4.5 feet                                        */
-		if( plant_ptr->d6 > 0.0 && plant_ptr->dbh == 0.0 && plant_ptr->tht > 4.5)
-		  {
-		    *return_code = CONIFERS_SUCCESS;
-		    
-			  /* there was never a function developed for the SMC variant */
-			  smc_calc_dbh_from_height_and_d6(return_code,
-						      plant_ptr->d6,
-						      plant_ptr->tht,
-						      &plant_ptr->dbh,
-						      c_ptr->d6_ht_dbh);
-			
-			if( *return_code != CONIFERS_SUCCESS)
-			  {
-			    plant_ptr->errors |= E_INVALID_DBH;
-			    error_count += 1;
-			  }
-        }
-
-		if(plant_ptr->expf <=0.0 && fixed_plot_radius > 0.0  )
-		  {
-		    if( plant_ptr->errors & E_INVALID_DBH)
-		      {
-			plant_ptr->expf = 0;
-			plant_ptr->errors |= E_INVALID_EXPF;
-			error_count += 1;
-		      }
-		    else if( plant_ptr->dbh > min_dbh )
-		      {
-			plant_ptr->expf = baf / (plant_ptr->dbh * plant_ptr->dbh * FC_I);
-		      }
-		    else
-		      {
-			plant_ptr->expf = SQ_FT_PER_ACRE / 
-			  ( fixed_plot_radius * fixed_plot_radius * MY_PI );
-		      }            
-
-		    /* multiply the expansion factor by the number of   */
-		    /* stems that this plant record represents          */
-		    plant_ptr->expf *= plant_ptr->n_stems;
-		  }
-	      }
-
-            /* if the plant is a shrub, then compute the d6 if it's missing */
-	      if( is_shrub( c_ptr ) )
-		{
-		  if( plant_ptr->d6 == 0.0 )
-		    {
-		      /* compute the d6 from the height */
-		      *return_code = CONIFERS_SUCCESS;
-		      
-			
-			    smc_calc_d6_from_total_height(  return_code, 
-							    plant_ptr->tht, 
-							    &plant_ptr->d6, 
-							    c_ptr->d6_ht);
-
-                if( *return_code != CONIFERS_SUCCESS)
-			    {
-			      plant_ptr->errors |= E_INVALID_D6;
-			      error_count += 1; 
-			    }
-		    }
-
-		}
-
-	  }
-
-	/* fill in the remaining values */
-	plant_ptr->d6_area      = plant_ptr->d6 * plant_ptr->d6 * FC_I;
-	plant_ptr->basal_area   = plant_ptr->dbh * plant_ptr->dbh * FC_I;
-    plant_ptr->d12_area      = plant_ptr->d12 * plant_ptr->d12 * FC_I;
-	    
-
-	    /* now calculate the crown width for the plant record */
-	    if( plant_ptr->crown_width <= 0.0 )
-	      {
-		*return_code = CONIFERS_SUCCESS;
-		
-		  		      /* not developed for the variant, imported from swo model */
-		      smc_calc_crown_width(   return_code,
-					  plant_ptr->d6_area,
-					  plant_ptr->tht,
-					  &plant_ptr->crown_width,
-					  &plant_ptr->crown_area,
-					  c_ptr->crown_width,
-                      c_ptr->type );
-
-		    if( *return_code != CONIFERS_SUCCESS)
-		      {
-			plant_ptr->errors |= E_INVALID_CW;
-			error_count += 1;
-		      }
-	      }
-
-	    /*  MOD033  */
-	    /* this should happen no matter what... */
-	    plant_ptr->crown_area = plant_ptr->crown_width * plant_ptr->crown_width * MY_PI / 4.0;
-
-	    /* fill in the expansion factors for those plant records    */
-	    /* that don't have one filled in by using the sample        */
-	    /* design records. Mostly, shrubs will have the expf filled */
-	    /* by calling this function, but it should work for trees   */
-	    if( plant_ptr->expf <= 0.0 )
-	      {
-		
-		    /* not developed for the variant */
-		    smc_calc_exp_from_cover_and_ca( return_code,
-						plant_ptr->pct_cover,
-						plant_ptr->crown_area,
-						&plant_ptr->expf );
-
-		  if( *return_code != CONIFERS_SUCCESS)
-		    {
-		      plant_ptr->errors |= E_INVALID_EXPF;
-		      error_count += 1;
-		    }
-
-	      }
-    
-    }
-
-  calc_plot_stats_2(    return_code, 
-			n_species,
-			species_ptr,
-			n_coeffs,
-			coeffs_ptr,
-			n_plants,
-			plants_ptr,
-			n_points,
-			plots_ptr );
-
-    /* todo: need_error_trap_here */
-
-    /* SECOND PASS */
-    /* The second pass is required becuase the crown values are */
-    /* dependent on the basic plot summary statistics which are */
-    /* calculated for the plot before hand                      */
-    /* now make the second pass to impute tree values that      */
-    /* require plot level statistics.                           */
-
-    //error_count  = 0;
-    plant_ptr = &plants_ptr[0];
-    for( i = 0; i < n_plants; i++, plant_ptr++ )
-      {
-
-	c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
-
-
-	/* don't go any further if you don't have a functional species code */
-	if( c_ptr == NULL )
-	  {
-	    continue;
-	  }
-
-	/* set the pointer for the current plot that the plant is on */
-	plot_ptr = get_plot( plant_ptr->plot, n_points, plots_ptr );
-        
-	/* fill in the percent cover for the plant recor */
-	if( plant_ptr->pct_cover == 0.0)  /* fill in percent cover */
-	  {
-	    plant_ptr->pct_cover = 100.0 * plant_ptr->expf * plant_ptr->crown_area / SQ_FT_PER_ACRE;
-	  }
-
-	/* if the crown ratio is invalid or missing     */
-	/* fill in the crown ratio for the plant record */
-	if( is_tree( c_ptr ) )
-	  {
-	    if( plant_ptr->cr <= 0.0 || plant_ptr->cr > 1.0 )
-	      {
-
-            /* maybe replace these select-case statements with function calls? */
-
-		get_in_taller_attribs( plant_ptr, plot_ptr, bait, cait );
-            
-
-		//cait_c       =   cait[CONIFER];   //unused removed jan 2014 mwr;
-		//cait_h       =   cait[HARDWOOD];  //unused removed jan 2014 mwr;
-		//cait_s       =   cait[SHRUB];     //unused removed jan 2014 mwr;
-		*return_code = CONIFERS_SUCCESS;
-
-		      smc_calc_crown_ratio(return_code,  
-					   plant_ptr->tht,
-					   plant_ptr->d6,
-					   &plant_ptr->cr,
-					   c_ptr->crown_ratio);
+}
 
-	      }  /* end of bad or missing crown ratio */                            
-    } /* end of is_tree check */
 
-	if( *return_code != CONIFERS_SUCCESS)
-	  {
-	    plant_ptr->errors |= E_INVALID_CR;
-	    error_count += 1;
-	  }
+/********************************************************************************/
+/* smc_project_plot                                                             */
+/********************************************************************************/
+/*  Description :   projects all the plants on the plot forward one year with   */
+/*                  the CONIFERS_SMC equations                                  */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the genetic gains age cut comes from the stand's height_40  */
+/*                  and the plot's site_30                                      */
+/*  Arguments   :   see VARIANT_RECORD project_plot in conifers.h               */
+/********************************************************************************/
+void smc_project_plot(
+   unsigned long           *return_code,
+   struct PLANT_RECORD     *plants_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   unsigned long           n_species,
+   struct SPECIES_RECORD   *species_ptr,
+   unsigned long           n_coeffs,
+   struct COEFFS_RECORD    *coeffs_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err,
+   struct SUMMARY_RECORD   *before_sums,
+   unsigned long           use_genetic_gains,
+   unsigned long           plantation_age,
+   unsigned long           yrst,
+   unsigned long           *n_years_projected )
+{
 
-	plant_ptr->max_crown_width = 0.0;
+   unsigned long           i;
+   struct PLANT_RECORD     *plant_ptr;
+   unsigned long           genetics_age_cut;
+   struct RANDOM_STREAM    rand_stream;
+
+   genetics_age_cut = 0;
+   get_age_cut( return_code,
+                before_sums->height_40,
+                plot_ptr->site_30,
+                &genetics_age_cut );
+
+   /* loop over the plant records on the current plot, using the  */
+   /* plot index built in calc_plot_stats_2, and project each      */
+   /* plant forward for one year                                   */
+   plant_ptr = &plants_ptr[plot_ptr->first_plant];
+   for( i = plot_ptr->first_plant; i < plot_ptr->last_plant; i++, plant_ptr++ )
+   {
 
-	/*  MOD014 */
-	  /* if it's a tree, compute the crown width */
-	  if( is_tree( c_ptr ) )
-	    {
-	      *return_code = CONIFERS_SUCCESS;
-	      
-		    /* not developed for the model */
-		    smc_calc_max_crown_width(  return_code,
-					   plant_ptr->dbh,
-					   plant_ptr->tht,
-					   &plant_ptr->max_crown_width,
-					   c_ptr->max_crown_width);
-
-            if( *return_code != CONIFERS_SUCCESS)
-		    {
-		      plant_ptr->errors |= E_INVALID_MCW;   
-		      error_count += 1;
-		    }
-	    }
-      }
-   
-    if (error_count > 0)
+      /* the random deviates for the plant only depend on the    */
+      /* seed, the run, the plot, the plant and the stand age,   */
+      /* so they don't change with the plant order or number of  */
+      /* threads                                                 */
+      init_random_stream( &rand_stream, 
+                          get_random_seed(), 
+                          get_random_run(), 
+                          plot_ptr->plot, 
+                          plant_ptr->plant, 
+                          plantation_age );
+
+      smc_project_plant( return_code,
+                         n_species,
+                         species_ptr,
+                         n_coeffs,
+                         coeffs_ptr,
+                         plant_ptr,
+                         plot_ptr,
+                         endemic_mortality,
+                         hcb_growth_on,
+                         use_precip_in_hg,
+                         use_rand_err,
+                         before_sums,
+                         use_genetic_gains,
+                         genetics_age_cut,
+                         &rand_stream );
+
+      if( *return_code != CONIFERS_SUCCESS )
       {
-	*return_code = FILL_VALUES_ERROR;
-	return;
+         *return_code = FAILED_PROJECT_PLANT;
+         return;
       }
-    *return_code = CONIFERS_SUCCESS;
+
+      update_grown_plant( plant_ptr );
+   }
 
 }
 
@@ -616,6 +368,8 @@ void smc_impute(
 /*                  struct COEFFS_RECORD *coeffs_ptr - array of coefficients    */
 /*                      that are used to project the individual plants on the   */
 /*                      plot.                                                   */
+/*                  struct RANDOM_STREAM *rand_stream - the random deviates for */
+/*                      the plant in the current year (see sample.c)            */
 /********************************************************************************/
 void smc_project_plant(  
    unsigned long           *return_code,
@@ -631,7 +385,8 @@ void smc_project_plant(
    unsigned long           use_rand_err,
    struct SUMMARY_RECORD   *before_sums,
    unsigned long           use_genetic_gains,
-   unsigned long           genetics_age_cut)
+   unsigned long           genetics_age_cut,
+   struct RANDOM_STREAM    *rand_stream )
 {
 
    struct COEFFS_RECORD    *c_ptr;
@@ -646,8 +401,6 @@ void smc_project_plant(
    //double  new_d6_area;  //unused removed jan 2014 mwr;
    //double  new_d12_area; //unused removed jan 2014 mwr;
 
-   unsigned long htidx = 0;
-
    double  normal;
    double  browse_random_unif_0_1;
    double  top_dam_random_unif_0_1;
@@ -659,6 +412,8 @@ void smc_project_plant(
 
    double  bait[PLANT_TYPES];
    double  cait[PLANT_TYPES];
+   double  bait_0[PLANT_TYPES];
+   double  cait_0[PLANT_TYPES];
 
     
    /* get the supporting structures for the plant */
@@ -674,9 +429,9 @@ void smc_project_plant(
 
    /* get a uniform deviate for the browse */
    /* and one for the top damage           */
-   normal                  = (double)gauss_dev();
-   browse_random_unif_0_1  = uniform_0_1();
-   top_dam_random_unif_0_1 = uniform_0_1();
+   normal                  = stream_gauss_dev( rand_stream );
+   browse_random_unif_0_1  = stream_uniform_0_1( rand_stream );
+   top_dam_random_unif_0_1 = stream_uniform_0_1( rand_stream );
 
 
    tpa_con_stand  = before_sums->con_tpa;
@@ -702,6 +457,11 @@ void smc_project_plant(
    //cat_c       =   plot_ptr->cait[CONIFER][htidx];
    cat_c       =   cait[CONIFER];
 
+   /* the height growth uses the crown area in the plants taller  */
+   /* than 0.5 feet, which was the first bin (htidx = 0) of the    */
+   /* plot's in taller arrays                                      */
+   get_in_taller_attribs_for_height( 0.5, plot_ptr, bait_0, cait_0 );
+
 
    //bat_c_h     =   bat_c + bat_h;           // unused removed jan 2014 mwr;
    //bat_total   =   bat_c + bat_h + bat_s;   // unused removed jan 2014 mwr;
@@ -733,9 +493,9 @@ void smc_project_plant(
 	                            tpa_con_stand,
 	                            h40,
 	                            plot_ptr->ca_s,
-		                        plot_ptr->cait[CONIFER][htidx],
-                                plot_ptr->cait[HARDWOOD][htidx],
-                                plot_ptr->cait[SHRUB][htidx],
+		                        cait_0[CONIFER],
+                                cait_0[HARDWOOD],
+                                cait_0[SHRUB],
 	                            normal,                   
 	                            browse_random_unif_0_1,   
 	                            top_dam_random_unif_0_1,  
@@ -822,7 +582,7 @@ void smc_project_plant(
 			                plot_ptr->ca_c,
 			                plot_ptr->ca_h,
 			                plot_ptr->ca_s,
-			                uniform_0_1(),
+			                stream_uniform_0_1( rand_stream ),
 			                &plant_ptr->cr_growth,
 			                c_ptr->cr_growth);
 
@@ -901,7 +661,7 @@ void smc_project_plant(
 			                plot_ptr->ca_h,
 			                plot_ptr->ca_s,
 			                cat_c,
-			                uniform_0_1(),
+			                stream_uniform_0_1( rand_stream ),
 			                plant_ptr->expf,
 			                basal_area,
 			                plot_ptr->site_30,
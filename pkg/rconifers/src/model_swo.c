@@ -56,14 +56,14 @@
 
 
 /* diameter calculations    */
-/* S1 crown width equations */
-static void swo_calc_crown_width( 
-      unsigned long   *return_code,
-      double          d6_area,
-      double          total_height,
-      double          *pred_crown_width,
-      double          *pred_crown_area,
-      double          *coeffs_ptr);
+/* S1 crown width equations, the imputation uses calc_crown_width_batch */
+//static void swo_calc_crown_width( 
+//      unsigned long   *return_code,
+//      double          d6_area,
+//      double          total_height,
+//      double          *pred_crown_width,
+//      double          *pred_crown_area,
+//      double          *coeffs_ptr);
 
 /* S2 coefficients: MW */
 static   void calc_max_crown_width( 
@@ -73,28 +73,29 @@ static   void calc_max_crown_width(
       double          *pred_max_crown_width,
       double          *coeffs_ptr);
 
-/* S3 crown ratio calculations */
-static   void swo_calc_crown_ratio( 
-      unsigned long   *return_code, 
-      double          total_height,
-      double          d6,
-      double          *pred_cr,
-      double          *coeffs_ptr );
+/* S3 crown ratio calculations, the imputation uses calc_crown_ratio_batch */
+//static   void swo_calc_crown_ratio( 
+//      unsigned long   *return_code, 
+//      double          total_height,
+//      double          d6,
+//      double          *pred_cr,
+//      double          *coeffs_ptr );
 
 
 /* S4, coefficients: MS     */
-static   void calc_d6_from_total_height(       
-      unsigned long   *return_code,
-      double          total_height, 
-      double          *pred_d6,
-      double          *coeffs_ptr );
+/* S4, S5, S7 and S8 are run in batches by the imputation, see impute.c */
+//static   void calc_d6_from_total_height(       
+//      unsigned long   *return_code,
+//      double          total_height, 
+//      double          *pred_d6,
+//      double          *coeffs_ptr );
 
-static   void calc_d6_from_ht_and_dbh(       
-      unsigned long   *return_code,
-      double          total_height,
-      double          dbh,
-      double          *pred_d6,
-      double          *coeffs_ptr );
+//static   void calc_d6_from_ht_and_dbh(       
+//      unsigned long   *return_code,
+//      double          total_height,
+//      double          dbh,
+//      double          *pred_d6,
+//      double          *coeffs_ptr );
 
 //static   void calc_dbh_from_height(       
 //      unsigned long   *return_code,
@@ -102,18 +103,18 @@ static   void calc_d6_from_ht_and_dbh(
 //      double          *pred_dbh,
 //      double          *coeffs_ptr );
 
- static  void calc_dbh_from_height_and_d6(       
-      unsigned long   *return_code,
-      double          d6,
-      double          total_height,
-      double          *pred_dbh,
-      double          *coeffs_ptr );
+// static  void calc_dbh_from_height_and_d6(       
+//      unsigned long   *return_code,
+//      double          d6,
+//      double          total_height,
+//      double          *pred_dbh,
+//      double          *coeffs_ptr );
 
- static  void calc_exp_from_cover_and_ca(
-      unsigned long   *return_code,
-      double          pct_cover,
-      double          crown_area,
-      double          *pred_expf);
+// static  void calc_exp_from_cover_and_ca(
+//      unsigned long   *return_code,
+//      double          pct_cover,
+//      double          crown_area,
+//      double          *pred_expf);
 
 /* these functions are not referenced in this model??? */
 
@@ -221,12 +222,49 @@ static   void calc_cw_growth(
       double            *coeffs_ptr,
       unsigned long     plant_type);
 
+/* batched versions of the growth equations, see swo_project_plant_batch */
+static void calc_height_growth_batch(
+      unsigned long       *return_code,
+      struct GROWTH_BATCH *batch_ptr,
+      double              h20_holding_capacity,
+      double              cahw,
+      double              cash,
+      long                ind_random,
+      double              *coeffs_ptr,
+      unsigned long       plant_type );
+
+static void calc_d6_growth_batch(
+      unsigned long       *return_code,
+      struct GROWTH_BATCH *batch_ptr,
+      double              h20_holding_capacity,
+      double              *coeffs_ptr,
+      unsigned long       plant_type );
+
+static void calc_cw_growth_batch(
+      unsigned long       *return_code,
+      struct GROWTH_BATCH *batch_ptr,
+      double              ca_conifers,
+      double              ca_hardwoods,
+      double              ca_shrubs,
+      double              *coeffs_ptr,
+      unsigned long       plant_type );
+
 static void swo_calc_endemic_mortality(   
       unsigned long   *return_code,
       double          expansion_factor,
       double          *pred_mortality,
       double          *coeffs_ptr );
 
+/* the imputation equations, see impute_in_batches */
+static const struct IMPUTE_KERNELS swo_impute_kernels = {
+      calc_d6_from_total_height_batch,
+      calc_d6_from_ht_and_dbh_batch,
+      calc_dbh_from_height_and_d6_batch,
+      calc_crown_width_batch,
+      calc_exp_from_cover_and_ca_batch,
+      calc_crown_ratio_batch,
+      calc_max_crown_width_batch };
+
 
 
 /********************************************************************************/
@@ -241,7 +279,8 @@ static void swo_calc_endemic_mortality(
 /*  Author      :   Jeff D. Hamann                                              */
 /*  Date        :   September 12, 1999                                          */
 /*  Returns     :   void                                                        */
-/*  Comments    :   NONE                                                        */
+/*  Comments    :   the equations are run over batches of plants, see           */
+/*                  impute_in_batches (impute.c)                                */
 /*  Arguments   :   unsigned long *return_code  - pointer to a return code      */
 /*                  unsigned long n_plants      - total number fo plants in the */
 /*                      plants pointer array                                    */
@@ -274,362 +313,19 @@ void swo_impute(
 	double                  baf )
 {
 
-  unsigned long   i;
-  struct  PLANT_RECORD    *plant_ptr = NULL;
-  struct  PLOT_RECORD     *plot_ptr = NULL;
-  struct  COEFFS_RECORD   *c_ptr = NULL;
-  unsigned long   error_count = 0;
-
-  double  bait[PLANT_TYPES];
-  double  cait[PLANT_TYPES];
-
-  //double        cait_c;  //unused removed jan 2014 mwr;
-  //double        cait_h;  //unused removed jan 2014 mwr;
-  //double        cait_s;  //unused removed jan 2014 mwr;
-
-  error_count  = 0;
-  *return_code = CONIFERS_SUCCESS;
-
-  /* first check to make sure there are plants in the array */
-  if( n_plants <= 0 || plants_ptr == NULL ) 
-    {
-      *return_code = INVALID_PLANT_COUNT;
-      return;
-    }
-
-  /* first check to make sure there are plants in the array */
-  if( n_points <= 0 || plots_ptr == NULL ) 
-    {
-      *return_code = INVALID_PLOT_COUNT;
-      return;
-    }
-
-  /* FIRST PASS */
-  /* make a first pass to calculate the basic data for the plants */
-  /* fill in missing dbh, d6, and total heights */
-  plant_ptr = &plants_ptr[0];
-  for( i = 0; i < n_plants; i++, plant_ptr++ )
-    {
-
-      plant_ptr->errors = E_OKDOKEY; /* default value for error is set=ok */ 
-
-      c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
-
-      /* don't go any further if you don't have a functional species code */
-      if( c_ptr == NULL )
-	{
-	  plant_ptr->errors |= E_INVALID_SPECIES;
-	  error_count += 1;
-	  continue;
-	}
-
-      /* only fill in missing values for stocked plots */
-      if( is_non_stocked( c_ptr ) )
-	{
-	  continue;
-	}
-
-      /* if the stem is all below d6  */
-      if( plant_ptr->tht < 0.50 && !is_non_stocked( c_ptr ) )
-	{        
-	  plant_ptr->errors |= E_INVALID_HEIGHT;
-	  error_count += 1;
-	}
-
-      /* if the total height <= 4.5 and there's a dbh obs */
-      /* this error triggers on plants that are exactly 4.5 feet tall */
-	/* and have a positive dbh observation                          */
-	if( plant_ptr->tht < 4.5 && plant_ptr->dbh > 0.0 )
-	  {
-	    plant_ptr->errors |= E_INVALID_DBH;
-	    error_count += 1;
-	  }
-
-	/* if it's a tree with a dbh obs */
-	if(!is_tree( c_ptr) && plant_ptr->dbh > 0.0)
-	  {
-	    plant_ptr->errors |= E_INVALID_DBH;
-	    error_count += 1;
-	  }
-
-
-	/* if the plant doesn't have a dbh, fill that in    */ 
-	/* if the stem is between 6" and 4.5 feet tall      */
-	if( plant_ptr->tht >= 0.50 )
-	  {
-	    if( is_tree( c_ptr ) )
-	      {
-		if( plant_ptr->d6 == 0.0 )
-		  {
-		    if(plant_ptr->dbh > 0.0 && plant_ptr->tht >4.5)
-		      {
-			*return_code = CONIFERS_SUCCESS;
-			
-			      calc_d6_from_ht_and_dbh(return_code,
-						      plant_ptr->tht,
-						      plant_ptr->dbh,
-						      &plant_ptr->d6,
-                              c_ptr->d6_ht_dbh);
-
-			    if( *return_code != CONIFERS_SUCCESS)
-			      {
-				    plant_ptr->errors |= E_INVALID_D6;
-				    error_count += 1;
-			      }
-		      }
-		    else
-		      {
-		          /* if the dbh != 0 and tht < 4.5? */
-			    *return_code = CONIFERS_SUCCESS;
-
-			  
-			      calc_d6_from_total_height(  return_code, 
-							  plant_ptr->tht, 
-							  &plant_ptr->d6, 
-							  c_ptr->d6_ht);
-
-                  if( *return_code != CONIFERS_SUCCESS)
-			      {
-				    plant_ptr->errors |= E_INVALID_D6;
-				    error_count += 1;
-			      }
-		      }
-		  }
-
-
-          /* this is the code for computing the missing dbh when the tree */
-          /* is taller than 4.5 feet                                        */
-          /* if the plant record has a missing d12 and the total height is > 30 CM */
-          /* this only applies to the CONIFERS_CIPS variant */
-		//if( plant_ptr->d12 == 0.0 && plant_ptr->tht > ( 30.0 * CM2FT ) )
-		//{
-        //            plot_ptr = get_plot( plant_ptr->plot, n_points, plots_ptr );
-        //            cips_calc_d12_from_ht_and_veg_cov(  return_code,
-		//	                    plant_ptr->tht,
-		//	                    plot_ptr->shrub_pct_cover,
-		//	                    &plant_ptr->d12,
-		//	                    c_ptr->dbh_ht_veg_cov );
-        //}
-
-          /* this is the code for computing the missing dbh when the tree */
-          /* is taller than 4.5 feet                                        */
-		if( plant_ptr->d6 > 0.0 && plant_ptr->dbh == 0.0 && plant_ptr->tht > 4.5)
-		  {
-		    *return_code = CONIFERS_SUCCESS;
-		    
-			  calc_dbh_from_height_and_d6(return_code,
-						      plant_ptr->d6,
-						      plant_ptr->tht,
-						      &plant_ptr->dbh,
-						      c_ptr->d6_ht_dbh);
-
-              if( *return_code != CONIFERS_SUCCESS)
-			  {
-			    plant_ptr->errors |= E_INVALID_DBH;
-			    error_count += 1;
-			  }
-        }
-
-		if(plant_ptr->expf <=0.0 && fixed_plot_radius > 0.0  )
-		  {
-		    if( plant_ptr->errors & E_INVALID_DBH)
-		      {
-			plant_ptr->expf = 0;
-			plant_ptr->errors |= E_INVALID_EXPF;
-			error_count += 1;
-		      }
-		    else if( plant_ptr->dbh > min_dbh )
-		      {
-			plant_ptr->expf = baf / (plant_ptr->dbh * plant_ptr->dbh * FC_I);
-		      }
-		    else
-		      {
-			plant_ptr->expf = SQ_FT_PER_ACRE / 
-			  ( fixed_plot_radius * fixed_plot_radius * MY_PI );
-		      }            
-
-		    /* multiply the expansion factor by the number of   */
-		    /* stems that this plant record represents          */
-		    plant_ptr->expf *= plant_ptr->n_stems;
-		  }
-	      }
-
-            /* if the plant is a shrub, then compute the d6 if it's missing */
-	      if( is_shrub( c_ptr ) )
-		{
-		  if( plant_ptr->d6 == 0.0 )
-		    {
-		      /* compute the d6 from the height */
-		      *return_code = CONIFERS_SUCCESS;
-		      
-			
-			    calc_d6_from_total_height(  return_code, 
-							plant_ptr->tht, 
-							&plant_ptr->d6, 
-							c_ptr->d6_ht);
-			  
-			  if( *return_code != CONIFERS_SUCCESS)
-			    {
-			      plant_ptr->errors |= E_INVALID_D6;
-			      error_count += 1; 
-			    }
-		    }
-
-		}
-
-	  }
-
-	/* fill in the remaining values */
-	plant_ptr->d6_area      = plant_ptr->d6 * plant_ptr->d6 * FC_I;
-	plant_ptr->basal_area   = plant_ptr->dbh * plant_ptr->dbh * FC_I;
-    plant_ptr->d12_area      = plant_ptr->d12 * plant_ptr->d12 * FC_I;
-	    
-
-	    /* now calculate the crown width for the plant record */
-	    if( plant_ptr->crown_width <= 0.0 )
-	      {
-		*return_code = CONIFERS_SUCCESS;
-		
-		  
-		      /* original variant */
-		      swo_calc_crown_width(   return_code,
-					  plant_ptr->d6_area,
-					  plant_ptr->tht,
-					  &plant_ptr->crown_width,
-					  &plant_ptr->crown_area,
-					  c_ptr->crown_width );
-		    
-		    if( *return_code != CONIFERS_SUCCESS)
-		      {
-			plant_ptr->errors |= E_INVALID_CW;
-			error_count += 1;
-		      }
-	      }
-
-	    /*  MOD033  */
-	    /* this should happen no matter what... */
-	    plant_ptr->crown_area = plant_ptr->crown_width * plant_ptr->crown_width * MY_PI / 4.0;
-
-	    /* fill in the expansion factors for those plant records    */
-	    /* that don't have one filled in by using the sample        */
-	    /* design records. Mostly, shrubs will have the expf filled */
-	    /* by calling this function, but it should work for trees   */
-	    if( plant_ptr->expf <= 0.0 )
-	      {
-		
-		
-		    calc_exp_from_cover_and_ca( return_code,
-						plant_ptr->pct_cover,
-						plant_ptr->crown_area,
-						&plant_ptr->expf );
-
-		  if( *return_code != CONIFERS_SUCCESS)
-		    {
-		      plant_ptr->errors |= E_INVALID_EXPF;
-		      error_count += 1;
-		    }
-
-	      }
-    
-    }
-
-  calc_plot_stats_2(    return_code, 
-			n_species,
-			species_ptr,
-			n_coeffs,
-			coeffs_ptr,
-			n_plants,
-			plants_ptr,
-			n_points,
-			plots_ptr );
-
-    /* todo: need_error_trap_here */
-
-    /* SECOND PASS */
-    /* The second pass is required becuase the crown values are */
-    /* dependent on the basic plot summary statistics which are */
-    /* calculated for the plot before hand                      */
-    /* now make the second pass */
-    //error_count  = 0;
-    plant_ptr = &plants_ptr[0];
-    for( i = 0; i < n_plants; i++, plant_ptr++ )
-      {
-
-	c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
-
-
-	/* don't go any further if you don't have a functional species code */
-	if( c_ptr == NULL )
-	  {
-	    continue;
-	  }
-
-	/* set the pointer for the current plot that the plant is on */
-	plot_ptr = get_plot( plant_ptr->plot, n_points, plots_ptr );
-        
-	/* fill in the percent cover for the plant recor */
-	if( plant_ptr->pct_cover == 0.0)  /* fill in percent cover */
-	  {
-	    plant_ptr->pct_cover = 100.0 * plant_ptr->expf * plant_ptr->crown_area / SQ_FT_PER_ACRE;
-	  }
-
-	/* if the crown ratio is invalid or missing     */
-	/* fill in the crown ratio for the plant record */
-	if( is_tree( c_ptr ) )
-	{
-	    if( plant_ptr->cr <= 0.0 || plant_ptr->cr > 1.0 )
-	      {
-            /* maybe replace these select-case statements with function calls? */
-		    get_in_taller_attribs( plant_ptr, plot_ptr, bait, cait );
-            
-
-		    //cait_c       =   cait[CONIFER];     // unused removed jan 2014;
-		    //cait_h       =   cait[HARDWOOD];    // unused removed jan 2014;
-		    //cait_s       =   cait[SHRUB];       // unused removed jan 2014;
-		    *return_code = CONIFERS_SUCCESS;
-
-		          swo_calc_crown_ratio(return_code,  
-				           plant_ptr->tht,
-				           plant_ptr->d6,
-				           &plant_ptr->cr,
-				           c_ptr->crown_ratio);
-	      }                              
-	  }
-
-    if( *return_code != CONIFERS_SUCCESS)
-    {
-        plant_ptr->errors |= E_INVALID_CR;
-        error_count += 1;
-    }
-
-	plant_ptr->max_crown_width = 0.0;
-
-	/*  MOD014 */
-	  /* if it's a tree, compute the crown width */
-	  if( is_tree( c_ptr ) )
-	    {
-	      *return_code = CONIFERS_SUCCESS;
-	      
-		    calc_max_crown_width(  return_code,
-					   plant_ptr->dbh,
-					   plant_ptr->tht,
-					   &plant_ptr->max_crown_width,
-					   c_ptr->max_crown_width);
-     
-		  if( *return_code != CONIFERS_SUCCESS)
-		    {
-		      plant_ptr->errors |= E_INVALID_MCW;   
-		      error_count += 1;
-		    }
-	    }
-      }
-   
-    if (error_count > 0)
-      {
-	*return_code = FILL_VALUES_ERROR;
-	return;
-      }
-    *return_code = CONIFERS_SUCCESS;
+  impute_in_batches( return_code,
+		     n_species,
+		     species_ptr,
+		     n_coeffs,
+		     coeffs_ptr,
+		     n_plants,
+		     plants_ptr,
+		     n_points,
+		     plots_ptr,
+		     fixed_plot_radius,
+		     min_dbh,
+		     baf,
+		     &swo_impute_kernels );
 
 }
 
@@ -657,6 +353,8 @@ void swo_impute(
 /*                  struct COEFFS_RECORD *coeffs_ptr - array of coefficients    */
 /*                      that are used to project the individual plants on the   */
 /*                      plot.                                                   */
+/*                  struct RANDOM_STREAM *rand_stream - the random deviates for */
+/*                      the plant in the current year (see sample.c)            */
 /********************************************************************************/
 void swo_project_plant(  
    unsigned long           *return_code,
@@ -669,7 +367,8 @@ void swo_project_plant(
    unsigned long           endemic_mortality,  
    int                     hcb_growth_on,      
    unsigned long           use_precip_in_hg,   
-   unsigned long           use_rand_err )
+   unsigned long           use_rand_err,
+   struct RANDOM_STREAM    *rand_stream )
 {
 
    struct COEFFS_RECORD    *c_ptr;
@@ -714,9 +413,9 @@ void swo_project_plant(
 
    /* get a uniform deviate for the browse */
    /* and one for the top damage           */
-   normal                  = (double)gauss_dev();  
-   browse_random_unif_0_1  = uniform_0_1();
-   top_dam_random_unif_0_1 = uniform_0_1();
+   normal                  = stream_gauss_dev( rand_stream );  
+   browse_random_unif_0_1  = stream_uniform_0_1( rand_stream );
+   top_dam_random_unif_0_1 = stream_uniform_0_1( rand_stream );
 
    /* calc the height growth...        */
    /* calc diam growth...              */
@@ -851,7 +550,7 @@ void swo_project_plant(
 			            plot_ptr->ca_c,
 			            plot_ptr->ca_h,
 			            plot_ptr->ca_s,
-			            uniform_0_1(),
+			            stream_uniform_0_1( rand_stream ),
 			            &plant_ptr->cr_growth,
 			            c_ptr->cr_growth);
 
@@ -891,7 +590,7 @@ void swo_project_plant(
 				        plot_ptr->ca_h,
 					    plot_ptr->ca_s,
 					    cat_c,
-				        uniform_0_1(),
+				        stream_uniform_0_1( rand_stream ),
 				        &plant_ptr->cw_growth,
 					    c_ptr->cw_growth,
                         c_ptr->type);
@@ -928,6 +627,255 @@ void swo_project_plant(
 }
 
 
+/********************************************************************************/
+/* swo_project_plot                                                             */
+/********************************************************************************/
+/*  Description :   projects all the plants on the plot forward one year with   */
+/*                  the CONIFERS_SWO equations                                  */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the plants are grown in batches that share a functional     */
+/*                  species, see project_plot_in_batches                        */
+/*  Arguments   :   see VARIANT_RECORD project_plot in conifers.h               */
+/********************************************************************************/
+void swo_project_plot(
+   unsigned long           *return_code,
+   struct PLANT_RECORD     *plants_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   unsigned long           n_species,
+   struct SPECIES_RECORD   *species_ptr,
+   unsigned long           n_coeffs,
+   struct COEFFS_RECORD    *coeffs_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err,
+   struct SUMMARY_RECORD   *before_sums,
+   unsigned long           use_genetic_gains,
+   unsigned long           plantation_age,
+   unsigned long           yrst,
+   unsigned long           *n_years_projected )
+{
+
+   project_plot_in_batches( return_code,
+                            plants_ptr,
+                            plot_ptr,
+                            species_ptr,
+                            n_coeffs,
+                            coeffs_ptr,
+                            endemic_mortality,
+                            hcb_growth_on,
+                            use_precip_in_hg,
+                            use_rand_err,
+                            plantation_age,
+                            swo_project_plant_batch );
+
+}
+
+
+/********************************************************************************/
+/* swo_project_plant_batch                                                      */
+/********************************************************************************/
+/*  Description :   projects a batch of plants that share a functional species  */
+/*                  forward one year, same as calling swo_project_plant for     */
+/*                  each plant in the batch                                     */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the deviates for each plant are drawn from its stream in    */
+/*                  the same order swo_project_plant draws them, and each       */
+/*                  batched equation does the same arithmetic as the scalar     */
+/*                  one, so the results are the same to the last bit. the       */
+/*                  equation loops have no branches on the plant type and are   */
+/*                  marked omp simd, so they can be vectorized. if the package  */
+/*                  is built with -ffast-math (or -ffp-contract=fast on a       */
+/*                  machine with fma) the compiler may use vector exp/log/pow   */
+/*                  and fused multiply-adds, and the growth can then differ     */
+/*                  from the scalar path by a few units in the last place       */
+/*                  (relative differences below 1e-12)                          */
+/*  Arguments   :                                                               */
+/*  unsigned long *return_code          - return code                           */
+/*  struct SPECIES_RECORD *species_ptr  - the species array                     */
+/*  struct PLOT_RECORD *plot_ptr        - the plot the plants are on            */
+/*  struct GROWTH_BATCH *batch_ptr      - plants, streams and coefficients      */
+/*  endemic_mortality, hcb_growth_on, use_precip_in_hg, use_rand_err - same as  */
+/*                                        for swo_project_plant                 */
+/********************************************************************************/
+void swo_project_plant_batch(
+   unsigned long           *return_code,
+   struct SPECIES_RECORD   *species_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   struct GROWTH_BATCH     *batch_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err )
+{
+
+   unsigned long           k;
+   unsigned long           tree;
+   unsigned long           shrub;
+   struct COEFFS_RECORD    *c_ptr;
+   struct PLANT_RECORD     *plant_ptr;
+
+   double  bait[PLANT_TYPES];
+   double  cait[PLANT_TYPES];
+
+   *return_code = CONIFERS_SUCCESS;
+
+   c_ptr = batch_ptr->c_ptr;
+   if( c_ptr == NULL )
+   {
+      *return_code = CONIFERS_ERROR;
+      return;
+   }
+
+   tree  = is_tree( c_ptr );
+   shrub = is_shrub( c_ptr );
+
+   for( k = 0; k < batch_ptr->n; k++ )
+   {
+      batch_ptr->tht_growth[k]    = 0.0;
+      batch_ptr->d6_growth[k]     = 0.0;
+      batch_ptr->dbh_growth[k]    = 0.0;
+      batch_ptr->cr_growth[k]     = 0.0;
+      batch_ptr->cw_growth[k]     = 0.0;
+   }
+
+   /* forbs and non stocked records don't grow, they skip the */
+   /* deviates and the equations and only get the mortality   */
+   if( tree || shrub )
+   {
+      /* the deviates for the whole batch are drawn at once, in  */
+      /* the same order swo_project_plant draws them */
+      fill_growth_batch_deviates( batch_ptr, tree, shrub );
+
+      /* load the batch */
+      for( k = 0; k < batch_ptr->n; k++ )
+      {
+         plant_ptr  = batch_ptr->plant_ptr[k];
+
+         get_in_taller_attribs( plant_ptr, plot_ptr, bait, cait );
+         batch_ptr->cat_c[k]         = cait[CONIFER];
+         batch_ptr->cat_h[k]         = cait[HARDWOOD];
+         batch_ptr->cat_s[k]         = cait[SHRUB];
+
+         batch_ptr->tht[k]           = plant_ptr->tht;
+         batch_ptr->cr[k]            = plant_ptr->cr;
+         batch_ptr->d6[k]            = plant_ptr->d6;
+         batch_ptr->dbh[k]           = plant_ptr->dbh;
+         batch_ptr->crown_width[k]   = plant_ptr->crown_width;
+         batch_ptr->prob_browse[k]   = species_ptr[plant_ptr->sp_idx].browse_damage;
+         batch_ptr->prob_top_damage[k] = species_ptr[plant_ptr->sp_idx].mechanical_damage;
+      }
+   }
+
+   if( tree || shrub )
+   {
+      calc_height_growth_batch( return_code,
+                                batch_ptr,
+                                plot_ptr->water_capacity,
+                                plot_ptr->ca_h,
+                                plot_ptr->ca_s,
+                                use_rand_err,
+                                c_ptr->ht_growth,
+                                c_ptr->type );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+
+      calc_d6_growth_batch( return_code,
+                            batch_ptr,
+                            plot_ptr->water_capacity,
+                            c_ptr->d6_growth,
+                            c_ptr->type );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+   }
+
+   if( tree )
+   {
+      swo_calc_dbh_growth_batch( return_code,
+                                 batch_ptr,
+                                 c_ptr->dbh_growth );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+
+      swo_calc_cr_growth_batch( return_code,
+                                batch_ptr,
+                                hcb_growth_on,
+                                plot_ptr->ca_c,
+                                plot_ptr->ca_h,
+                                plot_ptr->ca_s,
+                                c_ptr->cr_growth );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+
+      for( k = 0; k < batch_ptr->n; k++ )
+      {
+         plant_ptr = batch_ptr->plant_ptr[k];
+         calc_max_crown_width( return_code,
+                               batch_ptr->dbh[k] + batch_ptr->dbh_growth[k],
+                               batch_ptr->tht[k] + batch_ptr->tht_growth[k],
+                               &plant_ptr->max_crown_width,
+                               c_ptr->max_crown_width );
+         if( *return_code != CONIFERS_SUCCESS )
+         {
+            return;
+         }
+      }
+   }
+
+   if( tree || shrub )
+   {
+      calc_cw_growth_batch( return_code,
+                            batch_ptr,
+                            plot_ptr->ca_c,
+                            plot_ptr->ca_h,
+                            plot_ptr->ca_s,
+                            c_ptr->cw_growth,
+                            c_ptr->type );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+   }
+
+   /* copy the growth back to the plant records */
+   for( k = 0; k < batch_ptr->n; k++ )
+   {
+      plant_ptr = batch_ptr->plant_ptr[k];
+
+      plant_ptr->tht_growth   = batch_ptr->tht_growth[k];
+      plant_ptr->d6_growth    = batch_ptr->d6_growth[k];
+      plant_ptr->d12_growth   = 0.0;
+      plant_ptr->cw_growth    = batch_ptr->cw_growth[k];
+      plant_ptr->cr_growth    = batch_ptr->cr_growth[k];
+      plant_ptr->dbh_growth   = batch_ptr->dbh_growth[k];
+      plant_ptr->expf_change  = 0.0;
+
+      if( endemic_mortality == 1 )
+      {
+         swo_calc_endemic_mortality( return_code,
+                                     plant_ptr->expf,
+                                     &plant_ptr->expf_change,
+                                     &species_ptr[plant_ptr->sp_idx].endemic_mortality );
+         if( *return_code != CONIFERS_SUCCESS )
+         {
+            return;
+         }
+      }
+   }
+
+   *return_code = CONIFERS_SUCCESS;
+
+}
+
+
 
 
 /********************************************************************************/
@@ -2581,6 +2529,605 @@ void calc_cw_growth(
     }
 
 }
+
+
+/********************************************************************************/
+/*                  calc_height_growth_batch                                    */
+/********************************************************************************/
+/*  Description :   calc_height_growth for each plant in a batch                */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the plant type is the same for the whole batch, so the      */
+/*                  equation is picked once and the loop over the plants only   */
+/*                  has selects left in it. the logs, powers and exps are done  */
+/*                  a column at a time with batch_log, batch_pow and batch_exp  */
+/*  Arguments   :   see calc_height_growth, the plant level values are the      */
+/*                  columns of the batch and the results are in tht_growth      */
+/********************************************************************************/
+SIMD_CLONES static void calc_height_growth_batch(
+    unsigned long       *return_code,
+    struct GROWTH_BATCH *batch_ptr,
+    double              h20_holding_capacity,
+    double              cahw,
+    double              cash,
+    long                ind_random,
+    double              *coeffs_ptr,
+    unsigned long       plant_type )
+{
+
+    unsigned long   k;
+    unsigned long   n;
+    double          *tht;
+    double          *hg;
+    double          b0;
+    double          b1;
+    double          b7;
+    double          b8;
+    double          total_height;
+    double          height_var;
+    double          height_for_error;
+    double          cat;
+    double          temp_growth;
+    int             broken;
+    int             browsing;
+    double          log_tht[GROWTH_BATCH_SIZE];
+    double          pow_tht[GROWTH_BATCH_SIZE];
+    double          log_cr[GROWTH_BATCH_SIZE];
+    double          exp_term[GROWTH_BATCH_SIZE];
+
+    *return_code = CONIFERS_SUCCESS;
+
+    if( coeffs_ptr == NULL )
+    {
+        *return_code = CONIFERS_ERROR;
+        return;
+    }
+
+    n   = batch_ptr->n;
+    tht = batch_ptr->tht;
+    hg  = batch_ptr->tht_growth;
+
+    for( k = 0; k < n; k++ )
+    {
+        if( tht[k] < 0.0 )
+        {
+            *return_code = INVALID_INPUT_VAL;
+            return;
+        }
+    }
+
+    if( plant_type == CONIFER || plant_type == HARDWOOD )
+    {
+        b0  = coeffs_ptr[0];
+        b1  = coeffs_ptr[1]  * h20_holding_capacity;
+        b7  = coeffs_ptr[7]  *  (cahw/SQ_FT_PER_ACRE) * (cahw/SQ_FT_PER_ACRE);
+        b8  = coeffs_ptr[8]  *  (cash/SQ_FT_PER_ACRE) * (cash/SQ_FT_PER_ACRE);
+
+        for( k = 0; k < n; k++ )
+        {
+            log_cr[k] = ( batch_ptr->cr[k] < 0.01 ) ? 0.01 : batch_ptr->cr[k];
+        }
+
+        batch_log( n, tht, log_tht );
+        batch_pow( n, tht, 1.50, pow_tht );
+        batch_log( n, log_cr, log_cr );
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+        for( k = 0; k < n; k++ )
+        {
+            exp_term[k] =   b0 + b1
+                          + coeffs_ptr[3]  * log_tht[k]
+                          + coeffs_ptr[4]  * pow_tht[k]
+                          + coeffs_ptr[5]  * log_cr[k]
+                          + coeffs_ptr[6]  * (batch_ptr->cat_c[k]/SQ_FT_PER_ACRE)*(batch_ptr->cat_c[k]/SQ_FT_PER_ACRE)
+                          + b7 + b8;
+        }
+
+        batch_exp( n, exp_term, exp_term );
+
+#ifdef _OPENMP
+#pragma omp simd private( total_height, height_var, height_for_error, temp_growth, broken, browsing )
+#endif
+        for( k = 0; k < n; k++ )
+        {
+            total_height = tht[k];
+
+            browsing = ( batch_ptr->prob_browse[k] > batch_ptr->browse_unif[k] && total_height <= 4.5 );
+            broken   = ( batch_ptr->prob_top_damage[k] > batch_ptr->top_dam_unif[k] );
+
+            /* no random error if it's turned off, or the plant is broken or browsed, */
+            /* or if the deviate is outside the 10th and 90th percentiles            */
+            height_var = ( ind_random == 0 || broken || browsing ) ? 0.0 : batch_ptr->normal[k];
+            height_var = ( height_var < -1.645 || height_var > 1.645 ) ? 0.0 : height_var;
+
+            height_for_error = ( total_height > 15.0 ) ? 15.0 : total_height;
+
+            temp_growth =  coeffs_ptr[12] * (1.0 / total_height)
+                         + exp_term[k]
+                         + ( coeffs_ptr[9]  * (sqrt(height_for_error/2.0) * height_var)
+                           + coeffs_ptr[13] * height_var / sqrt(2.0) );
+
+            hg[k] = ( ( temp_growth <= 0.0 ) ? 0.0 : temp_growth )
+                    + ( (double)coeffs_ptr[10] * (double)broken + (double)coeffs_ptr[11] * (double)browsing );
+        }
+    }
+    else if( plant_type == SHRUB )
+    {
+        /****for unknown brush species set growth to zero *****/
+        if( coeffs_ptr[1] == 0 && coeffs_ptr[2] == 0 && coeffs_ptr[3] == 0 && coeffs_ptr[4] == 0 )
+        {
+            for( k = 0; k < n; k++ )
+            {
+                hg[k] = 0.0;
+            }
+        }
+        else
+        {
+            batch_log( n, tht, log_tht );
+
+#ifdef _OPENMP
+#pragma omp simd private( cat )
+#endif
+            for( k = 0; k < n; k++ )
+            {
+                cat = (batch_ptr->cat_c[k]+batch_ptr->cat_h[k]+batch_ptr->cat_s[k])/SQ_FT_PER_ACRE;
+
+                exp_term[k] = coeffs_ptr[1] + coeffs_ptr[2]*(log_tht[k]) 
+                            + coeffs_ptr[3]*tht[k]*batch_ptr->d6[k] + coeffs_ptr[4]*cat*cat;
+            }
+
+            batch_exp( n, exp_term, exp_term );
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+            for( k = 0; k < n; k++ )
+            {
+                hg[k] = coeffs_ptr[0]/tht[k] + exp_term[k];
+            }
+        }
+    }
+    else
+    {
+        for( k = 0; k < n; k++ )
+        {
+            hg[k] = 0.0;
+        }
+    }
+
+    /* plants under half a foot get 0.2 feet, and if the predicted */
+    /* height is under half a foot the plant doesn't grow          */
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+    for( k = 0; k < n; k++ )
+    {
+        hg[k] = ( tht[k] <= 0.5 ) ? 0.20 : ( ( tht[k] + hg[k] <= 0.5 ) ? 0.0 : hg[k] );
+    }
+
+}
+
+
+/********************************************************************************/
+/*                  calc_d6_growth_batch                                        */
+/********************************************************************************/
+/*  Description :   calc_d6_growth for each plant in a batch                    */
+/*  Returns     :   void                                                        */
+/*  Comments    :   reads the height growth from the batch, so it has to be     */
+/*                  called after calc_height_growth_batch                       */
+/********************************************************************************/
+SIMD_CLONES static void calc_d6_growth_batch(
+    unsigned long       *return_code,
+    struct GROWTH_BATCH *batch_ptr,
+    double              h20_holding_capacity,
+    double              *coeffs_ptr,
+    unsigned long       plant_type )
+{
+
+    unsigned long   k;
+    unsigned long   n;
+    double          *hg;
+    double          *dg;
+    double          d6;
+    double          sum_cat;
+    double          temp_cat_total;
+    double          temp_dg;
+    double          pow_hg[GROWTH_BATCH_SIZE];
+    double          exp_term[GROWTH_BATCH_SIZE];
+
+    *return_code = CONIFERS_SUCCESS;
+
+    if( coeffs_ptr == NULL )
+    {
+        *return_code = CONIFERS_ERROR;
+        return;
+    }
+
+    n  = batch_ptr->n;
+    hg = batch_ptr->tht_growth;
+    dg = batch_ptr->d6_growth;
+
+    for( k = 0; k < n; k++ )
+    {
+        if( batch_ptr->crown_width[k] <= 0.0 )
+        {
+            *return_code = INVALID_INPUT_VAL;
+            return;
+        }
+    }
+
+    if( plant_type == CONIFER || plant_type == HARDWOOD )
+    {
+#ifdef _OPENMP
+#pragma omp simd private( d6 )
+#endif
+        for( k = 0; k < n; k++ )
+        {
+            d6 = batch_ptr->d6[k];
+
+            exp_term[k] =  coeffs_ptr[0]
+                        +  coeffs_ptr[2] * sqrt(batch_ptr->crown_width[k])
+                        +  coeffs_ptr[3] * d6
+                        +  coeffs_ptr[4] * (batch_ptr->cat_c[k]/SQ_FT_PER_ACRE)*(batch_ptr->cat_c[k]/SQ_FT_PER_ACRE)
+                        +  coeffs_ptr[5] * (batch_ptr->cat_h[k]/SQ_FT_PER_ACRE)*(batch_ptr->cat_h[k]/SQ_FT_PER_ACRE)
+                        +  coeffs_ptr[6] * (batch_ptr->cat_s[k]/SQ_FT_PER_ACRE)*(batch_ptr->cat_s[k]/SQ_FT_PER_ACRE)
+                        +  coeffs_ptr[7] * d6*d6;
+        }
+
+        batch_pow( n, hg, coeffs_ptr[1], pow_hg );
+        batch_exp( n, exp_term, exp_term );
+
+#ifdef _OPENMP
+#pragma omp simd private( temp_dg )
+#endif
+        for( k = 0; k < n; k++ )
+        {
+            temp_dg = pow_hg[k] * exp_term[k];
+
+            dg[k] = ( hg[k] <= 0.0 || temp_dg < 0.0 ) ? 0.0 : temp_dg;
+        }
+    }
+    else if( plant_type == SHRUB || plant_type == FORB )
+    {
+#ifdef _OPENMP
+#pragma omp simd private( sum_cat, temp_cat_total, temp_dg )
+#endif
+        for( k = 0; k < n; k++ )
+        {
+            sum_cat        = batch_ptr->cat_s[k] + batch_ptr->cat_c[k] + batch_ptr->cat_h[k];
+            temp_cat_total = ( sum_cat <= 0.0 ) ? 0.01 : sum_cat/SQ_FT_PER_ACRE;
+
+            temp_dg =    (  coeffs_ptr[0]
+                          + coeffs_ptr[1] * hg[k] *2
+                          + coeffs_ptr[2] * batch_ptr->tht[k]
+                          + coeffs_ptr[3] / (sqrt( temp_cat_total) )
+                          + coeffs_ptr[4] * h20_holding_capacity) / 2.0;
+
+            dg[k] = ( hg[k] <= 0.0 || temp_dg < 0.0 ) ? 0.0 : temp_dg;
+        }
+    }
+    else
+    {
+        for( k = 0; k < n; k++ )
+        {
+            dg[k] = 0.0;
+        }
+    }
+
+}
+
+
+/********************************************************************************/
+/*                  swo_calc_dbh_growth_batch                                   */
+/********************************************************************************/
+/*  Description :   calc_dbh_growth for each plant in a batch                   */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the swohybrid variant uses the same equation, so this one   */
+/*                  isn't static. reads the d6 growth from the batch            */
+/********************************************************************************/
+SIMD_CLONES void swo_calc_dbh_growth_batch(
+    unsigned long       *return_code,
+    struct GROWTH_BATCH *batch_ptr,
+    double              *coeffs_ptr )
+{
+
+    unsigned long   k;
+    unsigned long   n;
+    double          *d6g;
+    double          *tht;
+    double          *dbhg;
+    double          b0;
+    double          b1;
+    double          b2;
+    double          exp_term[GROWTH_BATCH_SIZE];
+
+    *return_code = CONIFERS_SUCCESS;
+
+    if( coeffs_ptr == NULL )
+    {
+        *return_code = INVALID_COEFF;
+        return;
+    }
+
+    n    = batch_ptr->n;
+    d6g  = batch_ptr->d6_growth;
+    tht  = batch_ptr->tht;
+    dbhg = batch_ptr->dbh_growth;
+
+    for( k = 0; k < n; k++ )
+    {
+        if( d6g[k] < 0.0 )
+        {
+            *return_code = INVALID_INPUT_VAL;
+            return;
+        }
+    }
+
+    b0 = coeffs_ptr[0];
+    b1 = coeffs_ptr[1];
+    b2 = coeffs_ptr[2];
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+    for( k = 0; k < n; k++ )
+    {
+        exp_term[k] = b1 + b2 * tht[k];
+    }
+
+    batch_exp( n, exp_term, exp_term );
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+    for( k = 0; k < n; k++ )
+    {
+        dbhg[k] = ( tht[k] > 4.5 ) ? d6g[k] * ( b0 + exp_term[k] ) : 0.0;
+    }
+
+    for( k = 0; k < n; k++ )
+    {
+        if( dbhg[k] < 0 )
+        {
+            dbhg[k]      = 0.0;
+            *return_code = CONIFERS_ERROR;
+        }
+    }
+
+}
+
+
+/********************************************************************************/
+/*                  swo_calc_cr_growth_batch                                    */
+/********************************************************************************/
+/*  Description :   calc_cr_growth for each plant in a batch                    */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the swohybrid variant uses the same equation, so this one   */
+/*                  isn't static. reads the height growth and the cr_unif       */
+/*                  deviates from the batch                                     */
+/********************************************************************************/
+SIMD_CLONES void swo_calc_cr_growth_batch(
+    unsigned long       *return_code,
+    struct GROWTH_BATCH *batch_ptr,
+    int                 hcb_growth_on,
+    double              conifer_ca,
+    double              hardwood_ca,
+    double              shrub_ca,
+    double              *coeffs_ptr )
+{
+
+    unsigned long   k;
+    unsigned long   n;
+    double          *tht;
+    double          *hg;
+    double          *crg;
+    double          crown_length;
+    double          hcb_growth;
+    double          prob_hcb;
+    double          temp_exponent[GROWTH_BATCH_SIZE];
+
+    *return_code = CONIFERS_SUCCESS;
+
+    if( coeffs_ptr == NULL )
+    {
+        *return_code = INVALID_COEFF;
+        return;
+    }
+
+    n   = batch_ptr->n;
+    tht = batch_ptr->tht;
+    hg  = batch_ptr->tht_growth;
+    crg = batch_ptr->cr_growth;
+
+    /*  on - off switch because hcb change is biannual */
+    /*  off = no change in hcb, i.e. change in hcb=0   */
+    if( !hcb_growth_on )
+    {
+#ifdef _OPENMP
+#pragma omp simd private( crown_length )
+#endif
+        for( k = 0; k < n; k++ )
+        {
+            crown_length = batch_ptr->cr[k] * tht[k];
+            crg[k]       = ( crown_length + hg[k] ) / 
+                           ( tht[k] + hg[k] ) -
+                           ( crown_length / tht[k]  );
+        }
+        return;
+    }
+
+    for( k = 0; k < n; k++ )
+    {
+        crown_length = batch_ptr->cr[k] * tht[k];
+        hcb_growth   = coeffs_ptr[0]
+                     + coeffs_ptr[1] * crown_length 
+                     + coeffs_ptr[2] * 0.00001 * conifer_ca
+                     + coeffs_ptr[3] * 0.00001 * hardwood_ca
+                     + coeffs_ptr[4] * 0.00001 * shrub_ca;
+        if( hcb_growth < 0.0 )          /*  this should NEVER happen!  */
+        {
+            crg[k]       = 0.0;
+            *return_code = CONIFERS_ERROR;
+            return;
+        }
+    }
+
+    /* probability of change in crown base, logistic function */
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+    for( k = 0; k < n; k++ )
+    {
+        temp_exponent[k] = coeffs_ptr[5] 
+                         + coeffs_ptr[6] * batch_ptr->cr[k]  
+                         + coeffs_ptr[7] * conifer_ca  / 43560.0 
+                         + coeffs_ptr[8] * hardwood_ca / 43560.0
+                         + coeffs_ptr[9] * shrub_ca    / 43560.0;
+    }
+
+    batch_exp( n, temp_exponent, temp_exponent );
+
+#ifdef _OPENMP
+#pragma omp simd private( crown_length, hcb_growth, prob_hcb )
+#endif
+    for( k = 0; k < n; k++ )
+    {
+        crown_length = batch_ptr->cr[k] * tht[k];
+        hcb_growth   = coeffs_ptr[0]
+                     + coeffs_ptr[1] * crown_length 
+                     + coeffs_ptr[2] * 0.00001 * conifer_ca
+                     + coeffs_ptr[3] * 0.00001 * hardwood_ca
+                     + coeffs_ptr[4] * 0.00001 * shrub_ca;
+
+        /*  MOD039   added the 0.1 fudge factor to keep cr non-zero & positive */
+        hcb_growth   = ( hcb_growth > ( crown_length + hg[k] ) ) ? crown_length + hg[k] - 0.1 : hcb_growth;
+
+        prob_hcb     = temp_exponent[k] / ( 1.0 + temp_exponent[k] );
+
+        /* if the uniform r.v. is greater then apply change in cr */
+        crg[k] = ( crown_length + hg[k] - ( ( batch_ptr->cr_unif[k] > prob_hcb ) ? hcb_growth : 0.0 ) ) / 
+                 ( tht[k] + hg[k] ) -
+                 ( crown_length / tht[k]  );
+    }
+
+}
+
+
+/********************************************************************************/
+/*                  calc_cw_growth_batch                                        */
+/********************************************************************************/
+/*  Description :   calc_cw_growth for each plant in a batch                    */
+/*  Returns     :   void                                                        */
+/*  Comments    :   reads the height growth from the batch                      */
+/********************************************************************************/
+SIMD_CLONES static void calc_cw_growth_batch(
+    unsigned long       *return_code,
+    struct GROWTH_BATCH *batch_ptr,
+    double              ca_conifers,
+    double              ca_hardwoods,
+    double              ca_shrubs,
+    double              *coeffs_ptr,
+    unsigned long       plant_type )
+{
+
+    unsigned long   k;
+    unsigned long   n;
+    double          *hg;
+    double          *cwg;
+    double          crown_width;
+    double          temp_cwg;
+    double          pow_hg[GROWTH_BATCH_SIZE];
+    double          log_cw[GROWTH_BATCH_SIZE];
+    double          pow_tht[GROWTH_BATCH_SIZE];
+    double          exp_term[GROWTH_BATCH_SIZE];
+
+    *return_code = CONIFERS_SUCCESS;
+
+    if( coeffs_ptr == NULL )
+    {
+        *return_code = INVALID_COEFF;
+        return;
+    }
+
+    if( ca_conifers < 0.0 || ca_hardwoods < 0.0 || ca_shrubs < 0.0 )
+    {
+        *return_code = INVALID_INPUT_VAL;
+        return;
+    }
+
+    n   = batch_ptr->n;
+    hg  = batch_ptr->tht_growth;
+    cwg = batch_ptr->cw_growth;
+
+    for( k = 0; k < n; k++ )
+    {
+        if( batch_ptr->crown_width[k] <= 0.0 )
+        {
+            *return_code = INVALID_INPUT_VAL;
+            return;
+        }
+    }
+
+    ca_conifers = (ca_conifers/SQ_FT_PER_ACRE)*(ca_conifers/SQ_FT_PER_ACRE);
+    ca_hardwoods= (ca_hardwoods/SQ_FT_PER_ACRE)*(ca_hardwoods/SQ_FT_PER_ACRE);
+    ca_shrubs   = (ca_shrubs/SQ_FT_PER_ACRE)*(ca_shrubs/SQ_FT_PER_ACRE);
+
+    if( plant_type == CONIFER || plant_type == HARDWOOD )
+    {
+        batch_pow( n, hg, coeffs_ptr[1], pow_hg );
+        batch_log( n, batch_ptr->crown_width, log_cw );
+
+#ifdef _OPENMP
+#pragma omp simd private( crown_width, temp_cwg )
+#endif
+        for( k = 0; k < n; k++ )
+        {
+            crown_width = batch_ptr->crown_width[k];
+            temp_cwg    = pow_hg[k]
+                          * ( coeffs_ptr[0] 
+                            + coeffs_ptr[2]*sqrt(crown_width) 
+                            + coeffs_ptr[3]*ca_conifers 
+                            + coeffs_ptr[4]*ca_hardwoods 
+                            + coeffs_ptr[5]*ca_shrubs 
+                            + coeffs_ptr[6]*log_cw[k]);
+
+            cwg[k] = ( hg[k] < 0.0 || temp_cwg < 0.0 ) ? 0.0 : temp_cwg;
+        }
+    }
+    else if( plant_type == SHRUB )
+    {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+        for( k = 0; k < n; k++ )
+        {
+            exp_term[k] = coeffs_ptr[10]*(batch_ptr->cat_c[k]/SQ_FT_PER_ACRE);
+        }
+
+        batch_pow( n, batch_ptr->tht, coeffs_ptr[9], pow_tht );
+        batch_exp( n, exp_term, exp_term );
+
+#ifdef _OPENMP
+#pragma omp simd private( temp_cwg )
+#endif
+        for( k = 0; k < n; k++ )
+        {
+            temp_cwg = (hg[k]*2.0) * coeffs_ptr[8]*pow_tht[k] 
+                       * exp_term[k];
+
+            cwg[k] = ( hg[k] < 0.0 || temp_cwg < 0.0 ) ? 0.0 : 0.5* temp_cwg;
+        }
+    }
+    else
+    {
+        for( k = 0; k < n; k++ )
+        {
+            cwg[k] = 0.0;
+        }
+    }
+
+}
 /********************************************************************************/
 /*                  calc_endemic_mortality                                      */
 /********************************************************************************/
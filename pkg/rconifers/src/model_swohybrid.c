@@ -204,16 +204,24 @@ void swo_hybrid_calc_height_growth(
     double          prob_top_damage,
     unsigned long   use_precip, 
     
-	double			min_temp,		/* species specific minumum temperature, in C	*/
-	double			max_temp,		/* species specific maximum temperature, in C	*/
-	double			opt_temp,		/* species specific optimal temperature, in C	*/
-	double			*tday_c,		/* tday_c is a vector of monthly temps, in C	*/
-	double			*srad,			/* solar radiation, vector[12]					*/
+	double			srt,			/* solar radiation temperature modifier	*/
 
     double          *height_growth,
     double          *coeffs_ptr,
 	unsigned long   plant_type);
 
+static double swo_hybrid_get_srt(
+	struct PLOT_RECORD      *plot_ptr,
+	struct SPECIES_RECORD   *species_ptr,
+	unsigned long           sp_idx );
+
+static double swo_hybrid_calc_srt(
+	double			min_temp,
+	double			max_temp,
+	double			opt_temp,
+	double			*tday_c,
+	double			*srad );
+
 void swo_hybrid_calc_cr_growth(
     unsigned long   *return_code,
     int             hcb_growth_on,
@@ -244,12 +252,50 @@ void swo_hybrid_calc_cw_growth(
 
 
 
+/* batched versions of the growth equations, see swo_hybrid_project_plant_batch */
+static void swo_hybrid_calc_height_growth_batch(
+	unsigned long       *return_code,
+	struct GROWTH_BATCH *batch_ptr,
+	double              precip,
+	double              h20_holding_capacity,
+	double              cahw,
+	double              cash,
+	double              *coeffs_ptr,
+	unsigned long       plant_type );
+
+static void swo_hybrid_calc_d6_growth_batch(
+	unsigned long       *return_code,
+	struct GROWTH_BATCH *batch_ptr,
+	double              h20_holding_capacity,
+	double              *coeffs_ptr,
+	unsigned long       plant_type );
+
+static void swo_hybrid_calc_cw_growth_batch(
+	unsigned long       *return_code,
+	struct GROWTH_BATCH *batch_ptr,
+	double              ca_conifers,
+	double              ca_hardwoods,
+	double              ca_shrubs,
+	double              *coeffs_ptr,
+	unsigned long       plant_type );
+
+
 void swo_hybrid_calc_endemic_mortality(   
     unsigned long   *return_code,
     double          expansion_factor,
     double          *pred_mortality,
     double          *coeffs_ptr );
 
+/* the imputation equations, see impute_in_batches. they are the same */
+/* as the swo_hybrid_calc_ versions in this file                      */
+static const struct IMPUTE_KERNELS swo_hybrid_impute_kernels = {
+      calc_d6_from_total_height_batch,
+      calc_d6_from_ht_and_dbh_batch,
+      calc_dbh_from_height_and_d6_batch,
+      calc_crown_width_batch,
+      calc_exp_from_cover_and_ca_batch,
+      calc_crown_ratio_batch,
+      calc_max_crown_width_batch };
 
 
 
@@ -265,7 +311,8 @@ void swo_hybrid_calc_endemic_mortality(
 /*  Author      :   Jeff D. Hamann                                              */
 /*  Date        :   September 12, 1999                                          */
 /*  Returns     :   void                                                        */
-/*  Comments    :   NONE                                                        */
+/*  Comments    :   the equations are run over batches of plants, see           */
+/*                  impute_in_batches (impute.c)                                */
 /*  Arguments   :   unsigned long *return_code  - pointer to a return code      */
 /*                  unsigned long n_plants      - total number fo plants in the */
 /*                      plants pointer array                                    */
@@ -298,366 +345,368 @@ void swohybrid_impute(
 			    double                  baf )
 {
 
-  unsigned long   i;
-  struct  PLANT_RECORD    *plant_ptr = NULL;
-  //struct  PLOT_RECORD     *plot_ptr = NULL;  // cruft??? mwr jan 2014;
-  struct  COEFFS_RECORD   *c_ptr = NULL;
-  unsigned long   error_count = 0;
+  impute_in_batches( return_code,
+		     n_species,
+		     species_ptr,
+		     n_coeffs,
+		     coeffs_ptr,
+		     n_plants,
+		     plants_ptr,
+		     n_points,
+		     plots_ptr,
+		     fixed_plot_radius,
+		     min_dbh,
+		     baf,
+		     &swo_hybrid_impute_kernels );
 
-//  double  bait[PLANT_TYPES];
-//  double  cait[PLANT_TYPES];
+}
 
-//  double        cait_c;
-//  double        cait_h;
-//  double        cait_s;
 
-  error_count  = 0;
-  *return_code = CONIFERS_SUCCESS;
+/********************************************************************************/
+/*                  swo_hybrid_calc_height_growth_batch                         */
+/********************************************************************************/
+/*  Description :   swo_hybrid_calc_height_growth for each plant in a batch     */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the plant type is the same for the whole batch, so the      */
+/*                  equation is picked once. the SRT for each plant is in the   */
+/*                  srt column and the results are in tht_growth. the logs,     */
+/*                  powers and exps are done a column at a time                 */
+/********************************************************************************/
+SIMD_CLONES static void swo_hybrid_calc_height_growth_batch(
+	unsigned long       *return_code,
+	struct GROWTH_BATCH *batch_ptr,
+	double              precip,
+	double              h20_holding_capacity,
+	double              cahw,
+	double              cash,
+	double              *coeffs_ptr,
+	unsigned long       plant_type )
+{
 
-  /* first check to make sure there are plants in the array */
-  if( n_plants <= 0 || plants_ptr == NULL ) 
-    {
-      *return_code = INVALID_PLANT_COUNT;
-      return;
-    }
+	unsigned long   k;
+	unsigned long   n;
+	double          *tht;
+	double          *hg;
+	double          total_height;
+	double          catcon;
+	double          cat;
+	double          log_precip;
+	double          temp_growth;
+	int             broken;
+	int             browsing;
+	double          log_tht[GROWTH_BATCH_SIZE];
+	double          pow_tht[GROWTH_BATCH_SIZE];
+	double          log_cr[GROWTH_BATCH_SIZE];
+	double          exp_term[GROWTH_BATCH_SIZE];
+
+	*return_code = CONIFERS_SUCCESS;
+
+	if( coeffs_ptr == NULL )
+	{
+		*return_code = CONIFERS_ERROR;
+		return;
+	}
 
-  /* first check to make sure there are plants in the array */
-  if( n_points <= 0 || plots_ptr == NULL ) 
-    {
-      *return_code = INVALID_PLOT_COUNT;
-      return;
-    }
+	n   = batch_ptr->n;
+	tht = batch_ptr->tht;
+	hg  = batch_ptr->tht_growth;
 
-  /* FIRST PASS */
-  /* make a first pass to calculate the basic data for the plants */
-  /* fill in missing dbh, d6, and total heights */
-  plant_ptr = &plants_ptr[0];
-  for( i = 0; i < n_plants; i++, plant_ptr++ )
-    {
+	for( k = 0; k < n; k++ )
+	{
+		if( tht[k] < 0.0 )
+		{
+			*return_code = INVALID_INPUT_VAL;
+			return;
+		}
+	}
+
+	if( plant_type == CONIFER || plant_type == HARDWOOD )
+	{
+		for( k = 0; k < n; k++ )
+		{
+			log_cr[k] = ( batch_ptr->cr[k] < 0.01 ) ? 0.01 : batch_ptr->cr[k];
+		}
+
+		log_precip = log( precip );
+		batch_log( n, tht, log_tht );
+		batch_pow( n, tht, coeffs_ptr[10], pow_tht );
+		batch_log( n, log_cr, log_cr );
+
+#ifdef _OPENMP
+#pragma omp simd private( catcon )
+#endif
+		for( k = 0; k < n; k++ )
+		{
+			catcon = batch_ptr->cat_c[k];
+
+			exp_term[k] = coeffs_ptr[0]
+			            + coeffs_ptr[1] * h20_holding_capacity
+			            + coeffs_ptr[2] * log_tht[k]
+			            + coeffs_ptr[3] * ( pow_tht[k] ) * 0.1
+			            + coeffs_ptr[4] * log_cr[k]
+			            + coeffs_ptr[5] * (catcon/SQ_FT_PER_ACRE) * (catcon/SQ_FT_PER_ACRE)
+			            + coeffs_ptr[6] * ( cahw/SQ_FT_PER_ACRE )*  (cahw/SQ_FT_PER_ACRE)
+			            + coeffs_ptr[7] * ( cash/SQ_FT_PER_ACRE )*( cash/SQ_FT_PER_ACRE )
+			            + coeffs_ptr[8] * log_precip
+			            + coeffs_ptr[9] * ( batch_ptr->srt[k] );
+		}
+
+		batch_exp( n, exp_term, exp_term );
+
+#ifdef _OPENMP
+#pragma omp simd private( total_height, temp_growth, broken, browsing )
+#endif
+		for( k = 0; k < n; k++ )
+		{
+			total_height = tht[k];
 
-      plant_ptr->errors = E_OKDOKEY; /* default value for error is set=ok */ 
+			browsing = ( batch_ptr->prob_browse[k] > batch_ptr->browse_unif[k] && total_height <= 4.5 );
+			broken   = ( batch_ptr->prob_top_damage[k] > batch_ptr->top_dam_unif[k] );
 
-      c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
+			temp_growth = exp_term[k];
 
-      /* don't go any further if you don't have a functional species code */
-      if( c_ptr == NULL )
+			/* damage adjustments */
+			hg[k] = ( ( temp_growth <= 0.0 ) ? 0.0 : temp_growth )
+			        + ( (double)coeffs_ptr[11] * (double)broken + (double)coeffs_ptr[12] * (double)browsing );
+		}
+	}
+	else if( plant_type == SHRUB )
+	{
+		/****for unknown brush species set growth to zero *****/
+		if( coeffs_ptr[1] == 0 && coeffs_ptr[2] == 0 && coeffs_ptr[3] == 0 && coeffs_ptr[4] == 0 )
+		{
+			for( k = 0; k < n; k++ )
+			{
+				hg[k] = 0.0;
+			}
+		}
+		else
+		{
+			batch_log( n, tht, log_tht );
+
+#ifdef _OPENMP
+#pragma omp simd private( cat )
+#endif
+			for( k = 0; k < n; k++ )
+			{
+				cat = (batch_ptr->cat_c[k]+batch_ptr->cat_h[k]+batch_ptr->cat_s[k])/SQ_FT_PER_ACRE;
+
+				exp_term[k] = coeffs_ptr[1] + coeffs_ptr[2]*(log_tht[k]) 
+				            + coeffs_ptr[3]*tht[k]*batch_ptr->d6[k] + coeffs_ptr[4]*cat*cat;
+			}
+
+			batch_exp( n, exp_term, exp_term );
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+			for( k = 0; k < n; k++ )
+			{
+				hg[k] = coeffs_ptr[0]/tht[k] + exp_term[k];
+			}
+		}
+	}
+	else
+	{
+		for( k = 0; k < n; k++ )
+		{
+			hg[k] = 0.0;
+		}
+	}
+
+	/* plants under half a foot get 0.2 feet, and if the predicted */
+	/* height is under half a foot the plant doesn't grow          */
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+	for( k = 0; k < n; k++ )
 	{
-	  plant_ptr->errors |= E_INVALID_SPECIES;
-	  error_count += 1;
-	  continue;
+		hg[k] = ( tht[k] <= 0.5 ) ? 0.20 : ( ( tht[k] + hg[k] <= 0.5 ) ? 0.0 : hg[k] );
 	}
 
-      /* only fill in missing values for stocked plots */
-      if( is_non_stocked( c_ptr ) )
+}
+
+
+/********************************************************************************/
+/*                  swo_hybrid_calc_d6_growth_batch                             */
+/********************************************************************************/
+/*  Description :   swo_hybrid_calc_d6_growth for each plant in a batch         */
+/*  Returns     :   void                                                        */
+/*  Comments    :   reads the height growth from the batch                      */
+/********************************************************************************/
+SIMD_CLONES static void swo_hybrid_calc_d6_growth_batch(
+	unsigned long       *return_code,
+	struct GROWTH_BATCH *batch_ptr,
+	double              h20_holding_capacity,
+	double              *coeffs_ptr,
+	unsigned long       plant_type )
+{
+
+	unsigned long   k;
+	unsigned long   n;
+	double          *hg;
+	double          *dg;
+	double          sum_cat;
+	double          temp_cat_total;
+	double          temp_dg;
+	double          pow_hg[GROWTH_BATCH_SIZE];
+	double          pow_cw[GROWTH_BATCH_SIZE];
+	double          exp_term[GROWTH_BATCH_SIZE];
+
+	*return_code = CONIFERS_SUCCESS;
+
+	if( coeffs_ptr == NULL )
 	{
-	  continue;
+		*return_code = CONIFERS_ERROR;
+		return;
 	}
 
-      /* if the stem is all below d6  */
-      if( plant_ptr->tht < 0.50 && !is_non_stocked( c_ptr ) )
-	{        
-	  plant_ptr->errors |= E_INVALID_HEIGHT;
-	  error_count += 1;
+	n  = batch_ptr->n;
+	hg = batch_ptr->tht_growth;
+	dg = batch_ptr->d6_growth;
+
+	for( k = 0; k < n; k++ )
+	{
+		if( batch_ptr->crown_width[k] <= 0.0 )
+		{
+			*return_code = INVALID_INPUT_VAL;
+			return;
+		}
 	}
 
-      /* if the total height <= 4.5 and there's a dbh obs */
-      /* this error triggers on plants that are exactly 4.5 feet tall */
-	/* and have a positive dbh observation                          */
-	if( plant_ptr->tht < 4.5 && plant_ptr->dbh > 0.0 )
-	  {
-	    plant_ptr->errors |= E_INVALID_DBH;
-	    error_count += 1;
-	  }
-
-	/* if it's a tree with a dbh obs */
-	if(!is_tree( c_ptr) && plant_ptr->dbh > 0.0)
-	  {
-	    plant_ptr->errors |= E_INVALID_DBH;
-	    error_count += 1;
-	  }
-
-
-	/* if the plant doesn't have a dbh, fill that in    */ 
-	/* if the stem is between 6" and 4.5 feet tall      */
-	if( plant_ptr->tht >= 0.50 )
-	  {
-	    if( is_tree( c_ptr ) )
-	      {
-		if( plant_ptr->d6 == 0.0 )
-		  {
-		    if(plant_ptr->dbh > 0.0 && plant_ptr->tht >4.5)
-		      {
-			*return_code = CONIFERS_SUCCESS;
-			
-			      swo_hybrid_calc_d6_from_ht_and_dbh(return_code,
-								 plant_ptr->tht,
-								 plant_ptr->dbh,
-								 &plant_ptr->d6,
-								 c_ptr->d6_ht_dbh);
-			    
-			    if( *return_code != CONIFERS_SUCCESS)
-			      {
-				    plant_ptr->errors |= E_INVALID_D6;
-				    error_count += 1;
-			      }
-		      }
-		    else
-		      {
-		          /* if the dbh != 0 and tht < 4.5? */
-			    *return_code = CONIFERS_SUCCESS;
-
-			      swo_hybrid_calc_d6_from_total_height(  return_code, 
-								     plant_ptr->tht, 
-								     &plant_ptr->d6, 
-								     c_ptr->d6_ht);
-			    
-			    if( *return_code != CONIFERS_SUCCESS)
-			      {
-				plant_ptr->errors |= E_INVALID_D6;
-				error_count += 1;
-			      }
-		      }
-		  }
-
-
-          /* this is the code for computing the missing dbh when the tree */
-          /* is taller than 4.5 feet                                        */
-          /* if the plant record has a missing d12 and the total height is > 30 CM */
-          /* this only applies to the CONIFERS_CIPS variant */
-		if( plant_ptr->d12 == 0.0 && plant_ptr->tht > ( 30.0 * CM2FT ) )
+	if( plant_type == CONIFER || plant_type == HARDWOOD )
+	{
+		batch_pow( n, hg, coeffs_ptr[1], pow_hg );
+		batch_pow( n, batch_ptr->crown_width, coeffs_ptr[6], pow_cw );
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+		for( k = 0; k < n; k++ )
 		{
-		    *return_code = CONIFERS_SUCCESS;
-            
-            //switch (variant)
-			//{
-			//    case CONIFERS_CIPS:
-            //        plot_ptr = get_plot( plant_ptr->plot, n_points, plots_ptr );
-            //        cips_calc_d12_from_ht_and_veg_cov(  return_code,
-			//                    plant_ptr->tht,
-			//                    plot_ptr->shrub_pct_cover,
-			//                    &plant_ptr->d12,
-			//                    c_ptr->dbh_ht_veg_cov );
-            //        break;
-			//	    
-            //    default:
-            //        break;
-            //} 
-        }
+			exp_term[k] =  coeffs_ptr[0]
+			            +  coeffs_ptr[2] * pow_cw[k]
+			            +  coeffs_ptr[3] * batch_ptr->d6[k]
+			            +  coeffs_ptr[4] * (batch_ptr->cat_c[k]/SQ_FT_PER_ACRE)*(batch_ptr->cat_c[k]/SQ_FT_PER_ACRE)
+			            +  coeffs_ptr[5] * ( (batch_ptr->cat_h[k]/SQ_FT_PER_ACRE)*(batch_ptr->cat_h[k]/SQ_FT_PER_ACRE)
+			                               + (batch_ptr->cat_s[k]/SQ_FT_PER_ACRE)*(batch_ptr->cat_s[k]/SQ_FT_PER_ACRE) );
+		}
 
-          /* this is the code for computing the missing dbh when the tree */
-          /* is taller than 4.5 feet                                        */
-		if( plant_ptr->d6 > 0.0 && plant_ptr->dbh == 0.0 && plant_ptr->tht > 4.5)
-		  {
-		    *return_code = CONIFERS_SUCCESS;
-		    
-			  swo_hybrid_calc_dbh_from_height_and_d6(return_code,
-								 plant_ptr->d6,
-								 plant_ptr->tht,
-								 &plant_ptr->dbh,
-								 c_ptr->d6_ht_dbh);
-			
-			if( *return_code != CONIFERS_SUCCESS)
-			  {
-			    plant_ptr->errors |= E_INVALID_DBH;
-			    error_count += 1;
-			  }
-        }
+		batch_exp( n, exp_term, exp_term );
 
-		if(plant_ptr->expf <=0.0 && fixed_plot_radius > 0.0  )
-		  {
-		    if( plant_ptr->errors & E_INVALID_DBH)
-		      {
-			plant_ptr->expf = 0;
-			plant_ptr->errors |= E_INVALID_EXPF;
-			error_count += 1;
-		      }
-		    else if( plant_ptr->dbh > min_dbh )
-		      {
-			plant_ptr->expf = baf / (plant_ptr->dbh * plant_ptr->dbh * FC_I);
-		      }
-		    else
-		      {
-			plant_ptr->expf = SQ_FT_PER_ACRE / 
-			  ( fixed_plot_radius * fixed_plot_radius * MY_PI );
-		      }            
-
-		    /* multiply the expansion factor by the number of   */
-		    /* stems that this plant record represents          */
-		    plant_ptr->expf *= plant_ptr->n_stems;
-		  }
-	      }
-
-            /* if the plant is a shrub, then compute the d6 if it's missing */
-	      if( is_shrub( c_ptr ) )
+#ifdef _OPENMP
+#pragma omp simd private( temp_dg )
+#endif
+		for( k = 0; k < n; k++ )
 		{
-		  if( plant_ptr->d6 == 0.0 )
-		    {
-		      /* compute the d6 from the height */
-		      *return_code = CONIFERS_SUCCESS;
-		      
-			    swo_hybrid_calc_d6_from_total_height(  return_code, 
-								   plant_ptr->tht, 
-								   &plant_ptr->d6, 
-								   c_ptr->d6_ht);
-			  
-			  if( *return_code != CONIFERS_SUCCESS)
-			    {
-			      plant_ptr->errors |= E_INVALID_D6;
-			      error_count += 1; 
-			    }
-		    }
+			temp_dg = pow_hg[k] * exp_term[k];
 
+			dg[k] = ( hg[k] <= 0.0 || temp_dg < 0.0 ) ? 0.0 : temp_dg;
 		}
+	}
+	else if( plant_type == SHRUB || plant_type == FORB )
+	{
+#ifdef _OPENMP
+#pragma omp simd private( sum_cat, temp_cat_total, temp_dg )
+#endif
+		for( k = 0; k < n; k++ )
+		{
+			sum_cat        = batch_ptr->cat_s[k] + batch_ptr->cat_c[k] + batch_ptr->cat_h[k];
+			temp_cat_total = ( sum_cat <= 0.0 ) ? 0.01 : sum_cat/SQ_FT_PER_ACRE;
 
-	  }
+			temp_dg =    (  coeffs_ptr[0]
+			              + coeffs_ptr[1] * hg[k] *2
+			              + coeffs_ptr[2] * batch_ptr->tht[k]
+			              + coeffs_ptr[3] / (sqrt( temp_cat_total) )
+			              + coeffs_ptr[4] * h20_holding_capacity) / 2.0;
 
-	/* fill in the remaining values */
-	plant_ptr->d6_area      = plant_ptr->d6 * plant_ptr->d6 * FC_I;
-	plant_ptr->basal_area   = plant_ptr->dbh * plant_ptr->dbh * FC_I;
-    plant_ptr->d12_area      = plant_ptr->d12 * plant_ptr->d12 * FC_I;
-	    
+			dg[k] = ( hg[k] <= 0.0 || temp_dg < 0.0 ) ? 0.0 : temp_dg;
+		}
+	}
+	else
+	{
+		for( k = 0; k < n; k++ )
+		{
+			dg[k] = 0.0;
+		}
+	}
 
-	    /* now calculate the crown width for the plant record */
-	    if( plant_ptr->crown_width <= 0.0 )
-	      {
-		*return_code = CONIFERS_SUCCESS;
-		
-		      swo_hybrid_calc_crown_width(   return_code,
-						     plant_ptr->d6_area,
-						     plant_ptr->tht,
-						     &plant_ptr->crown_width,
-						     &plant_ptr->crown_area,
-						     c_ptr->crown_width );
-		    
-		    if( *return_code != CONIFERS_SUCCESS)
-		      {
-			plant_ptr->errors |= E_INVALID_CW;
-			error_count += 1;
-		      }
-	      }
-
-	    /*  MOD033  */
-	    /* this should happen no matter what... */
-	    plant_ptr->crown_area = plant_ptr->crown_width * plant_ptr->crown_width * MY_PI / 4.0;
-
-	    /* fill in the expansion factors for those plant records    */
-	    /* that don't have one filled in by using the sample        */
-	    /* design records. Mostly, shrubs will have the expf filled */
-	    /* by calling this function, but it should work for trees   */
-	    if( plant_ptr->expf <= 0.0 )
-	      {
-		
-		    swo_hybrid_calc_exp_from_cover_and_ca( return_code,
-							   plant_ptr->pct_cover,
-							   plant_ptr->crown_area,
-							   &plant_ptr->expf );
+}
 
-            if( *return_code != CONIFERS_SUCCESS)
-		    {
-		      plant_ptr->errors |= E_INVALID_EXPF;
-		      error_count += 1;
-		    }
 
-	      }
-    
-    }
+/********************************************************************************/
+/*                  swo_hybrid_calc_cw_growth_batch                             */
+/********************************************************************************/
+/*  Description :   swo_hybrid_calc_cw_growth for each plant in a batch         */
+/*  Returns     :   void                                                        */
+/*  Comments    :   reads the height growth from the batch. the shrub equation  */
+/*                  is turned off in this variant, so shrubs don't grow crown   */
+/********************************************************************************/
+SIMD_CLONES static void swo_hybrid_calc_cw_growth_batch(
+	unsigned long       *return_code,
+	struct GROWTH_BATCH *batch_ptr,
+	double              ca_conifers,
+	double              ca_hardwoods,
+	double              ca_shrubs,
+	double              *coeffs_ptr,
+	unsigned long       plant_type )
+{
 
-  calc_plot_stats_2(    return_code, 
-			n_species,
-			species_ptr,
-			n_coeffs,
-			coeffs_ptr,
-			n_plants,
-			plants_ptr,
-			n_points,
-			plots_ptr );
-
-    /* todo: need_error_trap_here */
-
-    /* SECOND PASS */
-    /* The second pass is required becuase the crown values are */
-    /* dependent on the basic plot summary statistics which are */
-    /* calculated for the plot before hand                      */
-    /* now make the second pass */
-    //error_count  = 0;
-    plant_ptr = &plants_ptr[0];
-    for( i = 0; i < n_plants; i++, plant_ptr++ )
-      {
+	unsigned long   k;
+	unsigned long   n;
+	double          *hg;
+	double          *cwg;
+	double          temp_cwg;
+	double          pow_hg[GROWTH_BATCH_SIZE];
 
-	c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
+	*return_code = CONIFERS_SUCCESS;
+
+	if( coeffs_ptr == NULL )
+	{
+		*return_code = INVALID_COEFF;
+		return;
+	}
 
+	if( ca_conifers < 0.0 || ca_hardwoods < 0.0 || ca_shrubs < 0.0 )
+	{
+		*return_code = INVALID_INPUT_VAL;
+		return;
+	}
 
-	/* don't go any further if you don't have a functional species code */
-	if( c_ptr == NULL )
-	  {
-	    continue;
-	  }
+	n   = batch_ptr->n;
+	hg  = batch_ptr->tht_growth;
+	cwg = batch_ptr->cw_growth;
 
-	/* set the pointer for the current plot that the plant is on */
-	//plot_ptr = get_plot( plant_ptr->plot, n_points, plots_ptr );
-  // this appears to be cruft removed on jan 2014 mwr;
-        
-	/* fill in the percent cover for the plant recor */
-	if( plant_ptr->pct_cover == 0.0)  /* fill in percent cover */
-	  {
-	    plant_ptr->pct_cover = 100.0 * plant_ptr->expf * plant_ptr->crown_area / SQ_FT_PER_ACRE;
-	  }
-
-	/* if the crown ratio is invalid or missing     */
-	/* fill in the crown ratio for the plant record */
-	if( is_tree( c_ptr ) )
-	  {
-	    if( plant_ptr->cr <= 0.0 || plant_ptr->cr > 1.0 )
-	      {
-
-		        //get_in_taller_attribs( plant_ptr, plot_ptr, bait, cait );
-		        //cait_c       =   cait[CONIFER];
-		        //cait_h       =   cait[HARDWOOD];
-		        //cait_s       =   cait[SHRUB];
-		        //*return_code = CONIFERS_SUCCESS;
-
-		      swo_hybrid_calc_crown_ratio(return_code,  
-						  plant_ptr->tht,
-						  plant_ptr->d6,
-						  &plant_ptr->cr,
-						  c_ptr->crown_ratio);
-	      }                              
-	  }
-
-	if( *return_code != CONIFERS_SUCCESS)
-	  {
-	    plant_ptr->errors |= E_INVALID_CR;
-	    error_count += 1;
-	  }
-
-	plant_ptr->max_crown_width = 0.0;
-
-	/*  MOD014 */
-	  /* if it's a tree, compute the crown width */
-	  if( is_tree( c_ptr ) )
-	    {
-	      *return_code = CONIFERS_SUCCESS;
-	      
-		    swo_hybrid_calc_max_crown_width(  return_code,
-						      plant_ptr->dbh,
-						      plant_ptr->tht,
-						      &plant_ptr->max_crown_width,
-						      c_ptr->max_crown_width);
-     
-		  if( *return_code != CONIFERS_SUCCESS)
-		    {
-		      plant_ptr->errors |= E_INVALID_MCW;   
-		      error_count += 1;
-		    }
-	    }
-      }
-   
-    if (error_count > 0)
-      {
-	*return_code = FILL_VALUES_ERROR;
-	return;
-      }
-    *return_code = CONIFERS_SUCCESS;
+	for( k = 0; k < n; k++ )
+	{
+		if( batch_ptr->crown_width[k] <= 0.0 )
+		{
+			*return_code = INVALID_INPUT_VAL;
+			return;
+		}
+	}
+
+	if( plant_type == CONIFER || plant_type == HARDWOOD )
+	{
+		batch_pow( n, hg, coeffs_ptr[1], pow_hg );
+
+#ifdef _OPENMP
+#pragma omp simd private( temp_cwg )
+#endif
+		for( k = 0; k < n; k++ )
+		{
+			temp_cwg = ( coeffs_ptr[0] + coeffs_ptr[2] * sqrt( batch_ptr->crown_width[k] ) ) * pow_hg[k];
+
+			cwg[k] = ( hg[k] < 0.0 || temp_cwg < 0.0 ) ? 0.0 : temp_cwg;
+		}
+	}
+	else
+	{
+		for( k = 0; k < n; k++ )
+		{
+			cwg[k] = 0.0;
+		}
+	}
 
 }
 
@@ -685,6 +734,8 @@ void swohybrid_impute(
 /*                  struct COEFFS_RECORD *coeffs_ptr - array of coefficients    */
 /*                      that are used to project the individual plants on the   */
 /*                      plot.                                                   */
+/*                  struct RANDOM_STREAM *rand_stream - the random deviates for */
+/*                      the plant in the current year (see sample.c)            */
 /********************************************************************************/
 void swo_hybrid_project_plant(  
    unsigned long           *return_code,
@@ -697,7 +748,8 @@ void swo_hybrid_project_plant(
    unsigned long           endemic_mortality,  
    int                     hcb_growth_on,      
    unsigned long           use_precip_in_hg,   
-   unsigned long           use_rand_err )
+   unsigned long           use_rand_err,
+   struct RANDOM_STREAM    *rand_stream )
 {
 
    struct COEFFS_RECORD    *c_ptr;
@@ -739,9 +791,9 @@ void swo_hybrid_project_plant(
 
    /* get a uniform deviate for the browse */
    /* and one for the top damage           */
-   normal                  = (double)gauss_dev();  
-   browse_random_unif_0_1  = uniform_0_1();
-   top_dam_random_unif_0_1 = uniform_0_1();
+   normal                  = stream_gauss_dev( rand_stream );  
+   browse_random_unif_0_1  = stream_uniform_0_1( rand_stream );
+   top_dam_random_unif_0_1 = stream_uniform_0_1( rand_stream );
 
    /* calc the height growth...        */
    /* calc diam growth...              */
@@ -817,13 +869,9 @@ void swo_hybrid_project_plant(
 			                use_precip_in_hg,     
 
 							/* added arguments for the hybrid model */
-			                species_ptr[plant_ptr->sp_idx].min_temp,
-			                species_ptr[plant_ptr->sp_idx].max_temp,
-			                species_ptr[plant_ptr->sp_idx].opt_temp,
-							
-							/* added plot level args for the radiation */
-							plot_ptr->mean_monthly_temp,
-			                plot_ptr->solar_radiation,
+							/* the SRT only depends on the species and	*/
+							/* the plot, so it's kept on the plot		*/
+			                swo_hybrid_get_srt( plot_ptr, species_ptr, plant_ptr->sp_idx ),
 
 			                &plant_ptr->tht_growth,
 			                c_ptr->ht_growth,
@@ -895,7 +943,7 @@ void swo_hybrid_project_plant(
 			            plot_ptr->ca_c,
 			            plot_ptr->ca_h,
 			            plot_ptr->ca_s,
-			            uniform_0_1(),
+			            stream_uniform_0_1( rand_stream ),
 			            &plant_ptr->cr_growth,
 			            c_ptr->cr_growth);
 
@@ -941,7 +989,7 @@ void swo_hybrid_project_plant(
 				        plot_ptr->ca_h,
 					    plot_ptr->ca_s,
 					    cat_c,
-				        uniform_0_1(),
+				        stream_uniform_0_1( rand_stream ),
 				        &plant_ptr->cw_growth,
 					    c_ptr->cw_growth,
                         c_ptr->type);
@@ -972,6 +1020,246 @@ void swo_hybrid_project_plant(
 }
 
 
+/********************************************************************************/
+/* swo_hybrid_project_plot                                                      */
+/********************************************************************************/
+/*  Description :   projects all the plants on the plot forward one year with   */
+/*                  the CONIFERS_SWOHYBRID equations                            */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the plants are grown in batches that share a functional     */
+/*                  species, see project_plot_in_batches. the SRT values are    */
+/*                  worked out once per species as the plot's plants are grown  */
+/*  Arguments   :   see VARIANT_RECORD project_plot in conifers.h               */
+/********************************************************************************/
+void swo_hybrid_project_plot(
+   unsigned long           *return_code,
+   struct PLANT_RECORD     *plants_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   unsigned long           n_species,
+   struct SPECIES_RECORD   *species_ptr,
+   unsigned long           n_coeffs,
+   struct COEFFS_RECORD    *coeffs_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err,
+   struct SUMMARY_RECORD   *before_sums,
+   unsigned long           use_genetic_gains,
+   unsigned long           plantation_age,
+   unsigned long           yrst,
+   unsigned long           *n_years_projected )
+{
+
+   plot_ptr->n_srt = 0;
+
+   project_plot_in_batches( return_code,
+                            plants_ptr,
+                            plot_ptr,
+                            species_ptr,
+                            n_coeffs,
+                            coeffs_ptr,
+                            endemic_mortality,
+                            hcb_growth_on,
+                            use_precip_in_hg,
+                            use_rand_err,
+                            plantation_age,
+                            swo_hybrid_project_plant_batch );
+
+}
+
+
+/********************************************************************************/
+/* swo_hybrid_project_plant_batch                                               */
+/********************************************************************************/
+/*  Description :   projects a batch of plants that share a functional species  */
+/*                  forward one year, same as calling swo_hybrid_project_plant  */
+/*                  for each plant in the batch                                 */
+/*  Returns     :   void                                                        */
+/*  Comments    :   see swo_project_plant_batch for how the results compare     */
+/*                  with the scalar path                                        */
+/*  Arguments   :   same as swo_project_plant_batch                             */
+/********************************************************************************/
+void swo_hybrid_project_plant_batch(
+   unsigned long           *return_code,
+   struct SPECIES_RECORD   *species_ptr,
+   struct PLOT_RECORD      *plot_ptr,
+   struct GROWTH_BATCH     *batch_ptr,
+   unsigned long           endemic_mortality,
+   int                     hcb_growth_on,
+   unsigned long           use_precip_in_hg,
+   unsigned long           use_rand_err )
+{
+
+   unsigned long           k;
+   unsigned long           tree;
+   unsigned long           shrub;
+   struct COEFFS_RECORD    *c_ptr;
+   struct PLANT_RECORD     *plant_ptr;
+
+   double  bait[PLANT_TYPES];
+   double  cait[PLANT_TYPES];
+
+   *return_code = CONIFERS_SUCCESS;
+
+   c_ptr = batch_ptr->c_ptr;
+   if( c_ptr == NULL )
+   {
+      *return_code = CONIFERS_ERROR;
+      return;
+   }
+
+   tree  = is_tree( c_ptr );
+   shrub = is_shrub( c_ptr );
+
+   for( k = 0; k < batch_ptr->n; k++ )
+   {
+      batch_ptr->tht_growth[k]    = 0.0;
+      batch_ptr->d6_growth[k]     = 0.0;
+      batch_ptr->dbh_growth[k]    = 0.0;
+      batch_ptr->cr_growth[k]     = 0.0;
+      batch_ptr->cw_growth[k]     = 0.0;
+   }
+
+   /* forbs and non stocked records don't grow, they skip the */
+   /* deviates and the equations and only get the mortality   */
+   if( tree || shrub )
+   {
+      /* the deviates for the whole batch are drawn at once, in  */
+      /* the same order swo_hybrid_project_plant draws them */
+      fill_growth_batch_deviates( batch_ptr, tree, shrub );
+
+      /* load the batch */
+      for( k = 0; k < batch_ptr->n; k++ )
+      {
+         plant_ptr  = batch_ptr->plant_ptr[k];
+
+         get_in_taller_attribs( plant_ptr, plot_ptr, bait, cait );
+         batch_ptr->cat_c[k]         = cait[CONIFER];
+         batch_ptr->cat_h[k]         = cait[HARDWOOD];
+         batch_ptr->cat_s[k]         = cait[SHRUB];
+
+         batch_ptr->tht[k]           = plant_ptr->tht;
+         batch_ptr->cr[k]            = plant_ptr->cr;
+         batch_ptr->d6[k]            = plant_ptr->d6;
+         batch_ptr->dbh[k]           = plant_ptr->dbh;
+         batch_ptr->crown_width[k]   = plant_ptr->crown_width;
+         batch_ptr->prob_browse[k]   = species_ptr[plant_ptr->sp_idx].browse_damage;
+         batch_ptr->prob_top_damage[k] = species_ptr[plant_ptr->sp_idx].mechanical_damage;
+         batch_ptr->srt[k]           = swo_hybrid_get_srt( plot_ptr, species_ptr, plant_ptr->sp_idx );
+      }
+   }
+
+   if( tree || shrub )
+   {
+      /* the random error isn't used by the swohybrid height growth */
+      swo_hybrid_calc_height_growth_batch( return_code,
+                                           batch_ptr,
+                                           plot_ptr->growing_season_precip,
+                                           plot_ptr->water_capacity,
+                                           plot_ptr->ca_h,
+                                           plot_ptr->ca_s,
+                                           c_ptr->ht_growth,
+                                           c_ptr->type );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+
+      swo_hybrid_calc_d6_growth_batch( return_code,
+                                       batch_ptr,
+                                       plot_ptr->water_capacity,
+                                       c_ptr->d6_growth,
+                                       c_ptr->type );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+   }
+
+   if( tree )
+   {
+      /* the dbh and cr growth equations are the same as the swo ones */
+      swo_calc_dbh_growth_batch( return_code,
+                                 batch_ptr,
+                                 c_ptr->dbh_growth );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+
+      swo_calc_cr_growth_batch( return_code,
+                                batch_ptr,
+                                hcb_growth_on,
+                                plot_ptr->ca_c,
+                                plot_ptr->ca_h,
+                                plot_ptr->ca_s,
+                                c_ptr->cr_growth );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+
+      for( k = 0; k < batch_ptr->n; k++ )
+      {
+         plant_ptr = batch_ptr->plant_ptr[k];
+         swo_hybrid_calc_max_crown_width( return_code,
+                                          batch_ptr->dbh[k] + batch_ptr->dbh_growth[k],
+                                          batch_ptr->tht[k] + batch_ptr->tht_growth[k],
+                                          &plant_ptr->max_crown_width,
+                                          c_ptr->max_crown_width );
+         if( *return_code != CONIFERS_SUCCESS )
+         {
+            return;
+         }
+      }
+   }
+
+   if( tree || shrub )
+   {
+      swo_hybrid_calc_cw_growth_batch( return_code,
+                                       batch_ptr,
+                                       plot_ptr->ca_c,
+                                       plot_ptr->ca_h,
+                                       plot_ptr->ca_s,
+                                       c_ptr->cw_growth,
+                                       c_ptr->type );
+      if( *return_code != CONIFERS_SUCCESS )
+      {
+         return;
+      }
+   }
+
+   /* copy the growth back to the plant records */
+   for( k = 0; k < batch_ptr->n; k++ )
+   {
+      plant_ptr = batch_ptr->plant_ptr[k];
+
+      plant_ptr->tht_growth   = batch_ptr->tht_growth[k];
+      plant_ptr->d6_growth    = batch_ptr->d6_growth[k];
+      plant_ptr->d12_growth   = 0.0;
+      plant_ptr->cw_growth    = batch_ptr->cw_growth[k];
+      plant_ptr->cr_growth    = batch_ptr->cr_growth[k];
+      plant_ptr->dbh_growth   = batch_ptr->dbh_growth[k];
+      plant_ptr->expf_change  = 0.0;
+
+      if( endemic_mortality == 1 )
+      {
+         swo_hybrid_calc_endemic_mortality( return_code,
+                                            plant_ptr->expf,
+                                            &plant_ptr->expf_change,
+                                            &species_ptr[plant_ptr->sp_idx].endemic_mortality );
+         if( *return_code != CONIFERS_SUCCESS )
+         {
+            return;
+         }
+      }
+   }
+
+   *return_code = CONIFERS_SUCCESS;
+
+}
+
+
 
 /********************************************************************************/
 /*                  calc_crown_width     S1                                     */
@@ -2261,11 +2549,8 @@ void swo_hybrid_calc_d6_growth(
 /*  double         catcon			- crown area in taller in conifers (ft^2)	*/
 /*  double         cathwsh			- crown area in taller hardwds+shrubs (ft^2)*/
 
-/*  double         min_temp			- min temp for phtotosynthasis				*/
-/*  double         max_temp			- max temp for phtotosynthasis				*/
-/*  double         opt_temp			- opt temp for phtotosynthasis				*/
-/*  double         tday_c			- vector total number of growing days (above C)	*/
-/*  double         srad				- vector solar radation						*/
+/*  double         srt              - solar radiation temperature modifier,     */
+/*                                     see swo_hybrid_get_srt()                 */
 /*  double         *pred_dbh_growth - predicted dbh growth (inches)             */
 /*  vector<double> *coeffs_ptr      -   pointer to a vector of doubles that     */
 /*                                      contain the coefficients for the        */
@@ -2413,11 +2698,7 @@ void swo_hybrid_calc_height_growth(
     double          prob_top_damage,
     unsigned long   use_precip, 
     
-	double			min_temp,		/* species specific minumum temperature, in C	*/
-	double			max_temp,		/* species specific maximum temperature, in C	*/
-	double			opt_temp,		/* species specific optimal temperature, in C	*/
-	double			*tday_c,		/* tday_c is a vector of monthly temps, in C	*/
-	double			*srad,			/* solar radiation */
+	double			srt,			/* solar radiation temperature modifier	*/
 
     double          *height_growth,
     double          *coeffs_ptr,
@@ -2441,18 +2722,11 @@ void swo_hybrid_calc_height_growth(
 
 	/* temp variables for development */
 	//double	monthly_temp = 20.0;
-	double	power_term;				/* another temp number	*/
-	double	t1num;					/* temp number?			*/
-	double	t2num;					/* temp number?			*/
 	//double	tday_c;					/* which is what?		*/
 	double	gspcp;					/* which is what?		*/
-	double	SRT;					/* which is what?		*/
-	double	tmod[12];					/* which is what?		*/
 	
 	//double	hcb1;  // unused removed jan 2014 mwr;
 
-	unsigned long	i;
-
 /**************************** initialize variables *******************************************************/
 	*return_code=CONIFERS_SUCCESS;
 
@@ -2503,10 +2777,6 @@ void swo_hybrid_calc_height_growth(
     broken              = 0;
     browsing            = 0;
 
-	SRT = 0.0;
-
-	memset( tmod, 0, sizeof( double ) * 12 );
-	
 
     cat = (catcon+cathw+catsh)/SQ_FT_PER_ACRE;
 
@@ -2593,34 +2863,6 @@ void swo_hybrid_calc_height_growth(
 	b11 = (double)coeffs_ptr[12] * (double)browsing;
 
 
-	/* this is a species level variable */
-	power_term = ( max_temp - opt_temp ) / ( opt_temp - min_temp );
-
-	/* loop over the months to compute the solar radiation temperature modifier. */
-	for( i = 0; i < 12; i++ )
-	    {
-
-		/* tday_c is a vector */
-		t1num = tday_c[i] - min_temp;
-		if( t1num < 0.0 )
-		    {
-			    t1num = 0.0;
-		    }
-
-		// t2numdf=tmaxdf - tday_c;  if t2numdf<0 then t2numdf=0;
-		t2num = max_temp - tday_c[i];
-		if( t2num < 0.0 )
-		    {
-			    t2num = 0.0;
-		    }
-
-		/* this is a vector??? */
-		    tmod[i] = pow( ( t1num / ( opt_temp - min_temp ) ) * ( t2num / ( max_temp - opt_temp ) ), power_term );
-
-		    SRT += srad[i] * tmod[i] / 1000.0;
-
-	    }
-
 	/* gspcp ?= growing_season_precip ?= precip				*/
 	/* input is in inches/year, model version in mm/year	*/	
 	gspcp = precip; 
@@ -2640,7 +2882,7 @@ void swo_hybrid_calc_height_growth(
 			        + a6 * ( cahw/SQ_FT_PER_ACRE )*  (cahw/SQ_FT_PER_ACRE)
                     + a7 * ( cash/SQ_FT_PER_ACRE )*( cash/SQ_FT_PER_ACRE )
 			        + a8 * log(gspcp)
-			        + a9 * ( SRT ) );
+			        + a9 * ( srt ) );
 
 
         if( (temp_growth) <= 0.0 )
@@ -2687,6 +2929,114 @@ void swo_hybrid_calc_height_growth(
 }
 
 
+/********************************************************************************/
+/*                  swo_hybrid_get_srt                                          */
+/********************************************************************************/
+/*  Description :   returns the solar radiation temperature modifier for the    */
+/*                  species on the plot                                         */
+/*  Returns     :   double                                                      */
+/*  Comments    :   the SRT only depends on the plot's monthly temperatures     */
+/*                  and solar radiation and the species' temperature limits,    */
+/*                  so the plot keeps the values it has computed while it is    */
+/*                  grown (project_plot clears them for each plot and year)     */
+/*                  instead of taking 12 pow()s for every plant                 */
+/*  Arguments   :                                                               */
+/*  struct PLOT_RECORD *plot_ptr        - the plot being grown                  */
+/*  struct SPECIES_RECORD *species_ptr  - the species array                     */
+/*  unsigned long sp_idx                - index of the plant's species          */
+/********************************************************************************/
+static double swo_hybrid_get_srt(
+	struct PLOT_RECORD      *plot_ptr,
+	struct SPECIES_RECORD   *species_ptr,
+	unsigned long           sp_idx )
+{
+
+	unsigned long	i;
+	double			srt;
+
+	for( i = 0; i < plot_ptr->n_srt; i++ )
+	{
+		if( plot_ptr->srt_sp_idx[i] == sp_idx )
+		{
+			return plot_ptr->srt[i];
+		}
+	}
+
+	srt = swo_hybrid_calc_srt(	species_ptr[sp_idx].min_temp,
+								species_ptr[sp_idx].max_temp,
+								species_ptr[sp_idx].opt_temp,
+								plot_ptr->mean_monthly_temp,
+								plot_ptr->solar_radiation );
+
+	/* plots with more species than that just recompute the rest */
+	if( plot_ptr->n_srt < SRT_CACHE_SIZE )
+	{
+		plot_ptr->srt_sp_idx[plot_ptr->n_srt]	= sp_idx;
+		plot_ptr->srt[plot_ptr->n_srt]			= srt;
+		plot_ptr->n_srt++;
+	}
+
+	return srt;
+
+}
+
+
+/* computes the solar radiation temperature modifier from the monthly */
+/* temperatures (tday_c, in C) and solar radiation (srad) for a       */
+/* species with the given min, max and optimal temperatures           */
+static double swo_hybrid_calc_srt(
+	double			min_temp,		/* species specific minumum temperature, in C	*/
+	double			max_temp,		/* species specific maximum temperature, in C	*/
+	double			opt_temp,		/* species specific optimal temperature, in C	*/
+	double			*tday_c,		/* tday_c is a vector of monthly temps, in C	*/
+	double			*srad )			/* solar radiation, vector[12]					*/
+{
+
+	double	power_term;				/* another temp number	*/
+	double	t1num;					/* temp number?			*/
+	double	t2num;					/* temp number?			*/
+	double	SRT;					/* which is what?		*/
+	double	tmod[12];					/* which is what?		*/
+
+	unsigned long	i;
+
+	SRT = 0.0;
+
+	memset( tmod, 0, sizeof( double ) * 12 );
+
+	/* this is a species level variable */
+	power_term = ( max_temp - opt_temp ) / ( opt_temp - min_temp );
+
+	/* loop over the months to compute the solar radiation temperature modifier. */
+	for( i = 0; i < 12; i++ )
+	    {
+
+		/* tday_c is a vector */
+		t1num = tday_c[i] - min_temp;
+		if( t1num < 0.0 )
+		    {
+			    t1num = 0.0;
+		    }
+
+		// t2numdf=tmaxdf - tday_c;  if t2numdf<0 then t2numdf=0;
+		t2num = max_temp - tday_c[i];
+		if( t2num < 0.0 )
+		    {
+			    t2num = 0.0;
+		    }
+
+		/* this is a vector??? */
+		    tmod[i] = pow( ( t1num / ( opt_temp - min_temp ) ) * ( t2num / ( max_temp - opt_temp ) ), power_term );
+
+		    SRT += srad[i] * tmod[i] / 1000.0;
+
+	    }
+
+	return SRT;
+
+}
+
+
 
 /********************************************************************************/
 /*                  calc_cr_growth                                              */
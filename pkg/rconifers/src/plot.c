@@ -51,6 +51,16 @@ static int compare_plots(
     const void *ptr1, 
     const void *ptr2 );
 
+static int compare_plant_sort_keys( 
+    const void *ptr1, 
+    const void *ptr2 );
+
+static unsigned long find_plot_boundary( 
+    unsigned long       plot,
+    unsigned long       n_plants,
+    struct PLANT_RECORD *plants_ptr,
+    int                 past_plot );
+
 
 /****************************************************************************/
 /* implimentation of functions                                              */
@@ -262,6 +272,78 @@ struct PLOT_RECORD *get_plot(
 }
 
 
+/* the plot, plant and original position of a plant record, */
+/* see sort_plants_by_plot_plant                             */
+struct PLANT_SORT_KEY
+{
+    unsigned long   plot;
+    unsigned long   plant;
+    unsigned long   idx;
+};
+
+static int compare_plant_sort_keys( 
+    const void *ptr1, 
+    const void *ptr2 )
+{
+    struct PLANT_SORT_KEY   *pt1_ptr;
+    struct PLANT_SORT_KEY   *pt2_ptr;
+
+    pt1_ptr = (struct PLANT_SORT_KEY*)ptr1;
+    pt2_ptr = (struct PLANT_SORT_KEY*)ptr2;
+
+    if( pt1_ptr->plot != pt2_ptr->plot )
+    {
+        return pt1_ptr->plot < pt2_ptr->plot ? -1 : 1;
+    }
+    if( pt1_ptr->plant != pt2_ptr->plant )
+    {
+        return pt1_ptr->plant < pt2_ptr->plant ? -1 : 1;
+    }
+
+    /* keep duplicate plot/plant records in their current order */
+    if( pt1_ptr->idx != pt2_ptr->idx )
+    {
+        return pt1_ptr->idx < pt2_ptr->idx ? -1 : 1;
+    }
+
+    return 0;
+}
+
+
+/* binary search of the plot sorted plant array. returns the index  */
+/* of the first plant record with a plot number >= plot, or, when   */
+/* past_plot is set, the first plant record with a plot number      */
+/* > plot. n_plants is returned when there is no such record        */
+static unsigned long find_plot_boundary( 
+    unsigned long       plot,
+    unsigned long       n_plants,
+    struct PLANT_RECORD *plants_ptr,
+    int                 past_plot )
+{
+    unsigned long   lo;
+    unsigned long   hi;
+    unsigned long   mid;
+
+    lo = 0;
+    hi = n_plants;
+    while( lo < hi )
+    {
+        mid = lo + ( hi - lo ) / 2;
+        if( plants_ptr[mid].plot < plot || 
+            ( past_plot && plants_ptr[mid].plot == plot ) )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+
 /* this function fills in the starting and ending index values  */
 /* with the starting and ending index values that correspond    */
 /* to the plot number that is passed into the function          */
@@ -277,51 +359,196 @@ void get_plant_indecies_for_plot(
     unsigned long       *n_plant_records_on_plot )
 {
 
-    unsigned long       i;
-    int                 first_record_found;
-    //int                 last_record_found;  // unused mwr jan 2014;
-    struct PLANT_RECORD *plant_ptr;
-
+    unsigned long       first_idx;
+    unsigned long       last_idx;
 
     *start_idx                  = 0;
     *end_idx                    = 0;
     *n_plant_records_on_plot    = 0;
 
-    first_record_found  = 0;
-    //last_record_found   = 0; // unused mwr jan 2014 ;
+    /* the plants are sorted by plot, so the records for the plot   */
+    /* are a contiguous block that can be found by bisection        */
+    first_idx   = find_plot_boundary( plot_ptr->plot, n_plants, plants_ptr, 0 );
+    last_idx    = find_plot_boundary( plot_ptr->plot, n_plants, plants_ptr, 1 );
 
+    if( last_idx > first_idx )
+    {
+        *start_idx                  = first_idx;
+        *end_idx                    = last_idx - 1;
+        *n_plant_records_on_plot    = last_idx - first_idx;
+        *return_code = CONIFERS_SUCCESS;
+    }
+    else
+    {
+        *return_code = CONIFERS_ERROR;
+    }
+
+}
+
+
+/********************************************************************************/
+/* build_plot_plant_index                                                       */
+/********************************************************************************/
+/*  Description :   fills in the first_plant and last_plant members of each     */
+/*                  plot with the range of plant records on the plot            */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the plant array is sorted by plot if it isn't already, and  */
+/*                  the plant records for plot_ptr are then                     */
+/*                  plants_ptr[plot_ptr->first_plant] up to, but not including, */
+/*                  plants_ptr[plot_ptr->last_plant]. plots without any plant   */
+/*                  records get an empty range. the index is only valid until   */
+/*                  the plant array is reordered, so it should be rebuilt       */
+/*                  after anything that sorts the plants across plots.          */
+/*                  project_plot, thin_plot and calc_plot_stats_2 all walk the  */
+/*                  plot ranges instead of scanning the entire plant list,      */
+/*                  so the cost of a pass over the sample is linear in the      */
+/*                  number of plants rather than plots * plants                 */
+/*  Arguments   :                                                               */
+/*  unsigned long *return_code      - return code for calling function to check */
+/*  unsigned long n_plants          - number of elements in plants_ptr          */
+/*  struct PLANT_RECORD *plants_ptr - array of plants in the sample             */
+/*  unsigned long n_points          - number of elements in the plots_ptr array */
+/*  struct PLOT_RECORD  *plots_ptr  - pointer to an array of the plots          */
+/********************************************************************************/
+void build_plot_plant_index( 
+    unsigned long       *return_code,
+    unsigned long       n_plants,
+    struct PLANT_RECORD *plants_ptr,
+    unsigned long       n_points,
+    struct PLOT_RECORD  *plots_ptr )
+{
+
+    unsigned long       i;
+    unsigned long       first_plant;
+    unsigned long       last_plant;
+    struct PLOT_RECORD  *plot_ptr;
+    struct PLANT_RECORD *plant_ptr;
+
+    /* only sort the plant list if it's out of plot order */
     plant_ptr = &plants_ptr[0];
-    for( i = 0; i < n_plants; i++, plant_ptr++ )
+    for( i = 1; i < n_plants; i++, plant_ptr++ )
     {
-        
-        /* if you've got a plant on the plot    */
-        /* add on to the number of plants on    */
-        /* the plot                             */
-        if( plant_ptr->plot == plot_ptr->plot )
+        if( plant_ptr->plot > plant_ptr[1].plot )
         {
-            if( first_record_found == 0 )
+            sort_plants_by_plot_plant( return_code, n_plants, plants_ptr );
+            if( *return_code != CONIFERS_SUCCESS )
             {
-                *start_idx          = i;
-                first_record_found  = 1;
+                return;
             }
+            break;
+        }
+    }
 
-            (*n_plant_records_on_plot)++;
+    plot_ptr = &plots_ptr[0];
+    for( i = 0; i < n_points; i++, plot_ptr++ )
+    {
+        first_plant = find_plot_boundary( plot_ptr->plot, 
+                                          n_plants, 
+                                          plants_ptr, 
+                                          0 );
+        last_plant  = find_plot_boundary( plot_ptr->plot, 
+                                          n_plants, 
+                                          plants_ptr, 
+                                          1 );
+
+        /* plants were added or removed, so the plot totals are stale */
+        if( first_plant != plot_ptr->first_plant || 
+            last_plant != plot_ptr->last_plant )
+        {
+            plot_ptr->aggregates_current = 0;
         }
-    
-    }    
 
-    /* since end_idx is an unsigned long it is possible that the    */
-    /* value can overflow and this should be fixed!                 */
-    if( *start_idx + (*n_plant_records_on_plot) > 0 )
+        plot_ptr->first_plant   = first_plant;
+        plot_ptr->last_plant    = last_plant;
+    }
+
+    *return_code = CONIFERS_SUCCESS;
+
+}
+
+
+/********************************************************************************/
+/* sort_plants_by_plot_plant                                                    */
+/********************************************************************************/
+/*  Description :   sorts the plant array by plot and plant, if it isn't        */
+/*                  sorted already                                              */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the plant list stays in plot/plant order from one year to   */
+/*                  the next unless something (thinning) reorders it, so the    */
+/*                  check is usually all that happens. when the list does need  */
+/*                  sorting, the keys are sorted instead of the records, and    */
+/*                  each record is then moved once into its place. records      */
+/*                  with the same plot and plant keep their order               */
+/*  Arguments   :                                                               */
+/*  unsigned long *return_code      - return code for calling function to check */
+/*  unsigned long n_plants          - number of elements in plants_ptr          */
+/*  struct PLANT_RECORD *plants_ptr - array of plants in the sample             */
+/********************************************************************************/
+void sort_plants_by_plot_plant( 
+    unsigned long       *return_code,
+    unsigned long       n_plants,
+    struct PLANT_RECORD *plants_ptr )
+{
+
+    unsigned long           i;
+    struct PLANT_RECORD     *plant_ptr;
+    struct PLANT_RECORD     *sorted_ptr;
+    struct PLANT_SORT_KEY   *keys_ptr;
+    struct PLANT_SORT_KEY   *key_ptr;
+
+    *return_code = CONIFERS_SUCCESS;
+
+    /* nothing to do if the list is already in order */
+    plant_ptr = &plants_ptr[0];
+    for( i = 1; i < n_plants; i++, plant_ptr++ )
     {
-        *end_idx = *start_idx + (*n_plant_records_on_plot) - 1;
-        *return_code = CONIFERS_SUCCESS;
+        if( plant_ptr->plot > plant_ptr[1].plot ||
+            ( plant_ptr->plot == plant_ptr[1].plot && 
+              plant_ptr->plant > plant_ptr[1].plant ) )
+        {
+            break;
+        }
     }
-    else
+
+    if( i >= n_plants )
     {
-        *return_code = CONIFERS_ERROR;
+        return;
+    }
+
+    keys_ptr   = (struct PLANT_SORT_KEY *)malloc( n_plants * sizeof( struct PLANT_SORT_KEY ) );
+    sorted_ptr = (struct PLANT_RECORD *)malloc( n_plants * sizeof( struct PLANT_RECORD ) );
+    if( keys_ptr == NULL || sorted_ptr == NULL )
+    {
+        free( keys_ptr );
+        free( sorted_ptr );
+        *return_code = FAILED_MEMORY_ALLOC;
+        return;
+    }
+
+    plant_ptr = &plants_ptr[0];
+    key_ptr   = &keys_ptr[0];
+    for( i = 0; i < n_plants; i++, plant_ptr++, key_ptr++ )
+    {
+        key_ptr->plot   = plant_ptr->plot;
+        key_ptr->plant  = plant_ptr->plant;
+        key_ptr->idx    = i;
     }
 
+    qsort(  keys_ptr, 
+            n_plants, 
+            sizeof( struct PLANT_SORT_KEY ), 
+            compare_plant_sort_keys ); 
+
+    key_ptr = &keys_ptr[0];
+    for( i = 0; i < n_plants; i++, key_ptr++ )
+    {
+        sorted_ptr[i] = plants_ptr[key_ptr->idx];
+    }
+    memcpy( plants_ptr, sorted_ptr, n_plants * sizeof( struct PLANT_RECORD ) );
+
+    free( sorted_ptr );
+    free( keys_ptr );
+
 }
 
 
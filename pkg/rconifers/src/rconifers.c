@@ -103,6 +103,8 @@ SEXP r_project_sample( SEXP data_sexp, SEXP n_years_sexp, SEXP ctl_sexp );
 SEXP r_thin_sample( SEXP data_sexp,   SEXP ctl_sexp );
 SEXP r_impute_missing_values( SEXP data_sexp, SEXP ctl_sexp ) ;
 SEXP r_calc_max_sdi( SEXP data_sexp );
+SEXP r_calc_yields( SEXP data_sexp, SEXP per_plant_sexp );
+SEXP r_get_simd_path();
 
 /* these functions are used to convert the plots between the two interfaces */
 struct PLOT_RECORD *build_plot_array_from_sexp( SEXP plot_sexp, 
@@ -174,14 +176,18 @@ SEXP r_reseed( SEXP ctl )
    if( random_seed == 0 )
    {
       Rprintf( "Using the clock to seed the number generator\n" );
-      srand( (unsigned)time( NULL ) );
+      random_seed = (unsigned long)time( NULL );
    }
    else
    {
       Rprintf( "Seeding the random number generator with %d\n", random_seed );
-      srand( random_seed );
    }
 
+   /* seed rand() for the impute functions and the random streams */
+   /* used to project the plants                                  */
+   srand( (unsigned)random_seed );
+   set_random_seed( random_seed );
+
    INTEGER(ans)[0] = 1;
    UNPROTECT( 1 );
 
@@ -190,6 +196,20 @@ SEXP r_reseed( SEXP ctl )
 
 
 
+/* returns which version of the growth kernels the cpu uses */
+SEXP r_get_simd_path()
+{
+   SEXP ans;
+
+   PROTECT( ans = allocVector( STRSXP, 1 ) );
+   SET_STRING_ELT( ans, 0, mkChar( get_simd_path() ) );
+   UNPROTECT( 1 );
+
+   return ans;
+}
+
+
+
 /* this function initializes the coeffs */
 SEXP r_set_variant( SEXP variant_sexp )
 {
@@ -199,11 +219,8 @@ SEXP r_set_variant( SEXP variant_sexp )
 
    PROTECT(ans = allocVector(INTSXP, 1));
 
-   if( variant == CONIFERS_SWO || 
-	   variant == CONIFERS_SMC ||
-	   variant == CONIFERS_SWOHYBRID ||
-	   variant == CONIFERS_CIPS
-	   )
+   /* the variants are listed in variants.c */
+   if( variant >= 0 && find_variant( (unsigned long)variant ) != NULL )
    {
       /* the coefficients section */
       if( COEFFS_PTR )
@@ -240,24 +257,7 @@ SEXP r_set_variant( SEXP variant_sexp )
 	       N_COEFFS, variant, variant_label(variant) );
       //Rprintf( "Initialized %ld functional species coefficients for variant # %ld %s\n", N_COEFFS, variant );
       
-      switch (variant)
-      {
-	 case CONIFERS_SWO:
-	    Rprintf( "The code label for the variant is CONIFERS_SWO\n" );
-	    break;
-	 case CONIFERS_SMC:
-	    Rprintf( "The code label for the variant is CONIFERS_SMC\n" );
-	    break;
-	 case CONIFERS_SWOHYBRID:
-	    Rprintf( "The code label for the variant is CONIFERS_SWOHYBRID\n" );
-	    break;
-	 case CONIFERS_CIPS:
-	    Rprintf( "The code label for the variant is CONIFERS_CIPS\n" );
-	    break;
-	 default:
-	    Rprintf( "There is no code label for the variant you supplied\n" );
-	    break;
-      }
+      Rprintf( "The code label for the variant is %s\n", variant_label(variant) );
       
       Rprintf( "The coefficients version is %lf\n", COEFFS_VERSION );
       Rprintf( "The model version is %lf\n", MODEL_VERSION );
@@ -281,24 +281,7 @@ SEXP r_set_variant( SEXP variant_sexp )
 char *variant_label( unsigned long variant )
 {
 
-      switch (variant)
-      {
-	 case CONIFERS_SWO:
-	    return "CONIFERS_SWO";
-	    break;
-	 case CONIFERS_SMC:
-	    return "CONIFERS_SMC";
-	    break;
-	 case CONIFERS_SWOHYBRID:
-	    return "CONIFERS_SWOHYBRID";
-	    break;
-	 case CONIFERS_CIPS:
-	    return "CONIFERS_CIPS";
-	    break;
-	 default:
-	    return "CONIFERS_SWO";
-	    break;
-      }
+   return get_variant( variant )->label;
 
 }       
 
@@ -507,9 +490,11 @@ SEXP r_project_sample(
    unsigned long endemic_mort;
    unsigned long sdi_mort;
    unsigned long rand_error;
-   unsigned long rand_seed;
+   int rand_seed;
    unsigned long use_precip_in_hg = 0;
    unsigned long use_genetic_gains = 0;
+   long n_threads = 1;
+   long fast_kernels = 0;
 
    unsigned long n_plots;
    struct PLOT_RECORD *plots_ptr = NULL;
@@ -523,6 +508,7 @@ SEXP r_project_sample(
    unsigned long age = 0;
    unsigned long yrst = 0;
    unsigned long n_years_projected = 0;
+   struct SUMMARY_CACHE sums_cache;
 
 
    SEXP ret_val;
@@ -548,10 +534,36 @@ SEXP r_project_sample(
    /* intitialize the config/control variables (ctl argument) */
    rand_error  = asInteger( get_list_element( ctl_sexp, "rand.err" ) );
    rand_seed  = asInteger( get_list_element( ctl_sexp, "rand.seed" ) );
+   if( rand_seed == NA_INTEGER || rand_seed < 0 )
+   {
+      error( "rand.seed must be a non-negative integer\n" );
+   }
+
+   /* a positive seed starts the random streams from that seed, */
+   /* unless they're already using it, otherwise the seed from  */
+   /* the last call to rand.seed() is used. each projection is  */
+   /* a new run, so the replicates from a seed all differ       */
+   if( rand_seed > 0 && (unsigned long)rand_seed != get_random_seed() )
+   {
+      set_random_seed( (unsigned long)rand_seed );
+   }
+   start_random_run();
    endemic_mort = asInteger( get_list_element( ctl_sexp, "endemic.mort" ) );
    sdi_mort  = asInteger( get_list_element( ctl_sexp, "sdi.mort" ) ); 
    use_genetic_gains  = asInteger( get_list_element( ctl_sexp, "genetic.gains" ) );
 
+   /* number of threads used to project the plots, one if it's missing */
+   n_threads  = asInteger( get_list_element( ctl_sexp, "threads" ) );
+   if( n_threads < 1 )
+   {
+      n_threads = 1;
+   }
+
+   /* the polynomial exp, log and pow in the growth equations, off */
+   /* (the math library) if it's missing                           */
+   fast_kernels  = asInteger( get_list_element( ctl_sexp, "fast.kernels" ) );
+   set_fast_kernels( fast_kernels > 0 );
+
 
 /*    Rprintf( "value of x0 = %lf\n", x0 ); */
 /*    Rprintf( "value of age = %ld\n", age ); */
@@ -569,7 +581,7 @@ SEXP r_project_sample(
 /*    Rprintf( "done\n" ); */
    
       /* a check to ensure the site index values for the plots are non-zero */
-      if( current_variant == CONIFERS_SMC )
+      if( get_variant( current_variant )->requires_site_30 )
       {
 	 for( i = 0; i < n_plots; i++ )
 	 {
@@ -596,7 +608,9 @@ SEXP r_project_sample(
       }
       
 
-   /* project the sample.data for 1 year, nyrs times */
+   /* project the sample.data for 1 year, nyrs times, each year */
+   /* starts from the last year's summaries when it can         */
+   sums_cache.current = 0;
    for( i = 0; i < nyrs; i++ )
    {
         if(hcb_growth_on)
@@ -635,7 +649,9 @@ SEXP r_project_sample(
 			    use_genetic_gains,
 				age,
 				yrst,
-                &n_years_projected );
+                &n_years_projected,
+			    n_threads,
+			    &sums_cache );
 
     /*
 void __stdcall project_plant_list( 
@@ -915,8 +931,8 @@ struct PLOT_RECORD *build_plot_array_from_sexp( SEXP plot_sexp,
       plots_ptr[i].site_30 = REAL( plot_si30_sexp )[i];  //site index
 
       /* should this be a check on the minimim site index value */
-      /* only applies for CONIFERS_SMC */
-      if( current_variant == CONIFERS_SMC )
+      /* only applies for the variants that use it (CONIFERS_SMC) */
+      if( get_variant( current_variant )->requires_site_30 )
       {
 	 if( ISNA( REAL( plot_si30_sexp )[i] ) ||
 	     ISNAN( REAL( plot_si30_sexp )[i] )  ||
@@ -1524,6 +1540,13 @@ SEXP r_thin_sample(
 	   sizeof( struct SPECIES_RECORD ),
 	   compare_species_by_idx );
    
+   /* thin_plot works from the plant records for each plot */
+   build_plot_plant_index( &return_code, 
+			   n_plants, 
+			   plants_ptr, 
+			   n_plots, 
+			   plots_ptr );
+
    /* if the code is NULL, then send NULL to the function */
    /* and simply pass in the numeric values for the */
    /* thinning function */
@@ -1714,8 +1737,9 @@ SEXP r_calc_max_sdi(
 
    PROTECT(ans = allocVector(REALSXP, 1));
 
-   /* build the plots vector */
-   n_plots = length( get_list_element( data_sexp, "plots" ) );
+   /* the number of plots is the number of rows in the plots, */
+   /* not the number of columns                               */
+   n_plots = length( get_list_element( get_list_element( data_sexp, "plots" ), "plot" ) );
    plants_ptr = build_plant_array_from_sexp( 
       get_list_element( data_sexp, "plants" ), &n_plants );
 
@@ -1747,4 +1771,75 @@ SEXP r_calc_max_sdi(
 
 }
 
+
+/* returns the volume and biomass per acre for the sample, from the   */
+/* batched yields in update_total_summaries, or from the equations    */
+/* one plant at a time (calc_yields_per_plant) if per_plant is set     */
+SEXP r_calc_yields( 
+   SEXP data_sexp,
+   SEXP per_plant_sexp )
+{
+
+   unsigned long return_code;
+   unsigned long n_plots;
+   unsigned long n_plants;
+   struct PLANT_RECORD *plants_ptr;
+   struct SUMMARY_RECORD sums;
+
+   double	cfvolume4 = 0.0;
+   double	biomass = 0.0;
+
+   SEXP ans;
+
+   PROTECT(ans = allocVector(REALSXP, 2));
+
+   n_plots = length( get_list_element( get_list_element( data_sexp, "plots" ), "plot" ) );
+   plants_ptr = build_plant_array_from_sexp( 
+      get_list_element( data_sexp, "plants" ), &n_plants );
+
+   if( asLogical( per_plant_sexp ) == TRUE )
+   {
+      calc_yields_per_plant( &return_code,
+			     n_plots,
+			     n_plants,
+			     N_SPECIES,
+			     SPECIES_PTR,
+			     N_COEFFS,
+			     COEFFS_PTR,
+			     plants_ptr,
+			     &cfvolume4,
+			     &biomass );
+   }
+   else
+   {
+      update_total_summaries( &return_code,
+			      n_plots,
+			      n_plants,
+			      N_SPECIES,
+			      SPECIES_PTR,
+			      N_COEFFS,
+			      COEFFS_PTR,
+			      plants_ptr,
+			      &sums );
+      if( return_code == CONIFERS_SUCCESS )
+      {
+	 cfvolume4 = sums.cfvolume4;
+	 biomass   = sums.biomass;
+      }
+   }
+
+   if( return_code != CONIFERS_SUCCESS )
+   {
+      Rprintf( "unable to compute the yields, return_code = %ld\n", return_code );
+   }
+
+   free( plants_ptr );
+
+   REAL(ans)[0] = cfvolume4;
+   REAL(ans)[1] = biomass;
+   UNPROTECT( 1 );
+   return ans;
+
+}
+
 // you might want to put the metric conversion function in the C code and put a wrapper here.
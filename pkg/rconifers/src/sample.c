@@ -19,6 +19,13 @@
 /*  MOD005  Dec   20,2000 JDH     removed static from gaus_dev() since it's */
 /*                                  called in other functions and removed   */
 /*                                  declaration into conifers.h             */
+/*  MOD006  Oct   17,2026         replaced rand() with a counter based      */
+/*                                  generator keyed on the seed, plot,      */
+/*                                  plant, year and draw (random streams)   */
+/*  MOD007  Oct   17,2026         added the batch versions of the random    */
+/*                                  streams for the growth batches          */
+/*  MOD008  Oct   17,2026         added the run to the random stream key    */
+/*                                  so each projection gets new deviates    */
 /****************************************************************************/
 
 
@@ -36,10 +43,50 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <stdint.h>
 
 #include "conifers.h"
 
 
+/* philox 4x32 round multipliers and key increments */
+#define PHILOX_M0       0xD2511F53UL
+#define PHILOX_M1       0xCD9E8D57UL
+#define PHILOX_W0       0x9E3779B9UL
+#define PHILOX_W1       0xBB67AE85UL
+#define PHILOX_ROUNDS   10
+
+/* 2^-32, converts a 32 bit word to a uniform deviate */
+#define TWO_POW_M32     2.3283064365386963e-10
+
+static void philox_4x32( 
+    uint32_t            *ctr,
+    uint32_t            *key,
+    uint32_t            *out );
+
+static void random_stream_block( 
+    struct RANDOM_STREAM    *stream_ptr,
+    unsigned long           block,
+    uint32_t                *out );
+
+static void philox_4x32_batch( 
+    unsigned long       n,
+    uint32_t            *c0,
+    uint32_t            *c1,
+    uint32_t            *c2,
+    uint32_t            *c3,
+    uint32_t            *k0,
+    uint32_t            *k1 );
+
+/* the seed for all the random streams, and the stream that */
+/* gauss_dev() and uniform_0_1() draw from                  */
+static unsigned long        random_seed = 0;
+static struct RANDOM_STREAM global_stream = { 0, 0, 0, 0, 0, 0 };
+
+/* the number of projections started since the seed was set, so */
+/* each projection gets its own random streams                  */
+static unsigned long        random_run = 0;
+
+
 /****************************************************************************/
 /*  calc_replication_factor                                                 */
 /****************************************************************************/
@@ -277,40 +324,465 @@ struct PLANT_RECORD  *generate_duplicate_plants(
 
 
 
-/* MOD005   */
+/* MOD006   */
 /****************************************************************************/
-/* gauss_dev                                                                */
+/* philox_4x32                                                              */
 /****************************************************************************/
-/* this function returns a gaussian deviant                                 */
-/* from NRC                                                                 */
+/* the philox 4x32-10 counter based generator from Salmon et al. (2011)     */
+/* "Parallel random numbers: as easy as 1, 2, 3". each (counter, key) pair  */
+/* maps to four independent 32 bit words, so any draw can be computed       */
+/* directly without stepping through the draws that come before it          */
 /****************************************************************************/
-//static float gauss_dev()
-float gauss_dev()
+static void philox_4x32( 
+    uint32_t            *ctr,
+    uint32_t            *key,
+    uint32_t            *out )
+{
+    uint64_t    prod0;
+    uint64_t    prod1;
+    uint32_t    c[4];
+    uint32_t    k[2];
+    int         r;
+
+    c[0] = ctr[0];
+    c[1] = ctr[1];
+    c[2] = ctr[2];
+    c[3] = ctr[3];
+    k[0] = key[0];
+    k[1] = key[1];
+
+    for( r = 0; r < PHILOX_ROUNDS; r++ )
+    {
+        prod0 = (uint64_t)PHILOX_M0 * c[0];
+        prod1 = (uint64_t)PHILOX_M1 * c[2];
+
+        c[0] = (uint32_t)( prod1 >> 32 ) ^ c[1] ^ k[0];
+        c[1] = (uint32_t)prod1;
+        c[2] = (uint32_t)( prod0 >> 32 ) ^ c[3] ^ k[1];
+        c[3] = (uint32_t)prod0;
+
+        k[0] += (uint32_t)PHILOX_W0;
+        k[1] += (uint32_t)PHILOX_W1;
+    }
+
+    out[0] = c[0];
+    out[1] = c[1];
+    out[2] = c[2];
+    out[3] = c[3];
+}
+
+
+/* compute the four words for block number block of the stream  */
+/* the counter is (block, year, plant, plot) and the key is the */
+/* seed and the run, so every plant gets its own sequence of    */
+/* draws each year of each projection                           */
+static void random_stream_block( 
+    struct RANDOM_STREAM    *stream_ptr,
+    unsigned long           block,
+    uint32_t                *out )
+{
+    uint32_t    ctr[4];
+    uint32_t    key[2];
+
+    ctr[0] = (uint32_t)block;
+    ctr[1] = (uint32_t)stream_ptr->year;
+    ctr[2] = (uint32_t)stream_ptr->plant;
+    ctr[3] = (uint32_t)stream_ptr->plot;
+
+    key[0] = (uint32_t)stream_ptr->seed;
+    key[1] = (uint32_t)( ( (uint64_t)stream_ptr->seed ) >> 32 ) ^ 
+             (uint32_t)stream_ptr->run;
+
+    philox_4x32( ctr, key, out );
+}
+
+
+/****************************************************************************/
+/* set_random_seed, get_random_seed                                         */
+/****************************************************************************/
+/* sets (gets) the seed used as the key for all the random streams. setting */
+/* the seed also restarts the stream used by gauss_dev() and uniform_0_1()  */
+/* and the count of runs (see start_random_run)                             */
+/****************************************************************************/
+void set_random_seed( unsigned long seed )
+{
+    random_seed = seed;
+    random_run  = 0;
+    init_random_stream( &global_stream, seed, 0, 0, 0, 0 );
+}
+
+unsigned long get_random_seed( void )
+{
+    return random_seed;
+}
+
+
+/****************************************************************************/
+/* start_random_run, get_random_run                                         */
+/****************************************************************************/
+/* each projection of a sample starts a new run, which is part of the key  */
+/* for the random streams, so repeated projections from the same seed get  */
+/* different deviates, and setting the seed again repeats the sequence     */
+/****************************************************************************/
+void start_random_run( void )
+{
+    random_run++;
+}
+
+unsigned long get_random_run( void )
+{
+    return random_run;
+}
+
+
+/****************************************************************************/
+/* init_random_stream                                                       */
+/****************************************************************************/
+/* initializes a stream of deviates for a plant in a given year of a run.   */
+/* the draws from the stream only depend on (seed, run, plot, plant, year,  */
+/* draw index) so the results don't depend on the order the plants are      */
+/* projected in or the number of threads used to project them               */
+/****************************************************************************/
+void init_random_stream( 
+    struct RANDOM_STREAM    *stream_ptr,
+    unsigned long           seed,
+    unsigned long           run,
+    unsigned long           plot,
+    unsigned long           plant,
+    unsigned long           year )
+{
+    stream_ptr->seed    = seed;
+    stream_ptr->run     = run;
+    stream_ptr->plot    = plot;
+    stream_ptr->plant   = plant;
+    stream_ptr->year    = year;
+    stream_ptr->draw    = 0;
+}
+
+
+/****************************************************************************/
+/* stream_uniform_0_1                                                       */
+/****************************************************************************/
+/* returns the next uniform deviate on (0,1) from the stream                */
+/****************************************************************************/
+double stream_uniform_0_1( struct RANDOM_STREAM *stream_ptr )
+{
+    uint32_t    words[4];
+    double      u;
+
+    random_stream_block( stream_ptr, stream_ptr->draw >> 2, words );
+    u = ( (double)words[stream_ptr->draw & 3] + 0.5 ) * TWO_POW_M32;
+    stream_ptr->draw++;
+
+    return u;
+}
+
+
+/****************************************************************************/
+/* stream_gauss_dev                                                         */
+/****************************************************************************/
+/* returns the next standard normal deviate from the stream. uses the       */
+/* box-muller transform so each deviate takes exactly two uniform draws     */
+/* and the draw index stays a function of the number of calls               */
+/****************************************************************************/
+double stream_gauss_dev( struct RANDOM_STREAM *stream_ptr )
+{
+    double  u1;
+    double  u2;
+
+    u1 = stream_uniform_0_1( stream_ptr );
+    u2 = stream_uniform_0_1( stream_ptr );
+
+    return sqrt( -2.0 * log( u1 ) ) * cos( 2.0 * MY_PI * u2 );
+}
+
+
+/****************************************************************************/
+/* fill_uniform_0_1, fill_gauss_dev                                         */
+/****************************************************************************/
+/* batch versions of stream_uniform_0_1 and stream_gauss_dev. these fill    */
+/* the deviates array with the next n deviates from the stream, computing   */
+/* each block of four words once, and give the same values as n calls to    */
+/* the single deviate functions                                             */
+/****************************************************************************/
+void fill_uniform_0_1( 
+    struct RANDOM_STREAM    *stream_ptr,
+    unsigned long           n,
+    double                  *deviates )
+{
+    uint32_t        words[4];
+    unsigned long   i;
+    unsigned long   block;
+
+    block = stream_ptr->draw >> 2;
+    random_stream_block( stream_ptr, block, words );
+
+    for( i = 0; i < n; i++ )
+    {
+        if( ( stream_ptr->draw >> 2 ) != block )
+        {
+            block = stream_ptr->draw >> 2;
+            random_stream_block( stream_ptr, block, words );
+        }
+
+        deviates[i] = ( (double)words[stream_ptr->draw & 3] + 0.5 ) * TWO_POW_M32;
+        stream_ptr->draw++;
+    }
+}
+
+void fill_gauss_dev( 
+    struct RANDOM_STREAM    *stream_ptr,
+    unsigned long           n,
+    double                  *deviates )
 {
-    double  fac = 0.0;
-    double  v1  = 0.0;
-    double  v2  = 0.0;
-    double  r   = 0.5;
+    unsigned long   i;
+    double          u[2];
 
-    for(;;)
+    for( i = 0; i < n; i++ )
     {
-       //v1 = 2.0f * ( (float)rand() / 32768.0f ) - 1.0f;
-       // v2 = 2.0f * ( (float)rand() / 32768.0f ) - 1.0f;
-       
-       v1 = 2.0f * ( (double)rand() / (double)RAND_MAX ) - 1.0f;
-       v2 = 2.0f * ( (double)rand() / (double)RAND_MAX ) - 1.0f;
+        fill_uniform_0_1( stream_ptr, 2, u );
+        deviates[i] = sqrt( -2.0 * log( u[0] ) ) * cos( 2.0 * MY_PI * u[1] );
+    }
+}
 
-       r  = v1 * v1 + v2 * v2;
 
-        if(  r > 0.0f && r < 1.0f )
+/* MOD007   */
+/****************************************************************************/
+/* philox_4x32_batch                                                        */
+/****************************************************************************/
+/* philox_4x32 for n counters at once, the counters and keys are passed by  */
+/* column and the four words for counter i are returned in c0[i] to c3[i].  */
+/* the rounds only use integer multiplies, xors and adds, so the loop over  */
+/* the counters is vectorized                                               */
+/****************************************************************************/
+SIMD_CLONES static void philox_4x32_batch( 
+    unsigned long       n,
+    uint32_t            *c0,
+    uint32_t            *c1,
+    uint32_t            *c2,
+    uint32_t            *c3,
+    uint32_t            *k0,
+    uint32_t            *k1 )
+{
+    unsigned long   i;
+    uint64_t        prod0;
+    uint64_t        prod1;
+    uint32_t        x0;
+    uint32_t        x1;
+    uint32_t        x2;
+    uint32_t        x3;
+    uint32_t        y0;
+    uint32_t        y1;
+    int             r;
+
+#ifdef _OPENMP
+#pragma omp simd private( prod0, prod1, x0, x1, x2, x3, y0, y1, r )
+#endif
+    for( i = 0; i < n; i++ )
+    {
+        x0 = c0[i];
+        x1 = c1[i];
+        x2 = c2[i];
+        x3 = c3[i];
+        y0 = k0[i];
+        y1 = k1[i];
+
+        for( r = 0; r < PHILOX_ROUNDS; r++ )
+        {
+            prod0 = (uint64_t)PHILOX_M0 * x0;
+            prod1 = (uint64_t)PHILOX_M1 * x2;
+
+            x0 = (uint32_t)( prod1 >> 32 ) ^ x1 ^ y0;
+            x1 = (uint32_t)prod1;
+            x2 = (uint32_t)( prod0 >> 32 ) ^ x3 ^ y1;
+            x3 = (uint32_t)prod0;
+
+            y0 += (uint32_t)PHILOX_W0;
+            y1 += (uint32_t)PHILOX_W1;
+        }
+
+        c0[i] = x0;
+        c1[i] = x1;
+        c2[i] = x2;
+        c3[i] = x3;
+    }
+}
+
+
+/****************************************************************************/
+/* fill_batch_uniform_0_1                                                   */
+/****************************************************************************/
+/* fills in the next n_draws uniform deviates from each of n_streams        */
+/* streams, deviates[d * n_streams + k] is draw d from stream k. the        */
+/* blocks of words for all the streams are computed together, and each      */
+/* block only once, instead of once for every draw. the values are the      */
+/* same as calling stream_uniform_0_1 n_draws times for each stream. the    */
+/* streams are expected to be at the same draw, as they are when they are   */
+/* first initialized, otherwise they are filled one at a time               */
+/****************************************************************************/
+void fill_batch_uniform_0_1( 
+    unsigned long           n_streams,
+    struct RANDOM_STREAM    *stream_ptr,
+    unsigned long           n_draws,
+    double                  *deviates )
+{
+    uint32_t        c0[GROWTH_BATCH_SIZE];
+    uint32_t        c1[GROWTH_BATCH_SIZE];
+    uint32_t        c2[GROWTH_BATCH_SIZE];
+    uint32_t        c3[GROWTH_BATCH_SIZE];
+    uint32_t        k0[GROWTH_BATCH_SIZE];
+    uint32_t        k1[GROWTH_BATCH_SIZE];
+    uint32_t        *words[4];
+    uint32_t        *w_ptr;
+    unsigned long   first;
+    unsigned long   n;
+    unsigned long   k;
+    unsigned long   d;
+    unsigned long   draw;
+    struct RANDOM_STREAM    *s_ptr;
+
+    if( n_streams == 0 )
+    {
+        return;
+    }
+
+    draw = stream_ptr[0].draw;
+    for( k = 1; k < n_streams; k++ )
+    {
+        if( stream_ptr[k].draw != draw )
         {
             break;
         }
     }
 
-    fac = sqrt( -2.0f * log( r ) / r );
+    if( k < n_streams )
+    {
+        for( k = 0; k < n_streams; k++ )
+        {
+            for( d = 0; d < n_draws; d++ )
+            {
+                deviates[d * n_streams + k] = stream_uniform_0_1( &stream_ptr[k] );
+            }
+        }
+        return;
+    }
 
-    return (float)( v2 * fac );
+    words[0] = c0;
+    words[1] = c1;
+    words[2] = c2;
+    words[3] = c3;
+
+    for( first = 0; first < n_streams; first += GROWTH_BATCH_SIZE )
+    {
+        n = n_streams - first;
+        if( n > GROWTH_BATCH_SIZE )
+        {
+            n = GROWTH_BATCH_SIZE;
+        }
+
+        for( d = 0; d < n_draws; d++ )
+        {
+            /* the counters are the same as in random_stream_block */
+            if( d == 0 || ( ( draw + d ) & 3 ) == 0 )
+            {
+                s_ptr = &stream_ptr[first];
+                for( k = 0; k < n; k++, s_ptr++ )
+                {
+                    c0[k] = (uint32_t)( ( draw + d ) >> 2 );
+                    c1[k] = (uint32_t)s_ptr->year;
+                    c2[k] = (uint32_t)s_ptr->plant;
+                    c3[k] = (uint32_t)s_ptr->plot;
+                    k0[k] = (uint32_t)s_ptr->seed;
+                    k1[k] = (uint32_t)( ( (uint64_t)s_ptr->seed ) >> 32 ) ^ 
+                            (uint32_t)s_ptr->run;
+                }
+
+                philox_4x32_batch( n, c0, c1, c2, c3, k0, k1 );
+            }
+
+            w_ptr = words[( draw + d ) & 3];
+            for( k = 0; k < n; k++ )
+            {
+                deviates[d * n_streams + first + k] = ( (double)w_ptr[k] + 0.5 ) * TWO_POW_M32;
+            }
+        }
+    }
+
+    for( k = 0; k < n_streams; k++ )
+    {
+        stream_ptr[k].draw += n_draws;
+    }
+}
+
+
+/****************************************************************************/
+/* calc_gauss_devs                                                          */
+/****************************************************************************/
+/* the box-muller transform used by stream_gauss_dev, for n pairs of        */
+/* uniform deviates                                                         */
+/****************************************************************************/
+void calc_gauss_devs( 
+    unsigned long           n,
+    double                  *u1_ptr,
+    double                  *u2_ptr,
+    double                  *deviates )
+{
+    unsigned long   i;
+
+    for( i = 0; i < n; i++ )
+    {
+        deviates[i] = sqrt( -2.0 * log( u1_ptr[i] ) ) * cos( 2.0 * MY_PI * u2_ptr[i] );
+    }
+}
+
+
+/****************************************************************************/
+/* fill_growth_batch_deviates                                               */
+/****************************************************************************/
+/* draws the deviates for the plants in a growth batch, in the order the    */
+/* project_plant functions draw them from a plant's stream: the normal      */
+/* deviate, browse, top damage, crown ratio (trees only) and crown width    */
+/* (trees and shrubs). the draws for the whole batch come from one call to  */
+/* fill_batch_uniform_0_1                                                   */
+/****************************************************************************/
+void fill_growth_batch_deviates( 
+    struct GROWTH_BATCH     *batch_ptr,
+    unsigned long           tree,
+    unsigned long           shrub )
+{
+    double          u[6 * GROWTH_BATCH_SIZE];
+    unsigned long   n;
+    unsigned long   n_draws;
+    unsigned long   k;
+
+    n       = batch_ptr->n;
+    n_draws = 4 + ( tree ? 1 : 0 ) + ( ( tree || shrub ) ? 1 : 0 );
+
+    fill_batch_uniform_0_1( n, batch_ptr->stream, n_draws, u );
+    calc_gauss_devs( n, &u[0], &u[n], batch_ptr->normal );
+
+    for( k = 0; k < n; k++ )
+    {
+        batch_ptr->browse_unif[k]   = u[2 * n + k];
+        batch_ptr->top_dam_unif[k]  = u[3 * n + k];
+        batch_ptr->cr_unif[k]       = tree ? u[4 * n + k] : 0.0;
+        batch_ptr->cw_unif[k]       = tree ? u[5 * n + k] : ( shrub ? u[4 * n + k] : 0.0 );
+    }
+}
+
+
+/* MOD005   */
+/****************************************************************************/
+/* gauss_dev                                                                */
+/****************************************************************************/
+/* this function returns a gaussian deviant                                 */
+/* MOD006 now drawn from the global random stream instead of rand(), the    */
+/* growth functions use a stream for each plant (see init_random_stream)    */
+/****************************************************************************/
+//static float gauss_dev()
+float gauss_dev()
+{
+    return (float)stream_gauss_dev( &global_stream );
 }
 
 
@@ -319,15 +791,11 @@ float gauss_dev()
 /* uniform_0_1                                                              */
 /****************************************************************************/
 /* this function generates a uniform distribution number between 0 and 1    */
+/* MOD006 now drawn from the global random stream instead of rand()         */
 /****************************************************************************/
 float uniform_0_1()
 {
-    float i1;
-
-//    i1 =  (float)rand() / (float)(RAND_MAX + 1.0);
-    i1 =  (float)( (double)rand() / (double)(RAND_MAX + 1.0) );
-
-    return i1;
+    return (float)stream_uniform_0_1( &global_stream );
 }
 
 
@@ -18,10 +18,6 @@ static int compare_summaries_by_code(
 				     const void *ptr1, 
 				     const void *ptr2 );
 
-static int compare_trees_by_plot(
-				 const void *ptr1,
-				 const void *ptr2 );
-
 
 static int compare_htn_by_plant_tht_expf( 
 					 const void *ptr1, 
@@ -33,6 +29,77 @@ struct HTN_RECORD {
   double    expf;
 };
 
+/* the tallest conifers for the height_40 in update_total_summaries, */
+/* the first HT40_BUFFER_SIZE are kept in the record itself           */
+#define HT40_BUFFER_SIZE   256
+#define HT40_HEAP_LIMIT    ( 40.0 * ( 1.0 + 1.0e-6 ) )
+
+struct HT40_HEAP {
+  unsigned long      n;
+  unsigned long      size;
+  double             expf;          /* sum of the expf in the heap  */
+  struct HTN_RECORD  *entries;
+  struct HTN_RECORD  buffer[HT40_BUFFER_SIZE];
+};
+
+static void init_ht40_heap( struct HT40_HEAP *heap_ptr );
+
+static void free_ht40_heap( struct HT40_HEAP *heap_ptr );
+
+static int add_to_ht40_heap( 
+			    struct HT40_HEAP *heap_ptr,
+			    double           tht,
+			    double           expf );
+
+static double calc_height_40_from_heap( struct HT40_HEAP *heap_ptr );
+
+/* the values update_species_summaries keeps for each species while */
+/* the plants are summed up                                         */
+struct SPECIES_SUMMARY_WORK {
+  double             max_height;
+  double             max_dbh;
+  double             max_hd6_ratio;
+  double             min_height;
+  double             min_dbh;
+  double             min_hd6_ratio;
+  struct HT40_HEAP   ht40;
+};
+
+static void free_species_summary_work( 
+				      unsigned long                n_summaries,
+				      struct SPECIES_SUMMARY_WORK  *work_ptr );
+
+static double calc_max_sdi_from_species_ba(
+					   unsigned long           n_species,
+					   struct SPECIES_RECORD   *species_ptr,
+					   struct COEFFS_RECORD    *coeffs_ptr,
+					   unsigned long           n_points,
+					   double                  *sp_ba_ptr,
+					   unsigned char           *sp_present );
+
+static int compare_competition_by_value( 
+					const void *ptr1, 
+					const void *ptr2 );
+
+static void sum_competition_table(
+				  unsigned long             n_entries,
+				  struct COMPETITION_RECORD *table_ptr );
+
+static struct COMPETITION_RECORD *find_competition_entry(
+				  double                    value,
+				  unsigned long             n_entries,
+				  struct COMPETITION_RECORD *table_ptr );
+
+/* the in taller and in larger tables for the plots built by            */
+/* calc_plot_stats_2. the table for each plot is stored at the same      */
+/* offset as the plant records for the plot, [first_plant,last_plant).   */
+/* the tables are only needed while the plants are imputed, so they are  */
+/* released with free_competition_tables() after that. the growth in     */
+/* project_plant_list builds the tables one plot at a time instead       */
+static struct COMPETITION_RECORD *in_taller_table = NULL;
+static struct COMPETITION_RECORD *in_larger_table = NULL;
+static unsigned long             competition_table_size = 0;
+
 /* todo: these need to go into the generic file/function for all variants */
 static   void calc_volume(
       unsigned long   *return_code,
@@ -50,6 +117,51 @@ static   void calc_biomass(
       double     	  *pred_biomass,
       double          *coeffs_ptr );
 
+/* up to GROWTH_BATCH_SIZE plants, in plant order, with the volume */
+/* and biomass filled in by calc_yields_for_chunk                  */
+struct YIELD_CHUNK {
+  unsigned long  n;
+  unsigned long  fsp_idx[GROWTH_BATCH_SIZE];
+  double         tht[GROWTH_BATCH_SIZE];
+  double         crown_width[GROWTH_BATCH_SIZE];
+  double         dbh[GROWTH_BATCH_SIZE];
+  double         volume[GROWTH_BATCH_SIZE];
+  double         biomass[GROWTH_BATCH_SIZE];
+};
+
+static void calc_yields_for_chunk(
+				  struct COEFFS_RECORD    *coeffs_ptr,
+				  struct YIELD_CHUNK      *chunk_ptr );
+
+static void sum_yields_from_columns(
+				    unsigned long           n_plants,
+				    struct COEFFS_RECORD    *coeffs_ptr,
+				    struct PLANT_COLUMNS    *cols_ptr,
+				    double                  *cfvolume4_ptr,
+				    double                  *biomass_ptr );
+
+static void sum_yields_from_plants(
+				   struct SPECIES_RECORD   *species_ptr,
+				   struct COEFFS_RECORD    *coeffs_ptr,
+				   unsigned long           n_plants,
+				   struct PLANT_RECORD     *plants_ptr,
+				   struct SUMMARY_RECORD   **by_sp_ptr );
+
+static   void calc_volume_batch(
+      unsigned long   n,
+      double          *total_height_ptr,
+      double          *dbh_ptr,
+      double          *pred_volume_ptr,
+      double          *coeffs_ptr );
+
+static   void calc_biomass_batch(
+      unsigned long   n,
+      double          *total_height_ptr,
+      double          *crown_width_ptr,
+      double          *dbh_ptr,
+      double          *pred_biomass_ptr,
+      double          *coeffs_ptr );
+
 
 
 /* put the get.set attribs_in_taller functions here */
@@ -165,26 +277,54 @@ void calc_plot_stats_2(
 {
         
   unsigned long   i;
-  unsigned long   j;
-
 
-  unsigned long   first_idx;
-  unsigned long   last_idx; 
   struct  PLOT_RECORD     *plot_ptr;
-  struct  PLANT_RECORD    *p_ptr; 
-  unsigned long   n_plants_found;
-  struct  COEFFS_RECORD   *c_ptr;
+  struct  COMPETITION_RECORD  *new_table_ptr;
+  struct  PLANT_COLUMNS   *cols_ptr;
 
   /* go through the tree array and only tally the basal area  */
   /* and expf for those plants that are not shrubs            */
   *return_code = CONIFERS_ERROR;
 
-  /* sort the tree list just to be safe   */
-  /* take the performance hit...          */
-  qsort(   plants_ptr, 
-	   n_plants, 
-	   sizeof( struct PLANT_RECORD ), 
-	   compare_trees_by_plot ); 
+  /* make sure there's an in taller and in larger table entry */
+  /* for each plant record                                    */
+  if( n_plants > competition_table_size )
+    {
+      new_table_ptr = (struct COMPETITION_RECORD *)realloc( in_taller_table, 
+			   n_plants * sizeof( struct COMPETITION_RECORD ) );
+      if( new_table_ptr == NULL )
+	{
+	  return;
+	}
+      in_taller_table = new_table_ptr;
+
+      new_table_ptr = (struct COMPETITION_RECORD *)realloc( in_larger_table, 
+			   n_plants * sizeof( struct COMPETITION_RECORD ) );
+      if( new_table_ptr == NULL )
+	{
+	  return;
+	}
+      in_larger_table = new_table_ptr;
+
+      competition_table_size = n_plants;
+    }
+
+  /* sort the tree list, if it needs it, and build the   */
+  /* index of plant records for each plot                */
+  build_plot_plant_index(  return_code,
+			   n_plants,
+			   plants_ptr,
+			   n_points,
+			   plots_ptr );
+
+  cols_ptr = build_plant_columns( return_code,
+				  species_ptr,
+				  n_plants,
+				  plants_ptr );
+  if( cols_ptr == NULL )
+    {
+      return;
+    }
 
   /* iterate through the plot and null out the values         */
   /* that will be calculated in the function, which should be */
@@ -192,6 +332,133 @@ void calc_plot_stats_2(
   plot_ptr = &plots_ptr[0];
   for( i = 0; i < n_points; i++, plot_ptr++ )
     {
+      plot_ptr->aggregates_current = 0;
+      calc_plot_stats_for_plot( n_species,
+				species_ptr,
+				n_coeffs,
+				coeffs_ptr,
+				cols_ptr,
+				plot_ptr,
+				&in_taller_table[plot_ptr->first_plant],
+				&in_larger_table[plot_ptr->first_plant] );
+
+      /* the partition points into the columns freed below */
+      plot_ptr->type_order = NULL;
+    }
+
+  free_plant_columns( cols_ptr );
+
+  *return_code = CONIFERS_SUCCESS;
+}
+
+
+/********************************************************************************/
+/* calc_plot_stats_for_plot                                                     */
+/********************************************************************************/
+/*  Description :   computes the plot statistics, and the in taller and in      */
+/*                  larger tables, for a single plot                            */
+/*  Returns     :   void                                                        */
+/*  Comments    :   the plant records for the plot must be indexed, see         */
+/*                  build_plot_plant_index. the tables need room for            */
+/*                  last_plant - first_plant entries each, and the plot keeps   */
+/*                  pointers to them for get_in_taller_attribs and              */
+/*                  get_in_larger_attribs until they are set back to NULL.      */
+/*                  the plot aggregates are only recomputed when they are not   */
+/*                  already current, see calc_plot_aggregates. the plot's       */
+/*                  plants are partitioned by type here too, see                */
+/*                  partition_plot_plants                                       */
+/*  Arguments   :   struct PLANT_COLUMNS *cols_ptr  - the plot sorted plants    */
+/*                  struct PLOT_RECORD  *plot_ptr   - the plot to summarize     */
+/*                  struct COMPETITION_RECORD *in_taller_ptr - in taller table  */
+/*                  struct COMPETITION_RECORD *in_larger_ptr - in larger table  */
+/********************************************************************************/
+void calc_plot_stats_for_plot( 
+		       unsigned long               n_species,
+		       struct SPECIES_RECORD       *species_ptr,
+		       unsigned long               n_coeffs,
+		       struct COEFFS_RECORD        *coeffs_ptr,
+		       struct PLANT_COLUMNS        *cols_ptr,
+		       struct PLOT_RECORD          *plot_ptr,
+		       struct COMPETITION_RECORD   *in_taller_ptr,
+		       struct COMPETITION_RECORD   *in_larger_ptr )
+{
+
+  unsigned long   j;
+
+  struct  COEFFS_RECORD   *c_ptr;
+  struct  COMPETITION_RECORD  *ait_ptr;
+  struct  COMPETITION_RECORD  *ail_ptr;
+
+	  ait_ptr = in_taller_ptr;
+	  ail_ptr = in_larger_ptr;
+	  for( j = plot_ptr->first_plant; j < plot_ptr->last_plant; j++, ait_ptr++, ail_ptr++ )
+	    {
+	      c_ptr = &coeffs_ptr[cols_ptr->fsp_idx[j]];
+
+	      /* the plant's entries in the in taller and in larger tables, */
+	      /* they're sorted and summed in sum_competition_table         */
+	      memset( ait_ptr, 0, sizeof( struct COMPETITION_RECORD ) );
+	      ait_ptr->value           = cols_ptr->tht[j];
+	      ait_ptr->ba[c_ptr->type] = cols_ptr->d6[j] * cols_ptr->d6[j] * FC_I * cols_ptr->expf[j];
+	      ait_ptr->ca[c_ptr->type] = cols_ptr->crown_area[j] * cols_ptr->expf[j];
+
+          /* added for CIPS variant August 1, 2014 by MWR*/
+	      memset( ail_ptr, 0, sizeof( struct COMPETITION_RECORD ) );
+	      ail_ptr->value           = cols_ptr->dbh[j];
+	      ail_ptr->ba[c_ptr->type] = cols_ptr->dbh[j] * cols_ptr->dbh[j] * FC_I * cols_ptr->expf[j];
+	    }
+
+	  partition_plot_plants( coeffs_ptr, cols_ptr, plot_ptr );
+
+	  if( !plot_ptr->aggregates_current )
+	    {
+	      calc_plot_aggregates( n_coeffs, coeffs_ptr, cols_ptr, plot_ptr );
+	    }
+
+	  /* sort the tables for the plot and total the values in taller/larger */
+	  sum_competition_table( plot_ptr->last_plant - plot_ptr->first_plant,
+				 in_taller_ptr );
+	  sum_competition_table( plot_ptr->last_plant - plot_ptr->first_plant,
+				 in_larger_ptr );
+
+	  plot_ptr->in_taller = in_taller_ptr;
+	  plot_ptr->in_larger = in_larger_ptr;
+
+}
+
+
+/********************************************************************************/
+/* calc_plot_aggregates                                                         */
+/********************************************************************************/
+/*  Description :   computes the plot totals (basal area, crown area, ccf,      */
+/*                  qmd, sdi, shrub cover, ...) from the plot's plants          */
+/*  Returns     :   void                                                        */
+/*  Comments    :   project_plant_list calls this for each plot right after     */
+/*                  the plot has been grown, while its plants are still in      */
+/*                  cache, and marks the plot's aggregates current, so the      */
+/*                  next year's calc_plot_stats_for_plot only has to build the  */
+/*                  in taller and in larger tables. the totals are summed the   */
+/*                  same way either way, so the results don't depend on where   */
+/*                  they were computed. anything that changes the plants on a   */
+/*                  plot (thin_plot) clears aggregates_current. the plot has to */
+/*                  be partitioned by type (partition_plot_plants), the totals  */
+/*                  for each type are summed over that type's rows only, and    */
+/*                  the tree totals are summed over the conifers and then the   */
+/*                  hardwoods                                                   */
+/*  Arguments   :   struct PLANT_COLUMNS *cols_ptr  - the plot sorted plants    */
+/*                  struct PLOT_RECORD  *plot_ptr   - the plot to summarize     */
+/********************************************************************************/
+void calc_plot_aggregates( 
+		       unsigned long               n_coeffs,
+		       struct COEFFS_RECORD        *coeffs_ptr,
+		       struct PLANT_COLUMNS        *cols_ptr,
+		       struct PLOT_RECORD          *plot_ptr )
+{
+
+  unsigned long   j;
+  unsigned long   k;
+  unsigned long   *order_ptr;
+
       /* these are temp variables */
       plot_ptr->shrub_pct_cover   = 0.0;    /*  crown ratio calc                */
       plot_ptr->shrub_mean_height = 0.0;    /*  ditto                           */
@@ -216,96 +483,64 @@ void calc_plot_stats_2(
 
       /* added for CONIFERS_CIPS */
 	plot_ptr->d12ba_c      = 0.0;
-	  
 
-	  /* clean out the old values */
-	  memset( plot_ptr->bait, 0, sizeof( double ) * PLANT_TYPES * AIT_SIZE );
-	  memset( plot_ptr->cait, 0, sizeof( double ) * PLANT_TYPES * AIT_SIZE );
-      memset( plot_ptr->bal,  0, sizeof( double ) * PLANT_TYPES * AIT_SIZE );
-    
-	  /* the plants have to be sorted by plot */
-	  get_plant_indecies_for_plot(  return_code,
-					plot_ptr,
-					n_plants,
-					plants_ptr,
-					&first_idx,
-					&last_idx,
-					&n_plants_found );
-	  /* need_error_trap_here */
+	  order_ptr = plot_ptr->type_order;
 
-	  //p_ptr = &plants_ptr[first_idx+1];
-	  p_ptr = &plants_ptr[first_idx];
-	  for( j = first_idx; j <= last_idx; j++, p_ptr++ )
+	  /* the conifers */
+	  for( j = plot_ptr->type_first[CONIFER]; j < plot_ptr->type_first[CONIFER + 1]; j++ )
 	    {
-	      c_ptr = &coeffs_ptr[species_ptr[p_ptr->sp_idx].fsp_idx];
-
-	      /* this is where the set_in_taller_attribs function is called */
-        
-	      set_in_taller_attribs( p_ptr, c_ptr, plot_ptr );
-          /* added for CIPS variant August 1, 2014 by MWR*/
-          set_in_larger_attribs( p_ptr, c_ptr, plot_ptr );
-
-	      /* take care of the shrub information */
-	      switch( c_ptr->type )
-		{
-		case CONIFER:
-		  plot_ptr->ba_c         += p_ptr->basal_area * p_ptr->expf;
-		  plot_ptr->ca_c         += p_ptr->crown_area * p_ptr->expf;
-		  plot_ptr->d6ba_c       += p_ptr->d6_area    * p_ptr->expf;
+	      k = order_ptr[j];
 
-          /* added for CONIFERS_CIPS */
-          plot_ptr->d12ba_c    += p_ptr->d12_area * p_ptr->expf;
+	      plot_ptr->ba_c         += cols_ptr->basal_area[k] * cols_ptr->expf[k];
+	      plot_ptr->ca_c         += cols_ptr->crown_area[k] * cols_ptr->expf[k];
+	      plot_ptr->d6ba_c       += cols_ptr->d6_area[k]    * cols_ptr->expf[k];
 
-		  if(p_ptr->tht > 4.5 )
-		    {
-		      plot_ptr->bh_expf  += p_ptr->expf;
-		    }
+	      /* added for CONIFERS_CIPS */
+	      plot_ptr->d12ba_c      += cols_ptr->d12_area[k] * cols_ptr->expf[k];
 
+	      plot_ptr->bh_expf      += ( cols_ptr->tht[k] > 4.5 ) ? cols_ptr->expf[k] : 0.0;
+	      plot_ptr->basal_area   += cols_ptr->basal_area[k] * cols_ptr->expf[k];
+	      plot_ptr->ccf          += cols_ptr->max_crown_width[k] *
+		cols_ptr->max_crown_width[k] * 
+		cols_ptr->expf[k];
+	    }
 
-		  plot_ptr->basal_area   += p_ptr->basal_area * p_ptr->expf;
-		  plot_ptr->ccf          += p_ptr->max_crown_width *
-		    p_ptr->max_crown_width * 
-		    p_ptr->expf;
-
-
-
-          break;
-
-		case HARDWOOD:
-		  plot_ptr->ba_h         += p_ptr->basal_area * p_ptr->expf;
-		  plot_ptr->ca_h         += p_ptr->crown_area * p_ptr->expf;
-		  plot_ptr->d6ba_h       += p_ptr->d6_area    * p_ptr->expf;
+	  /* the hardwoods */
+	  for( j = plot_ptr->type_first[HARDWOOD]; j < plot_ptr->type_first[HARDWOOD + 1]; j++ )
+	    {
+	      k = order_ptr[j];
 
-		  if(p_ptr->tht > 4.5 )
-		    {
-		      plot_ptr->bh_expf  += p_ptr->expf;
-		    }
+	      plot_ptr->ba_h         += cols_ptr->basal_area[k] * cols_ptr->expf[k];
+	      plot_ptr->ca_h         += cols_ptr->crown_area[k] * cols_ptr->expf[k];
+	      plot_ptr->d6ba_h       += cols_ptr->d6_area[k]    * cols_ptr->expf[k];
 
-		  plot_ptr->basal_area   += p_ptr->basal_area * p_ptr->expf;
-		  plot_ptr->ccf          += p_ptr->max_crown_width *
-		    p_ptr->max_crown_width * 
-		    p_ptr->expf;
-		  break;
+	      plot_ptr->bh_expf      += ( cols_ptr->tht[k] > 4.5 ) ? cols_ptr->expf[k] : 0.0;
+	      plot_ptr->basal_area   += cols_ptr->basal_area[k] * cols_ptr->expf[k];
+	      plot_ptr->ccf          += cols_ptr->max_crown_width[k] *
+		cols_ptr->max_crown_width[k] * 
+		cols_ptr->expf[k];
+	    }
 
-		case SHRUB:
-		  plot_ptr->shrub_pct_cover   += p_ptr->crown_area * p_ptr->expf;
-		  plot_ptr->shrub_mean_height += p_ptr->tht        * p_ptr->expf;
-		  plot_ptr->ca_s              += p_ptr->crown_area * p_ptr->expf;
-		  plot_ptr->d6ba_s            += p_ptr->d6_area    * p_ptr->expf;
-		  plot_ptr->shrub_expf        += p_ptr->expf;
-		  break;
+	  /* take care of the shrub information */
+	  for( j = plot_ptr->type_first[SHRUB]; j < plot_ptr->type_first[SHRUB + 1]; j++ )
+	    {
+	      k = order_ptr[j];
 
-		  /* the forbs */
-		case FORB:
-		  /* and do what here ? */
-		  break;
-		}
+	      plot_ptr->shrub_pct_cover   += cols_ptr->crown_area[k] * cols_ptr->expf[k];
+	      plot_ptr->shrub_mean_height += cols_ptr->tht[k]        * cols_ptr->expf[k];
+	      plot_ptr->ca_s              += cols_ptr->crown_area[k] * cols_ptr->expf[k];
+	      plot_ptr->d6ba_s            += cols_ptr->d6_area[k]    * cols_ptr->expf[k];
+	      plot_ptr->shrub_expf        += cols_ptr->expf[k];
+	    }
 
-	      plot_ptr->expf              += p_ptr->expf;
-	      plot_ptr->d6_area           += p_ptr->d6_area * p_ptr->expf;
-	      plot_ptr->crown_area        += p_ptr->crown_area * p_ptr->expf;
-		
-		  }
+	  /* the forbs and the non stocked records only count in the */
+	  /* totals for all the plants                               */
+	  for( j = plot_ptr->first_plant; j < plot_ptr->last_plant; j++ )
+	    {
+	      plot_ptr->expf              += cols_ptr->expf[j];
+	      plot_ptr->d6_area           += cols_ptr->d6_area[j] * cols_ptr->expf[j];
+	      plot_ptr->crown_area        += cols_ptr->crown_area[j] * cols_ptr->expf[j];
+	    }
 
 
 
@@ -339,38 +574,6 @@ void calc_plot_stats_2(
 	    {
 	      plot_ptr->shrub_mean_height = 0.0;
 	    }
-	  //continue;
-
-    }
-
-  *return_code = CONIFERS_SUCCESS;
-}
-
-
-
-static int compare_trees_by_plot(
-				 const void *ptr1,
-				 const void *ptr2 )
-{
-  struct PLANT_RECORD   *pt1_ptr;
-  struct PLANT_RECORD   *pt2_ptr;
-
-  pt1_ptr = (struct PLANT_RECORD*)ptr1;
-  pt2_ptr = (struct PLANT_RECORD*)ptr2;
-
-  if( pt1_ptr->plot < pt2_ptr->plot )
-    {
-      return -1;
-    }
-  if( pt1_ptr->plot > pt2_ptr->plot )
-    {
-      return 1;
-    }
-  else
-    {
-      return 0;
-    }
-
 
 }
 
@@ -751,6 +954,8 @@ void update_fsp_summaries(
 
 /* this allocates an array of summary records   */
 /*  and fills in the species codes for summary */
+/* the species in the plant list are marked in a bitmap by species   */
+/* index, so the array is allocated once in species order            */
 struct SUMMARY_RECORD *build_species_summaries( 
 					       unsigned long           *return_code,
 					       unsigned long           n_species,
@@ -762,69 +967,69 @@ struct SUMMARY_RECORD *build_species_summaries(
    
   unsigned long           i;
   struct  PLANT_RECORD    *plant_ptr = NULL;
-  struct  SPECIES_RECORD  *sp_ptr = NULL;
   struct  SUMMARY_RECORD  *sp_sum_ptr = NULL;
-  struct  SUMMARY_RECORD  *temp_sum_ptr = NULL;
+  unsigned char           *present = NULL;
 
   *n_sp_in_sample    = 0;
   *return_code = CONIFERS_SUCCESS;
 
+  present = (unsigned char *)calloc( ( n_species + 7 ) / 8 + 1, sizeof( unsigned char ) );
+  if( present == NULL )
+    {
+      *return_code = FAILED_MEMORY_ALLOC;
+      return NULL;
+    }
+
   /* start filling in the array from the plant list               */
   /* first find the number of unique species in the plant list    */
   plant_ptr = &plants_ptr[0];
   for( i = 0; i < n_plants; i++, plant_ptr++ )
     {
-        
-      /* get the species index for the plant */
-      sp_ptr = &species_ptr[plant_ptr->sp_idx];
-
-      /* see if the speices for the current plant is already      */
-      /* in the sum_ptr array                                     */
-      /* if it is, continue, otherwise add it                     */
-      /* man is this a bad function name                          */
-      temp_sum_ptr = get_summary_from_code( *n_sp_in_sample,
-					    sp_sum_ptr,
-					    sp_ptr->idx );
-      /* if it's found, then the entry is already in the sum_ptr  */
-      /* if the temp_sum_ptr == NULL, then you coulnd't find it   */
-      /* so add it and increment the number entered               */
-      if( temp_sum_ptr != NULL )
+      /* update_species_summaries will flag the plant */
+      if( plant_ptr->sp_idx >= n_species )
 	{
+	  *return_code = INVALID_SP_CODE;
 	  continue;
 	}
-      else
-	{
-	  /* if it's not in the sample, you'll need to add a new  */
-	  /* element by realloc-ing the array and adding the new  */
-	  /* value to the end, and resorting                      */
-	  sp_sum_ptr = 
-	    (struct SUMMARY_RECORD *)realloc(   
-					     sp_sum_ptr,
-					     *n_sp_in_sample * sizeof( struct SUMMARY_RECORD ) + 
-					     sizeof( struct SUMMARY_RECORD ) );
 
-	  /* MOD028 */
-	  /* NULL out the entry */
-	  memset( &sp_sum_ptr[(*n_sp_in_sample)], 
-		  0, 
-		  sizeof( struct SUMMARY_RECORD ) );
-
-	  //strcpy( sp_sum_ptr[(*n_sp_in_sample)++].code, sp_ptr->sp_code );
-	  sp_sum_ptr[(*n_sp_in_sample)++].code = sp_ptr->idx;
-            
-	  /* now sort so you can use bsearch() to see if the entry    */
-	  /* has already been added                                   */
-	  qsort(  sp_sum_ptr, 
-		  *n_sp_in_sample, 
-		  sizeof( struct SUMMARY_RECORD ), 
-		  compare_summaries_by_code );
+      if( !( present[plant_ptr->sp_idx / 8] & ( 1 << ( plant_ptr->sp_idx % 8 ) ) ) )
+	{
+	  present[plant_ptr->sp_idx / 8] |= ( 1 << ( plant_ptr->sp_idx % 8 ) );
+	  (*n_sp_in_sample)++;
 	}
+    }
+
+  if( *n_sp_in_sample == 0 )
+    {
+      free( present );
+      return NULL;
+    }
 
+  /* MOD028 */
+  /* NULL out the entries */
+  sp_sum_ptr = (struct SUMMARY_RECORD *)calloc( *n_sp_in_sample, 
+						sizeof( struct SUMMARY_RECORD ) );
+  if( sp_sum_ptr == NULL )
+    {
+      free( present );
+      *n_sp_in_sample = 0;
+      *return_code = FAILED_MEMORY_ALLOC;
+      return NULL;
     }
 
+  *n_sp_in_sample = 0;
+  for( i = 0; i < n_species; i++ )
+    {
+      if( present[i / 8] & ( 1 << ( i % 8 ) ) )
+	{
+	  sp_sum_ptr[(*n_sp_in_sample)++].code = species_ptr[i].idx;
+	}
+    }
 
+  free( present );
 
-  /* now sort the fsp summaries by fsp */
+  /* now sort the fsp summaries by fsp, the species indexes */
+  /* are normally in order already                           */
   qsort(  sp_sum_ptr, 
 	  *n_sp_in_sample, 
 	  sizeof( struct SUMMARY_RECORD ), 
@@ -833,13 +1038,14 @@ struct SUMMARY_RECORD *build_species_summaries(
   /* return the sumamry array pointer             */
   /* set the return_code for the calling function */
   /* and resort the tree list                     */
-  *return_code = CONIFERS_SUCCESS;
-
   return sp_sum_ptr;
 
 }
 
 
+/* the summaries are found by the species index of the plant, the     */
+/* work records hold the values that are only needed while the plants */
+/* are summed up, and the tallest conifers for the height_40           */
 void update_species_summaries( 
 			      unsigned long           *return_code,
 			      unsigned long           n_species,
@@ -850,29 +1056,29 @@ void update_species_summaries(
 			      struct PLANT_RECORD     *plants_ptr,
 			      unsigned long           n_points,
 			      unsigned long           n_summaries,
-			      struct SUMMARY_RECORD   *summaries_ptr )
+			      struct SUMMARY_RECORD   *summaries_ptr,
+			      unsigned long           with_yields )
 {
     
   unsigned long            i;
-  unsigned long            j;
+  unsigned long            tree;
   struct  COEFFS_RECORD    *c_ptr;
   struct  PLANT_RECORD     *plant_ptr;
   struct  SUMMARY_RECORD   *sum_ptr;
+  struct  SUMMARY_RECORD   **by_sp_ptr;
+  struct  SPECIES_SUMMARY_WORK *work_ptr;
+  struct  SPECIES_SUMMARY_WORK *w_ptr;
   unsigned long            temp_code;
-  double                   temp_volume;                
-  double                   temp_biomass;               
   double                   hdr;                        
-  struct                   HTN_RECORD *ht_n;
-  double                   tht40;
-  double                   sum_exp;
 
-
-  /*note: in this routine ht_n->is_tree is assigned the code from the summaries_ptr if its a conifer */
-  /* elsewhere it actually holds an indicator of is.tree either way it is an integer....             */
-  ht_n = (struct HTN_RECORD*)calloc( n_plants, sizeof( struct HTN_RECORD ) );
-
-  if( ht_n == NULL )
+  by_sp_ptr = (struct SUMMARY_RECORD **)calloc( n_species + 1, 
+						sizeof( struct SUMMARY_RECORD * ) );
+  work_ptr  = (struct SPECIES_SUMMARY_WORK *)malloc( ( n_summaries + 1 ) * 
+						     sizeof( struct SPECIES_SUMMARY_WORK ) );
+  if( by_sp_ptr == NULL || work_ptr == NULL )
     {
+      free( by_sp_ptr );
+      free( work_ptr );
       *return_code    = FAILED_MEMORY_ALLOC;
       return;
     }
@@ -881,7 +1087,8 @@ void update_species_summaries(
   /* that will be calculated in the function, which should be */
   /* all of them                                              */
   sum_ptr = &summaries_ptr[0];
-  for( i = 0; i < n_summaries; i++, sum_ptr++ )
+  w_ptr   = &work_ptr[0];
+  for( i = 0; i < n_summaries; i++, sum_ptr++, w_ptr++ )
     {
       /* store the sp_code in a temp and memset the struct    */
       /* copy the sp_code back in so you don't have to        */
@@ -889,184 +1096,169 @@ void update_species_summaries(
       temp_code = sum_ptr->code;
       memset( sum_ptr, 0, sizeof( struct  SUMMARY_RECORD ) );
       sum_ptr->code = temp_code;
+
+      if( temp_code < n_species )
+	{
+	  by_sp_ptr[temp_code] = sum_ptr;
+	}
+
+      /* the min values start at the largest values for the   */
+      /* species and go down                                  */
+      w_ptr->max_height    = 0.0;
+      w_ptr->max_dbh       = 0.0;
+      w_ptr->max_hd6_ratio = 0.0;
+      w_ptr->min_height    = HUGE_VAL;
+      w_ptr->min_dbh       = HUGE_VAL;
+      w_ptr->min_hd6_ratio = HUGE_VAL;
+      init_ht40_heap( &w_ptr->ht40 );
     }
 
-  /* go through the loop AGAIN! to get the min/max values for */
-  /* min_dbh/max_dbh and height                               */
   plant_ptr = &plants_ptr[0];
   for( i = 0; i < n_plants; i++, plant_ptr++ )
     {
-      c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
-
-
-      sum_ptr = get_summary_from_code(    n_summaries,
-					  summaries_ptr,
-					  //plant_ptr->sp_code );
-					  plant_ptr->sp_idx );
-      if( sum_ptr == NULL )
+      /* if the species isn't in the summaries, then  */
+      /* something's very wrong                       */
+      if( plant_ptr->sp_idx >= n_species || by_sp_ptr[plant_ptr->sp_idx] == NULL )
 	{
 	  *return_code = INVALID_SP_CODE;
-	  free(ht_n);
+	  free_species_summary_work( n_summaries, work_ptr );
+	  free( by_sp_ptr );
 	  return;
 	}
-      else
+
+      sum_ptr = by_sp_ptr[plant_ptr->sp_idx];
+      w_ptr   = &work_ptr[sum_ptr - summaries_ptr];
+      c_ptr   = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
+      tree    = is_tree( c_ptr );
+
+      if (c_ptr->type == CONIFER) 
 	{
-	  if (c_ptr->type == CONIFER) 
+	  if( !add_to_ht40_heap( &w_ptr->ht40, plant_ptr->tht, plant_ptr->expf/n_points ) )
 	    {
-	      ht_n[i].is_tree = (int)sum_ptr->code;
-	      ht_n[i].tht = plant_ptr->tht;
-	      ht_n[i].expf = plant_ptr->expf/n_points;
+	      *return_code    = FAILED_MEMORY_ALLOC;
+	      free_species_summary_work( n_summaries, work_ptr );
+	      free( by_sp_ptr );
+	      return;
 	    }
+	}
 
-	  if( plant_ptr->dbh > sum_ptr->min_dbh && plant_ptr->dbh > 0.0 )
+      if( plant_ptr->dbh > w_ptr->max_dbh && plant_ptr->dbh > 0.0 )
+	{
+	  w_ptr->max_dbh = plant_ptr->dbh;
+	}
+
+      if( plant_ptr->tht > w_ptr->max_height && plant_ptr->tht > 0.0 )
+	{
+	  w_ptr->max_height = plant_ptr->tht;
+	}
+
+      /* MOD042 */
+      /* calc the min h/d values */
+      if( tree && plant_ptr->d6 > 0.0 )
+	{
+	  hdr = plant_ptr->tht / plant_ptr->d6;
+
+	  if( hdr > w_ptr->max_hd6_ratio && hdr > 0.0 )
 	    {
-	      sum_ptr->min_dbh = plant_ptr->dbh;
+	      w_ptr->max_hd6_ratio = hdr;
 	    }
+	}
 
-	  /* calc the min height values */
-	  if( plant_ptr->tht > sum_ptr->min_height && plant_ptr->tht > 0.0 )
+      sum_ptr->expf           += plant_ptr->expf;
+              
+      /*   MOD034   */
+      if( tree )
+	{         
+	  sum_ptr->ccf            +=  CCF_CONST_I *
+	    plant_ptr->max_crown_width * 
+	    plant_ptr->max_crown_width *
+	    plant_ptr->expf;
+	  sum_ptr->cr             += plant_ptr->cr * plant_ptr->expf;
+	  sum_ptr->tree_expf      += plant_ptr->expf;
+
+	  hdr = plant_ptr->tht / plant_ptr->d6;
+	  sum_ptr->mean_hd6_ratio  += hdr * plant_ptr->expf;
+
+	  if( hdr > sum_ptr->max_hd6_ratio )
 	    {
-	      sum_ptr->min_height = plant_ptr->tht;
+	      sum_ptr->max_hd6_ratio = hdr;
 	    }
 
-	  /* MOD042 */
-	  /* calc the min h/d values */
-	  if( is_tree( c_ptr ) && plant_ptr->d6 > 0.0 )
+	  if( hdr < w_ptr->min_hd6_ratio )
 	    {
-	      hdr = plant_ptr->tht / plant_ptr->d6;
+	      w_ptr->min_hd6_ratio = hdr;
+	    }
+	  if(c_ptr->type == CONIFER)
+	    {
+	      sum_ptr->con_tpa += plant_ptr->expf;
+	    }
+	}
 
-	      if( hdr > sum_ptr->min_hd6_ratio && hdr > 0.0 )
-		{
-		  sum_ptr->min_hd6_ratio = hdr;
-		}
+
+      /* MOD012 */
+      /*  calculate the expf for trees        */
+      /*  above bh (conifs and hwoods only)   */
+      if ( plant_ptr->tht > 4.5 )
+	{           
+	  /* only sum up the values for the trees that    */
+	  /* are over 4.5 feet  tall                      */
+	  if( tree )
+	    {         
+	      sum_ptr->bh_expf    += plant_ptr->expf;
+	      sum_ptr->basal_area += plant_ptr->basal_area * plant_ptr->expf;
 	    }
 	}
-    }
 
-  /* start filling in the array from the plant list               */
-  /* first find the number of unique species in the plant list    */
-  plant_ptr = &plants_ptr[0];
-  for( i = 0; i < n_plants; i++, plant_ptr++ )
-    {
-      /* see if the speices for the current plant is already      */
-      /* in the sum_ptr array                                     */
-      /* if it is, continue, otherwise add it                     */
-      sum_ptr = get_summary_from_code(    n_summaries,
-					  summaries_ptr,
-					  //plant_ptr->sp_code );
-					  plant_ptr->sp_idx );
-         
-      /* if it's found, then the entry is already in the sum_ptr  */
-      /* if the temp_sum_ptr == NULL, then you coulnd't find it   */
-      /* and something's very wrong, otherwise you're cool        */
-      if( sum_ptr == NULL )
+      sum_ptr->mean_height    += plant_ptr->tht * plant_ptr->expf;
+      sum_ptr->crown_area     += plant_ptr->crown_area * plant_ptr->expf;
+      sum_ptr->pct_cover      += plant_ptr->crown_area * plant_ptr->expf;
+
+      /* calc the min/max height values */
+      if( plant_ptr->tht < w_ptr->min_height && plant_ptr->tht > 0.0 )
 	{
-	  *return_code = INVALID_SP_CODE;
-	  free(ht_n);
-	  return;
+	  w_ptr->min_height = plant_ptr->tht;
 	}
-      else
+      if( plant_ptr->tht > sum_ptr->max_height )
 	{
-	  sum_ptr->expf           += plant_ptr->expf;
-              
-	  c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
-
-	  /*   MOD034   */
-	  if( is_tree( c_ptr ) )
-	    {         
-	      sum_ptr->ccf            +=  CCF_CONST_I *
-		plant_ptr->max_crown_width * 
-		plant_ptr->max_crown_width *
-		plant_ptr->expf;
-	      sum_ptr->cr             += plant_ptr->cr * plant_ptr->expf;
-	      sum_ptr->tree_expf      += plant_ptr->expf;
-
-	      hdr = plant_ptr->tht / plant_ptr->d6;
-	      sum_ptr->mean_hd6_ratio  += hdr * plant_ptr->expf;
-
-	      if( hdr > sum_ptr->max_hd6_ratio )
-		{
-		  sum_ptr->max_hd6_ratio = hdr;
-		}
-
-	      if( hdr < sum_ptr->min_hd6_ratio )
-		{
-		  sum_ptr->min_hd6_ratio = hdr;
-		}
-	      if(c_ptr->type == CONIFER)
-		{
-		  sum_ptr->con_tpa += plant_ptr->expf;
-		}
-	    }
-
-
-	  /* MOD012 */
-	  /*  calculate the expf for trees        */
-	  /*  above bh (conifs and hwoods only)   */
-	  if ( plant_ptr->tht > 4.5 )
-	    {           
-	      /* only sum up the values for the trees that    */
-	      /* are over 4.5 feet  tall                      */
-	      if( is_tree( c_ptr ) )
-		{         
-		  sum_ptr->bh_expf    += plant_ptr->expf;
-		  sum_ptr->basal_area += plant_ptr->basal_area * plant_ptr->expf;
-                    
-		  /* MOD025 */
-		  calc_volume(return_code,  
-			      plant_ptr->tht,
-			      plant_ptr->dbh,
-			      &temp_volume,
-			      c_ptr->cfvolume4);
-
-		    /* need_error_trap_here */
-		    sum_ptr->cfvolume4  += temp_volume * plant_ptr->expf;
-		}
-	    }
-
-	  calc_biomass(return_code, /* MOD026 call biomass function */ 
-		       plant_ptr->tht,
-		       plant_ptr->d6,
-		       plant_ptr->crown_width,
-		       plant_ptr->dbh,
-		       &temp_biomass,
-		       c_ptr->biomass);
-	  /* need_error_trap_here */
-	  sum_ptr->biomass      += temp_biomass * plant_ptr->expf; 
-	  sum_ptr->mean_height    += plant_ptr->tht * plant_ptr->expf;
-	  sum_ptr->crown_area     += plant_ptr->crown_area * plant_ptr->expf;
-	  sum_ptr->pct_cover      += plant_ptr->crown_area * plant_ptr->expf;
-
-	  /* calc the min/max height values */
-	  if( plant_ptr->tht < sum_ptr->min_height && plant_ptr->tht > 0.0 )
-	    {
-	      sum_ptr->min_height = plant_ptr->tht;
-	    }
-	  if( plant_ptr->tht > sum_ptr->max_height )
-	    {
-	      sum_ptr->max_height = plant_ptr->tht;
-	    }
-
-	  /* calc the min/max dbh values */
-	  if( plant_ptr->dbh < sum_ptr->min_dbh && 
-	      plant_ptr->dbh > 0.0 )
-	    {
-	      sum_ptr->min_dbh = plant_ptr->dbh;
-	    }
-	  if( plant_ptr->dbh > sum_ptr->max_dbh )
-	    {
-	      sum_ptr->max_dbh = plant_ptr->dbh;
-	    }
+	  sum_ptr->max_height = plant_ptr->tht;
+	}
 
+      /* calc the min/max dbh values */
+      if( plant_ptr->dbh < w_ptr->min_dbh && 
+	  plant_ptr->dbh > 0.0 )
+	{
+	  w_ptr->min_dbh = plant_ptr->dbh;
+	}
+      if( plant_ptr->dbh > sum_ptr->max_dbh )
+	{
+	  sum_ptr->max_dbh = plant_ptr->dbh;
 	}
-    }            /* end of second tree loop*/
+    }
 
+  /* MOD025 MOD026 */
+  /* the volume and biomass are left at zero unless they're asked for */
+  if( with_yields )
+    {
+      sum_yields_from_plants( species_ptr,
+			      coeffs_ptr,
+			      n_plants,
+			      plants_ptr,
+			      by_sp_ptr );
+    }
 
 
   /* adjust the species summaries by the number of plots */
   sum_ptr = &summaries_ptr[0];
-  for( i = 0; i < n_summaries; i++, sum_ptr++ )
+  w_ptr   = &work_ptr[0];
+  for( i = 0; i < n_summaries; i++, sum_ptr++, w_ptr++ )
     {
+      sum_ptr->min_height    = ( w_ptr->min_height < w_ptr->max_height ) ? 
+	w_ptr->min_height : w_ptr->max_height;
+      sum_ptr->min_dbh       = ( w_ptr->min_dbh < w_ptr->max_dbh ) ? 
+	w_ptr->min_dbh : w_ptr->max_dbh;
+      sum_ptr->min_hd6_ratio = ( w_ptr->min_hd6_ratio < w_ptr->max_hd6_ratio ) ? 
+	w_ptr->min_hd6_ratio : w_ptr->max_hd6_ratio;
+
       sum_ptr->cr             /= sum_ptr->tree_expf;  /*  MOD034  */
       sum_ptr->mean_hd6_ratio /= sum_ptr->expf;       /*  MOD042  */
       sum_ptr->tree_expf      /= n_points;
@@ -1115,46 +1307,27 @@ void update_species_summaries(
 	  sum_ptr->cr = 0.0;
 	}
 
+      sum_ptr->height_40 = calc_height_40_from_heap( &w_ptr->ht40 );
     }
 
-  qsort(   ht_n, 
-	   n_plants, 
-	   sizeof( struct HTN_RECORD ), 
-	   compare_htn_by_plant_tht_expf ); 
+  free_species_summary_work( n_summaries, work_ptr );
+  free( by_sp_ptr );
 
-  tht40   = 0.0;   /* initialize ht40 */
-  sum_exp = 0.0;   /* init sum exps for ht40*/
+  *return_code = CONIFERS_SUCCESS;
+}
 
-  sum_ptr = &summaries_ptr[0];
-  for( j = 0; j < n_summaries; j++, sum_ptr++ )
-    {
-      tht40   = 0.0;   /* initialize ht40 */
-      sum_exp = 0.0;   /* init sum exps for ht40*/
-      for (i = 0; i < n_plants; i++)
-	{
-	  if(sum_exp < 40.0 && ht_n[i].is_tree == (int)sum_ptr->code)
-	    {
-	      if( sum_exp + ht_n[i].expf <= 40.0   )
-		{
-		  tht40   = tht40   + ht_n[i].tht * ht_n[i].expf;
-		  sum_exp = sum_exp + ht_n[i].expf;
-		}
-	      else 
-		{
-		  tht40 = tht40   + ht_n[i].tht * (40 - sum_exp );
-		  sum_exp = 40.0;
-		}
-	    }
-	}
-      if(sum_exp >0.0)
-	{
-	  sum_ptr->height_40=tht40/sum_exp;
-	}
-    }
 
-  free(ht_n);
+static void free_species_summary_work( 
+				      unsigned long                n_summaries,
+				      struct SPECIES_SUMMARY_WORK  *work_ptr )
+{
+  unsigned long i;
 
-  *return_code = CONIFERS_SUCCESS;
+  for( i = 0; i < n_summaries; i++ )
+    {
+      free_ht40_heap( &work_ptr[i].ht40 );
+    }
+  free( work_ptr );
 }
 
 
@@ -1211,7 +1384,8 @@ static int compare_htn_by_plant_tht_expf(
 /* this function updates a single struct SUMMARY_RECORD     */
 /* that represents the summary record for all the species   */
 /* in the sample. Note not all values will add up from the  */
-/* component species found in the species_ptr array         */
+/* component species found in the species_ptr array. the    */
+/* volume and biomass are always filled in                  */
 void update_total_summaries( 
 			    unsigned long           *return_code,
 			    unsigned long           n_points,
@@ -1223,21 +1397,73 @@ void update_total_summaries(
 			    struct PLANT_RECORD     *plants_ptr,
 			    struct SUMMARY_RECORD   *sum_ptr )
 {
+
+  struct  PLANT_COLUMNS   *cols_ptr;
+
+  cols_ptr = build_plant_columns( return_code,
+				  species_ptr,
+				  n_plants,
+				  plants_ptr );
+  if( cols_ptr == NULL )
+    {
+      return;
+    }
+
+  update_total_summaries_from_columns( return_code,
+				       n_points,
+				       n_plants,
+				       n_species,
+				       species_ptr,
+				       n_coeffs,
+				       coeffs_ptr,
+				       plants_ptr,
+				       cols_ptr,
+				       sum_ptr,
+				       1 );
+
+  free_plant_columns( cols_ptr );
+
+}
+
+
+/* same as update_total_summaries, from the columnar copy of the plant  */
+/* list. the summary is done in one pass over the plants, the tallest  */
+/* conifers for the height_40 are kept in a heap that only holds the   */
+/* 40 trees per acre (see add_to_ht40_heap), and the basal area of     */
+/* each species is summed up along the way for the max sdi, so the     */
+/* plant records aren't used. the volume and biomass are only worked   */
+/* out when with_yields is set, the projection doesn't need them       */
+void update_total_summaries_from_columns( 
+			    unsigned long           *return_code,
+			    unsigned long           n_points,
+			    unsigned long           n_plants,
+			    unsigned long           n_species,
+			    struct SPECIES_RECORD   *species_ptr,
+			    unsigned long           n_coeffs,
+			    struct COEFFS_RECORD    *coeffs_ptr,
+			    struct PLANT_RECORD     *plants_ptr,
+			    struct PLANT_COLUMNS    *cols_ptr,
+			    struct SUMMARY_RECORD   *sum_ptr,
+			    unsigned long           with_yields )
+{
     
   unsigned long           i;
-  struct  PLANT_RECORD    *plant_ptr;
+  unsigned long           tree;
   struct  COEFFS_RECORD   *c_ptr;
 
   double                  max_sdi;
-  double                    temp_volume;    /*  MOD025  */
-  double                    temp_biomass;   /*  MOD026  */
   //   double                  *double_ptr;    /*  MOD043  */
   double                  hdr;            /*  MOD042  */
-  double  tht40;
-  double  sum_exp;
-  double  temp_min_d;
-  double  temp_min_h;
-  struct HTN_RECORD *ht_n;
+  double  tht;
+  double  dbh;
+  double  expf;
+  double  max_h;
+  double  max_d;
+  double  min_tree_h;
+  double  min_tree_d;
+  double  *sp_ba;
+  unsigned char *sp_present;
+  struct HT40_HEAP ht40;
 
 
 
@@ -1246,147 +1472,145 @@ void update_total_summaries(
   /* all of them                                              */
   memset( sum_ptr, 0, sizeof( struct SUMMARY_RECORD ) );
 
-  /* start filling in the array from the plant list               */
-  /* first find the number of unique species in the plant list    */
-  plant_ptr = &plants_ptr[0];
+  /* the min height and dbh start at the largest values in the */
+  /* plant list (April 2008), and go down for each tree        */
+  max_h      = 0.0;
+  max_d      = 0.0;
+  min_tree_h = HUGE_VAL;
+  min_tree_d = HUGE_VAL;
+
+  /* the basal area for each species in the sample, for the max sdi */
+  sp_ba      = (double *)calloc( n_species + 1, sizeof( double ) );
+  sp_present = (unsigned char *)calloc( n_species + 1, sizeof( unsigned char ) );
+  if( sp_ba == NULL || sp_present == NULL )
+    {
+      free( sp_ba );
+      free( sp_present );
+      *return_code    = FAILED_MEMORY_ALLOC;
+      return;
+    }
 
-  // added this block of code April 2008 for initializing mins and maxs
-  temp_min_d = 0.0;
-  temp_min_h = 0.0;
-  for( i = 0; i < n_plants; i++, plant_ptr++ )
+  init_ht40_heap( &ht40 );
+
+  for( i = 0; i < n_plants; i++ )
     {
-      if((plant_ptr->tht > temp_min_h) && (plant_ptr->tht > 0.0))
+      tht  = cols_ptr->tht[i];
+      dbh  = cols_ptr->dbh[i];
+      expf = cols_ptr->expf[i];
+
+      if( tht > max_h )
 	{
-	  temp_min_h = plant_ptr->tht;
+	  max_h = tht;
 	}
-      if((plant_ptr->dbh > temp_min_d) && (plant_ptr->dbh > 0.0))
+      if( dbh > max_d )
 	{
-	  temp_min_d = plant_ptr->dbh;
+	  max_d = dbh;
 	}
-    }
-  
-  /* just start the min/max values on the first plant */
-  sum_ptr->min_dbh = temp_min_d;
-  sum_ptr->max_dbh = 0.0;
 
-  sum_ptr->min_height = temp_min_h;
-  sum_ptr->max_height = 0.0;
+      sum_ptr->expf           += expf;
 
-  /* just start the min/max values on the first plant */
+      c_ptr = &coeffs_ptr[cols_ptr->fsp_idx[i]];
+      tree  = is_tree( c_ptr );
 
-  /* allocate an array of three doubles that's n_plants long */
-  //*ht_n = (double*)calloc( n_plants, sizeof( double ) * 3 * n_plants );
-  ht_n = (struct HTN_RECORD*)calloc( n_plants, sizeof( struct HTN_RECORD ) );
-
-  if( ht_n == NULL )
-    {
-      *return_code    = FAILED_MEMORY_ALLOC;
-      return;
-    }
-
-  plant_ptr = &plants_ptr[0];
-
-  for( i = 0; i < n_plants; i++, plant_ptr++ )
-    {
-      sum_ptr->expf           += plant_ptr->expf;
-
-      c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
+      if( cols_ptr->sp_idx[i] < n_species )
+	{
+	  sp_present[cols_ptr->sp_idx[i]] = 1;
+	}
 
       /* only sum up the values for the trees that    */
       /* are over 4.5 feet  tall                      */
-      if( plant_ptr->tht > 4.5 )
+      if( tht > 4.5 )
 	{
 	  /*  MOD034  */
-	  if( is_tree( c_ptr ) )
+	  if( tree )
 	    {         
-	      sum_ptr->bh_expf    += plant_ptr->expf;
-	      sum_ptr->basal_area += plant_ptr->basal_area * plant_ptr->expf;
-                
-	      /*  MOD025  */
-	      calc_volume(    return_code, 
-			      plant_ptr->tht,
-			      plant_ptr->dbh,
-			      &temp_volume,
-			      c_ptr->cfvolume4 );
-	      /* need_error_trap_here */
-
-	      sum_ptr->cfvolume4  += temp_volume * plant_ptr->expf;
+	      sum_ptr->bh_expf    += expf;
+	      sum_ptr->basal_area += cols_ptr->basal_area[i] * expf;
+	      if( cols_ptr->sp_idx[i] < n_species )
+		{
+		  sp_ba[cols_ptr->sp_idx[i]] += cols_ptr->basal_area[i] * expf;
+		}
 	    }
 	}
 
       /* MOD042 */
       /* calc the min h/d values */
-      if( is_tree( c_ptr ) && plant_ptr->d6 > 0.0 )
+      if( tree && cols_ptr->d6[i] > 0.0 )
 	{
-	  hdr = plant_ptr->tht / plant_ptr->d6;
+	  hdr = tht / cols_ptr->d6[i];
 
 	  if( hdr > sum_ptr->min_hd6_ratio && hdr > 0.0 )
 	    {
 	      sum_ptr->min_hd6_ratio = hdr;
 	    }
 	}
+
       /* this is to calculate the height 40*/
-      if (c_ptr->type == CONIFER) 
+      if( c_ptr->type == CONIFER ) 
 	{
-	  ht_n[i].is_tree = is_tree( c_ptr );
-	  ht_n[i].tht = plant_ptr->tht;
-	  ht_n[i].expf = plant_ptr->expf/n_points;
+	  if( !add_to_ht40_heap( &ht40, tht, expf / n_points ) )
+	    {
+	      free_ht40_heap( &ht40 );
+	      free( sp_ba );
+	      free( sp_present );
+	      *return_code    = FAILED_MEMORY_ALLOC;
+	      return;
+	    }
 	}
 
-      calc_biomass(return_code, /* MOD026 call biomass function */ 
-		   plant_ptr->tht,
-		   plant_ptr->d6,
-		   plant_ptr->crown_width,
-		   plant_ptr->dbh,
-		   &temp_biomass,
-		   c_ptr->biomass);
-      /* need_error_trap_here */
-      sum_ptr->biomass          += temp_biomass * plant_ptr->expf; 
-
-      sum_ptr->crown_area     += plant_ptr->crown_area * plant_ptr->expf;
-      sum_ptr->pct_cover      += plant_ptr->crown_area * plant_ptr->expf;
+      sum_ptr->crown_area     += cols_ptr->crown_area[i] * expf;
+      sum_ptr->pct_cover      += cols_ptr->crown_area[i] * expf;
 
       /* add the ccf values for the sample */
-      if( is_tree( c_ptr ) )
+      if( tree )
 	{
-	  sum_ptr->mean_height    += plant_ptr->tht * plant_ptr->expf;
+	  sum_ptr->mean_height    += tht * expf;
 	  sum_ptr->ccf            +=  CCF_CONST_I *
-	    plant_ptr->max_crown_width * 
-	    plant_ptr->max_crown_width *
-	    plant_ptr->expf;
-	  sum_ptr->cr             += plant_ptr->cr * plant_ptr->expf;
-	  sum_ptr->tree_expf      += plant_ptr->expf;
+	    cols_ptr->max_crown_width[i] * 
+	    cols_ptr->max_crown_width[i] *
+	    expf;
+	  sum_ptr->cr             += cols_ptr->cr[i] * expf;
+	  sum_ptr->tree_expf      += expf;
 	  if(c_ptr->type == CONIFER)
 	    {
-	      sum_ptr->con_tpa += plant_ptr->expf;
+	      sum_ptr->con_tpa += expf;
 	    }
-	}
 
-      /* calc the min/max height values */
-      if( is_tree(c_ptr) )
-	{
-	  if( plant_ptr->tht < sum_ptr->min_height && plant_ptr->tht > 0.0 )
+	  /* calc the min/max height values */
+	  if( tht < min_tree_h && tht > 0.0 )
 	    {
-	      sum_ptr->min_height = plant_ptr->tht;
+	      min_tree_h = tht;
 	    }
-	  if( plant_ptr->tht > sum_ptr->max_height )
+	  if( tht > sum_ptr->max_height )
 	    {
-	      sum_ptr->max_height = plant_ptr->tht;
+	      sum_ptr->max_height = tht;
 	    }
         
 	  /* calc the min/max dbh values */
-	  if( plant_ptr->dbh < sum_ptr->min_dbh && 
-	      plant_ptr->dbh > 0.0 )
+	  if( dbh < min_tree_d && dbh > 0.0 )
 	    {
-	      sum_ptr->min_dbh = plant_ptr->dbh;
+	      min_tree_d = dbh;
 	    }
-	  if( plant_ptr->dbh > sum_ptr->max_dbh )
+	  if( dbh > sum_ptr->max_dbh )
 	    {
-	      sum_ptr->max_dbh = plant_ptr->dbh;
+	      sum_ptr->max_dbh = dbh;
 	    }
 	}
     }
 
+  sum_ptr->min_height = ( min_tree_h < max_h ) ? min_tree_h : max_h;
+  sum_ptr->min_dbh    = ( min_tree_d < max_d ) ? min_tree_d : max_d;
+
+  /*  MOD025  MOD026  */
+  if( with_yields )
+    {
+      sum_yields_from_columns( n_plants,
+			       coeffs_ptr,
+			       cols_ptr,
+			       &sum_ptr->cfvolume4,
+			       &sum_ptr->biomass );
+    }
+
   /*  MOD024  */
   /*  MOD034  */
   /* adjust the species summaries by the number of plots */
@@ -1445,17 +1669,17 @@ void update_total_summaries(
     {
       sum_ptr->curtis_rd = sum_ptr->basal_area / sqrt( sum_ptr->qmd );
       
-      calc_max_sdi( return_code, 
-		    n_species,
-		    species_ptr,
-		    n_coeffs,
-		    coeffs_ptr,
-		    n_plants,
-		    plants_ptr,
-		    n_points,
-		    &max_sdi );
+      max_sdi = calc_max_sdi_from_species_ba( n_species,
+					      species_ptr,
+					      coeffs_ptr,
+					      n_points,
+					      sp_ba,
+					      sp_present );
     }
 
+  free( sp_ba );
+  free( sp_present );
+
   sum_ptr->sdimax = max_sdi;
   /* now calculate the REINEKE relative density */
   if( max_sdi > 0.0 )
@@ -1463,41 +1687,386 @@ void update_total_summaries(
       sum_ptr->rel_density = sum_ptr->sdi / max_sdi;
     }
    
+  sum_ptr->height_40 = calc_height_40_from_heap( &ht40 );
+  free_ht40_heap( &ht40 );
+
+  *return_code = CONIFERS_SUCCESS;
+
+}
+
+
+/* the volume and biomass for the plants in a chunk. the plants are   */
+/* grouped by functional species, so each group goes through the      */
+/* batched equations with one set of coefficients, and the values are  */
+/* put back in plant order. the volume is only filled in for trees     */
+static void calc_yields_for_chunk(
+				  struct COEFFS_RECORD    *coeffs_ptr,
+				  struct YIELD_CHUNK      *chunk_ptr )
+{
+  unsigned long          i;
+  unsigned long          j;
+  unsigned long          m;
+  unsigned long          fsp_idx;
+  struct COEFFS_RECORD   *c_ptr;
+  unsigned char          done[GROWTH_BATCH_SIZE];
+  unsigned long          rows[GROWTH_BATCH_SIZE];
+  double                 tht[GROWTH_BATCH_SIZE];
+  double                 crown_width[GROWTH_BATCH_SIZE];
+  double                 dbh[GROWTH_BATCH_SIZE];
+  double                 volume[GROWTH_BATCH_SIZE];
+  double                 biomass[GROWTH_BATCH_SIZE];
+
+  memset( done, 0, sizeof( done ) );
+
+  for( i = 0; i < chunk_ptr->n; i++ )
+    {
+      if( done[i] )
+	{
+	  continue;
+	}
+
+      /* pull out the plants that share the functional species */
+      fsp_idx = chunk_ptr->fsp_idx[i];
+      m       = 0;
+      for( j = i; j < chunk_ptr->n; j++ )
+	{
+	  if( !done[j] && chunk_ptr->fsp_idx[j] == fsp_idx )
+	    {
+	      rows[m]        = j;
+	      tht[m]         = chunk_ptr->tht[j];
+	      crown_width[m] = chunk_ptr->crown_width[j];
+	      dbh[m]         = chunk_ptr->dbh[j];
+	      done[j]        = 1;
+	      m++;
+	    }
+	}
+
+      c_ptr = &coeffs_ptr[fsp_idx];
+      if( is_tree( c_ptr ) )
+	{
+	  calc_volume_batch( m, tht, dbh, volume, c_ptr->cfvolume4 );
+	}
+      else
+	{
+	  memset( volume, 0, m * sizeof( double ) );
+	}
+      calc_biomass_batch( m, tht, crown_width, dbh, biomass, c_ptr->biomass );
+
+      for( j = 0; j < m; j++ )
+	{
+	  chunk_ptr->volume[rows[j]]  = volume[j];
+	  chunk_ptr->biomass[rows[j]] = biomass[j];
+	}
+    }
+}
+
+
+/* sums up the volume (trees over 4.5 feet) and biomass (all plants)  */
+/* times the expf for the plants in the columns, in plant order. the  */
+/* yields always use the math library, not the fast kernels (see      */
+/* calc_volume_batch), so they don't depend on how the sample was     */
+/* grown                                                              */
+static void sum_yields_from_columns(
+				    unsigned long           n_plants,
+				    struct COEFFS_RECORD    *coeffs_ptr,
+				    struct PLANT_COLUMNS    *cols_ptr,
+				    double                  *cfvolume4_ptr,
+				    double                  *biomass_ptr )
+{
+  unsigned long           i;
+  unsigned long           k;
+  struct YIELD_CHUNK      chunk;
+
+  *cfvolume4_ptr = 0.0;
+  *biomass_ptr   = 0.0;
+
+  for( i = 0; i < n_plants; i += chunk.n )
+    {
+      chunk.n = ( n_plants - i < GROWTH_BATCH_SIZE ) ? 
+	n_plants - i : GROWTH_BATCH_SIZE;
+
+      for( k = 0; k < chunk.n; k++ )
+	{
+	  chunk.fsp_idx[k]     = cols_ptr->fsp_idx[i + k];
+	  chunk.tht[k]         = cols_ptr->tht[i + k];
+	  chunk.crown_width[k] = cols_ptr->crown_width[i + k];
+	  chunk.dbh[k]         = cols_ptr->dbh[i + k];
+	}
+
+      calc_yields_for_chunk( coeffs_ptr, &chunk );
+
+      for( k = 0; k < chunk.n; k++ )
+	{
+	  if( chunk.tht[k] > 4.5 && is_tree( &coeffs_ptr[chunk.fsp_idx[k]] ) )
+	    {
+	      *cfvolume4_ptr += chunk.volume[k] * cols_ptr->expf[i + k];
+	    }
+	  *biomass_ptr += chunk.biomass[k] * cols_ptr->expf[i + k];
+	}
+    }
+}
+
+
+/* same as sum_yields_from_columns, from the plant records into the   */
+/* species summaries in by_sp_ptr (see update_species_summaries). the */
+/* species of the plants have already been checked                    */
+static void sum_yields_from_plants(
+				   struct SPECIES_RECORD   *species_ptr,
+				   struct COEFFS_RECORD    *coeffs_ptr,
+				   unsigned long           n_plants,
+				   struct PLANT_RECORD     *plants_ptr,
+				   struct SUMMARY_RECORD   **by_sp_ptr )
+{
+  unsigned long           i;
+  unsigned long           k;
+  struct PLANT_RECORD     *plant_ptr;
+  struct SUMMARY_RECORD   *sum_ptr;
+  struct YIELD_CHUNK      chunk;
+
+  for( i = 0; i < n_plants; i += chunk.n )
+    {
+      chunk.n = ( n_plants - i < GROWTH_BATCH_SIZE ) ? 
+	n_plants - i : GROWTH_BATCH_SIZE;
+
+      plant_ptr = &plants_ptr[i];
+      for( k = 0; k < chunk.n; k++, plant_ptr++ )
+	{
+	  chunk.fsp_idx[k]     = species_ptr[plant_ptr->sp_idx].fsp_idx;
+	  chunk.tht[k]         = plant_ptr->tht;
+	  chunk.crown_width[k] = plant_ptr->crown_width;
+	  chunk.dbh[k]         = plant_ptr->dbh;
+	}
+
+      calc_yields_for_chunk( coeffs_ptr, &chunk );
+
+      plant_ptr = &plants_ptr[i];
+      for( k = 0; k < chunk.n; k++, plant_ptr++ )
+	{
+	  sum_ptr = by_sp_ptr[plant_ptr->sp_idx];
+	  if( chunk.tht[k] > 4.5 && is_tree( &coeffs_ptr[chunk.fsp_idx[k]] ) )
+	    {
+	      sum_ptr->cfvolume4 += chunk.volume[k] * plant_ptr->expf;
+	    }
+	  sum_ptr->biomass += chunk.biomass[k] * plant_ptr->expf;
+	}
+    }
+}
+
+
+/* the volume (trees over 4.5 feet) and biomass (all plants) per acre */
+/* for the plants, from calc_volume and calc_biomass one plant at a    */
+/* time. this is how the summaries got the yields before they were     */
+/* done in batches (sum_yields_from_columns). it's the per.plant       */
+/* option of calc.yields in R, so the yields can be compared with the  */
+/* ones from versions before 1.1-4                                     */
+void calc_yields_per_plant( 
+			   unsigned long           *return_code,
+			   unsigned long           n_points,
+			   unsigned long           n_plants,
+			   unsigned long           n_species,
+			   struct SPECIES_RECORD   *species_ptr,
+			   unsigned long           n_coeffs,
+			   struct COEFFS_RECORD    *coeffs_ptr,
+			   struct PLANT_RECORD     *plants_ptr,
+			   double                  *cfvolume4_ptr,
+			   double                  *biomass_ptr )
+{
+  unsigned long           i;
+  unsigned long           temp_code;
+  struct  COEFFS_RECORD   *c_ptr;
+  struct  PLANT_RECORD    *plant_ptr;
+  double                  temp_volume;
+  double                  temp_biomass;
+
+  *cfvolume4_ptr = 0.0;
+  *biomass_ptr   = 0.0;
+
+  plant_ptr = &plants_ptr[0];
+  for( i = 0; i < n_plants; i++, plant_ptr++ )
+    {
+      if( plant_ptr->sp_idx >= n_species ||
+	  species_ptr[plant_ptr->sp_idx].fsp_idx >= n_coeffs )
+	{
+	  *return_code = INVALID_SP_CODE;
+	  return;
+	}
+
+      c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
+
+      /*  MOD025  */
+      if( plant_ptr->tht > 4.5 && is_tree( c_ptr ) )
+	{
+	  calc_volume( &temp_code,
+		       plant_ptr->tht,
+		       plant_ptr->dbh,
+		       &temp_volume,
+		       c_ptr->cfvolume4 );
+	  *cfvolume4_ptr += temp_volume * plant_ptr->expf;
+	}
+
+      /*  MOD026  */
+      calc_biomass( &temp_code,
+		    plant_ptr->tht,
+		    plant_ptr->d6,
+		    plant_ptr->crown_width,
+		    plant_ptr->dbh,
+		    &temp_biomass,
+		    c_ptr->biomass );
+      *biomass_ptr += temp_biomass * plant_ptr->expf;
+    }
+
+  *cfvolume4_ptr /= n_points;
+  *biomass_ptr   /= n_points;
+
+  *return_code = CONIFERS_SUCCESS;
+}
+
+
+/* the tallest conifers for the height_40 are kept in a heap with the */
+/* shortest (the last by compare_htn_by_plant_tht_expf) at the root. a */
+/* tree is only added if it's taller than the root or the trees in the */
+/* heap don't make up 40 trees per acre yet, and the root is dropped   */
+/* once the trees above it make up the 40 trees. the sums are kept a   */
+/* little over 40 so rounding in the running total can't drop a tree   */
+/* that the height_40 needs. the plants without an expansion factor    */
+/* don't add to the height_40, so they're left out                     */
+static void init_ht40_heap( struct HT40_HEAP *heap_ptr )
+{
+  heap_ptr->n       = 0;
+  heap_ptr->size    = HT40_BUFFER_SIZE;
+  heap_ptr->expf    = 0.0;
+  heap_ptr->entries = &heap_ptr->buffer[0];
+}
+
+
+static void free_ht40_heap( struct HT40_HEAP *heap_ptr )
+{
+  if( heap_ptr->entries != &heap_ptr->buffer[0] )
+    {
+      free( heap_ptr->entries );
+    }
+  heap_ptr->entries = &heap_ptr->buffer[0];
+  heap_ptr->n       = 0;
+}
+
+
+/* returns 0 if the heap couldn't grow */
+static int add_to_ht40_heap( 
+			    struct HT40_HEAP *heap_ptr,
+			    double           tht,
+			    double           expf )
+{
+  struct HTN_RECORD  entry;
+  struct HTN_RECORD  *new_ptr;
+  struct HTN_RECORD  *e;
+  unsigned long      i;
+  unsigned long      child;
+
+  if( !( expf > 0.0 ) )
+    {
+      return 1;
+    }
+
+  entry.is_tree = 1;
+  entry.tht     = tht;
+  entry.expf    = expf;
+
+  e = heap_ptr->entries;
+
+  /* the heap already has the 40 trees and this one is shorter */
+  if( heap_ptr->expf >= HT40_HEAP_LIMIT &&
+      compare_htn_by_plant_tht_expf( &entry, &e[0] ) >= 0 )
+    {
+      return 1;
+    }
+
+  if( heap_ptr->n == heap_ptr->size )
+    {
+      new_ptr = (struct HTN_RECORD*)malloc( 2 * heap_ptr->size * sizeof( struct HTN_RECORD ) );
+      if( new_ptr == NULL )
+	{
+	  return 0;
+	}
+      memcpy( new_ptr, e, heap_ptr->n * sizeof( struct HTN_RECORD ) );
+      free_ht40_heap( heap_ptr );
+      heap_ptr->entries = e = new_ptr;
+      heap_ptr->n       = heap_ptr->size;
+      heap_ptr->size   *= 2;
+    }
+
+  /* sift the new tree up */
+  i = heap_ptr->n++;
+  while( i > 0 && compare_htn_by_plant_tht_expf( &entry, &e[( i - 1 ) / 2] ) > 0 )
+    {
+      e[i] = e[( i - 1 ) / 2];
+      i    = ( i - 1 ) / 2;
+    }
+  e[i] = entry;
+  heap_ptr->expf += expf;
+
+  /* drop the shortest trees that aren't needed */
+  while( heap_ptr->n > 1 && heap_ptr->expf - e[0].expf >= HT40_HEAP_LIMIT )
+    {
+      heap_ptr->expf -= e[0].expf;
+      entry = e[--heap_ptr->n];
+      i     = 0;
+      while( ( child = 2 * i + 1 ) < heap_ptr->n )
+	{
+	  if( child + 1 < heap_ptr->n &&
+	      compare_htn_by_plant_tht_expf( &e[child + 1], &e[child] ) > 0 )
+	    {
+	      child++;
+	    }
+	  if( compare_htn_by_plant_tht_expf( &e[child], &entry ) <= 0 )
+	    {
+	      break;
+	    }
+	  e[i] = e[child];
+	  i    = child;
+	}
+      e[i] = entry;
+    }
+
+  return 1;
+}
+
+
+/* the mean height of the tallest 40 trees per acre in the heap, or 0 */
+static double calc_height_40_from_heap( struct HT40_HEAP *heap_ptr )
+{
+  unsigned long  i;
+  double         tht40;
+  double         sum_exp;
+
   /* sort for ht 40 */
-  qsort(   ht_n, 
-	   n_plants, 
+  qsort(   heap_ptr->entries, 
+	   heap_ptr->n, 
 	   sizeof( struct HTN_RECORD ), 
 	   compare_htn_by_plant_tht_expf ); 
 
   tht40   = 0.0;   /* initialize ht40 */
   sum_exp = 0.0;   /* init sum exps for ht40*/
 
-  for (i = 0; i < n_plants; i++)
+  for (i = 0; i < heap_ptr->n && sum_exp < 40.0; i++)
     {
       /* first accumulate height of 40 largest conifers...*/
-      if(sum_exp < 40.0 && ht_n[i].is_tree ==1)
+      if( sum_exp + heap_ptr->entries[i].expf <= 40.0   )
 	{
-	  if( sum_exp + ht_n[i].expf <= 40.0   )
-	    {
-	      tht40   = tht40   + ht_n[i].tht * ht_n[i].expf;
-	      sum_exp = sum_exp + ht_n[i].expf;
-	    }
-	  else 
-	    {
-	      tht40 = tht40   + ht_n[i].tht * (40 - sum_exp );
-	      sum_exp = 40.0;
-	    }
+	  tht40   = tht40   + heap_ptr->entries[i].tht * heap_ptr->entries[i].expf;
+	  sum_exp = sum_exp + heap_ptr->entries[i].expf;
+	}
+      else 
+	{
+	  tht40 = tht40   + heap_ptr->entries[i].tht * (40 - sum_exp );
+	  sum_exp = 40.0;
 	}
     }
 
-  free(ht_n);
   if(sum_exp > 0.0)
     {
-      sum_ptr->height_40=tht40/sum_exp;
+      return tht40/sum_exp;
     }
-
-  *return_code = CONIFERS_SUCCESS;
-
+  return 0.0;
 }
 
 
@@ -1538,7 +2107,9 @@ struct SUMMARY_RECORD *get_summary_from_code(
 /*  Author      :   Martin W. Ritchie & Jeff D. Hamann                          */
 /*  Date        :   January 4, 2000                                             */
 /*  Returns     :   void                                                        */
-/*  Comments    :                                                               */
+/*  Comments    :   sums the basal area of each species in one pass over the    */
+/*                  plants, the stand summaries get the same value from their   */
+/*                  own pass (update_total_summaries_from_columns)              */
 /*  Arguments   :                                                               */
 /*  return void                                                                 */
 /*  unsigned long *return_code      - return code for calling function to check */
@@ -1565,95 +2136,109 @@ void __stdcall calc_max_sdi(
 
   /* local variables */
   unsigned long           i;
-  double                  wtd_sum_sdimx;
-  double                  sum_ba;
-
-  unsigned long           n_sp_sums;
+  double                  *sp_ba;
+  unsigned char           *sp_present;
+  struct PLANT_RECORD     *plant_ptr;
   struct COEFFS_RECORD    *c_ptr = NULL;
-  struct SUMMARY_RECORD   *temp_sp_ptr = NULL;
-  struct SUMMARY_RECORD   *sp_sum_ptr = NULL;
 
-  wtd_sum_sdimx   = 0.0;
-  sum_ba          = 0.0;
   *max_sdi        = 0.0;
   *return_code = CONIFERS_SUCCESS; /* this wasn't getting set */
 
-  /* build an array of the functional species summaries */
-  /* testing section for calculating the fsp_summaries */
-  //Rprintf( "before build_species_summaries(rc=%d) @ %s, %d\n", *return_code, __FILE__, __LINE__ );
-  temp_sp_ptr = build_species_summaries(   return_code, 
-					   n_species, 
-					   species_ptr,
-					   n_plants,
-					   plants_ptr,
-					   &n_sp_sums );
-
-  //Rprintf( "after build_species_summaries(rc=%d) @ %s, %d\n", *return_code, __FILE__, __LINE__ );
-
-  /* need_error_trap_here */
-  /* check the return code here */
-  if( *return_code != CONIFERS_SUCCESS )
+  /* the basal area for each species in the sample */
+  sp_ba      = (double *)calloc( n_species + 1, sizeof( double ) );
+  sp_present = (unsigned char *)calloc( n_species + 1, sizeof( unsigned char ) );
+  if( sp_ba == NULL || sp_present == NULL )
     {
-      /* print some heinous message */
-      //Rprintf( "build_species_summaries return_code != CONIFERS_SUCCESS %s, %d\n", __FILE__, __LINE__ );
+      free( sp_ba );
+      free( sp_present );
+      *return_code = FAILED_MEMORY_ALLOC;
+      return;
     }
 
+  plant_ptr = &plants_ptr[0];
+  for( i = 0; i < n_plants; i++, plant_ptr++ )
+    {
+      if( plant_ptr->sp_idx >= n_species )
+	{
+	  *return_code = INVALID_SP_CODE;
+	  continue;
+	}
 
+      sp_present[plant_ptr->sp_idx] = 1;
 
-  update_species_summaries(return_code, 
-			   n_species,
-			   species_ptr,
-			   n_coeffs,
-			   coeffs_ptr,
-			   n_plants,
-			   plants_ptr,
-			   n_points,
-			   n_sp_sums,
-			   temp_sp_ptr );
-  /* need_error_trap_here */
-  /* check the return code here */
-  if( *return_code != CONIFERS_SUCCESS )
-    {
-      /* print some heinous message */
-      //Rprintf( "update_species_summaries return_code != CONIFERS_SUCCESS %s, %d\n", __FILE__, __LINE__ );
+      /* only the trees that are over 4.5 feet tall */
+      c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
+      if( plant_ptr->tht > 4.5 && is_tree( c_ptr ) )
+	{
+	  sp_ba[plant_ptr->sp_idx] += plant_ptr->basal_area * plant_ptr->expf;
+	}
     }
 
-  sp_sum_ptr = &temp_sp_ptr[0];
-  for( i = 0; i < n_sp_sums; i++, sp_sum_ptr++ )
+  *max_sdi = calc_max_sdi_from_species_ba( n_species,
+					   species_ptr,
+					   coeffs_ptr,
+					   n_points,
+					   sp_ba,
+					   sp_present );
+
+  free( sp_ba );
+  free( sp_present );
+
+}
+
+
+/* the basal area weighted max sdi of the species in the sample, from    */
+/* the basal area of each species (by species index, before it's divided */
+/* by the number of plots). sp_present marks the species in the sample.  */
+/* the species are added up in index order, which is the order of the    */
+/* species summaries calc_max_sdi used to build. returns 450 when the    */
+/* sample has no trees over 4.5 feet                                      */
+static double calc_max_sdi_from_species_ba(
+					   unsigned long           n_species,
+					   struct SPECIES_RECORD   *species_ptr,
+					   struct COEFFS_RECORD    *coeffs_ptr,
+					   unsigned long           n_points,
+					   double                  *sp_ba_ptr,
+					   unsigned char           *sp_present )
+{
+  unsigned long           i;
+  double                  basal_area;
+  double                  wtd_sum_sdimx;
+  double                  sum_ba;
+  struct COEFFS_RECORD    *c_ptr = NULL;
+
+  wtd_sum_sdimx   = 0.0;
+  sum_ba          = 0.0;
+
+  for( i = 0; i < n_species; i++ )
     {
+      if( !sp_present[i] )
+	{
+	  continue;
+	}
+
       /* get the coeff entry for the current coeffs   */
       /* and check the type for c,h,s,etc and also    */
       /* get the max sdi value for the entry          */
-      c_ptr = &coeffs_ptr[species_ptr[sp_sum_ptr->code].fsp_idx];
+      c_ptr = &coeffs_ptr[species_ptr[i].fsp_idx];
 
       /* MOD031 */
       /* don't include non-stocked functional species */
       if( is_tree( c_ptr ) )
 	{
-	  wtd_sum_sdimx +=    sp_sum_ptr->basal_area * ( log( 10.0 ) + 
-							 log( species_ptr[sp_sum_ptr->code].max_sdi ) / REINEKE_B1 );
-	  sum_ba        += sp_sum_ptr->basal_area;
+	  basal_area     = sp_ba_ptr[i] / n_points;
+	  wtd_sum_sdimx +=    basal_area * ( log( 10.0 ) + 
+					     log( species_ptr[i].max_sdi ) / REINEKE_B1 );
+	  sum_ba        += basal_area;
 	}
     } 
 
-   
-  /* print out some diagnostics here */
-   
-
-  /* print some heinous message */
-  //Rprintf( "sum_ba = %lf\n", sum_ba );
-   
   if( sum_ba > 0.0 )
     {
-      *max_sdi = exp( ( ( wtd_sum_sdimx / sum_ba ) - log( 10.0 ) ) * REINEKE_B1 );
-    }
-  else
-    {
-      *max_sdi = 450.0;
+      return exp( ( ( wtd_sum_sdimx / sum_ba ) - log( 10.0 ) ) * REINEKE_B1 );
     }
 
-  free( temp_sp_ptr );
-
+  return 450.0;
 }
 
 
@@ -1817,21 +2402,172 @@ void get_type_count(
 
 
 
+/********************************************************************************/
+/*   compare_competition_by_value                                               */
+/********************************************************************************/
+static int compare_competition_by_value(
+					const void *ptr1,
+					const void *ptr2 )
+{
+  struct COMPETITION_RECORD   *c1_ptr;
+  struct COMPETITION_RECORD   *c2_ptr;
+
+  c1_ptr = (struct COMPETITION_RECORD *)ptr1;
+  c2_ptr = (struct COMPETITION_RECORD *)ptr2;
+
+  if( c1_ptr->value < c2_ptr->value )
+    {
+      return -1;
+    }
+  if( c1_ptr->value > c2_ptr->value )
+    {
+      return 1;
+    }
+
+  return 0;
+}
+
+
+/********************************************************************************/
+/*   sum_competition_table                                                      */
+/********************************************************************************/
+/*  Description :   sorts the in taller (in larger) table for a plot by value   */
+/*                  and replaces each entry's own basal area and crown area     */
+/*                  with the totals for that entry and every entry after it     */
+/*  Returns     :   void                                                        */
+/*  Comments    :   once the table is summed, the values in taller than a given */
+/*                  height are the totals in the first entry that is taller     */
+/*                  (see find_competition_entry)                                */
+/*  Arguments   :                                                               */
+/*  unsigned long n_entries - number of entries (plants on the plot)            */
+/*  struct COMPETITION_RECORD *table_ptr - the table for the plot               */
+/********************************************************************************/
+static void sum_competition_table(
+				  unsigned long             n_entries,
+				  struct COMPETITION_RECORD *table_ptr )
+{
+
+  unsigned long i;
+  unsigned long k;
+  struct COMPETITION_RECORD   *ptr;
+
+  if( n_entries == 0 )
+    {
+      return;
+    }
+
+  qsort(  (void*)table_ptr,
+	  (size_t)n_entries,
+	  sizeof( struct COMPETITION_RECORD ),
+	  compare_competition_by_value );
+
+  /* accumulate from the tallest (largest) entry down */
+  ptr = &table_ptr[n_entries-1];
+  for( i = n_entries - 1; i > 0; i--, ptr-- )
+    {
+      for( k = 0; k < PLANT_TYPES; k++ )
+	{
+	  ptr[-1].ba[k] += ptr->ba[k];
+	  ptr[-1].ca[k] += ptr->ca[k];
+	}
+    }
+
+}
+
+
+/********************************************************************************/
+/*   find_competition_entry                                                     */
+/********************************************************************************/
+/*  Description :   returns the first entry in a summed table with a value      */
+/*                  greater than value, or NULL if there isn't one              */
+/*  Returns     :   struct COMPETITION_RECORD *                                 */
+/*  Comments    :   bisection, the table must be sorted by value                */
+/********************************************************************************/
+static struct COMPETITION_RECORD *find_competition_entry(
+				  double                    value,
+				  unsigned long             n_entries,
+				  struct COMPETITION_RECORD *table_ptr )
+{
+
+  unsigned long lo;
+  unsigned long hi;
+  unsigned long mid;
+
+  lo = 0;
+  hi = n_entries;
+  while( lo < hi )
+    {
+      mid = lo + ( hi - lo ) / 2;
+      if( table_ptr[mid].value > value )
+	{
+	  hi = mid;
+	}
+      else
+	{
+	  lo = mid + 1;
+	}
+    }
+
+  if( lo >= n_entries )
+    {
+      return NULL;
+    }
+
+  return &table_ptr[lo];
+}
+
+
+/********************************************************************************/
+/*   free_competition_tables                                                    */
+/********************************************************************************/
+/*  Description :   releases the in taller and in larger tables built by        */
+/*                  calc_plot_stats_2 and clears the plots' pointers to them    */
+/*  Returns     :   void                                                        */
+/*  Comments    :   until calc_plot_stats_2 is called again, the get_in_taller  */
+/*                  and get_in_larger functions return zeros                    */
+/********************************************************************************/
+void free_competition_tables( 
+			     unsigned long           n_points,
+			     struct PLOT_RECORD      *plots_ptr )
+{
+
+  unsigned long   i;
+  struct  PLOT_RECORD     *plot_ptr;
+
+  plot_ptr = &plots_ptr[0];
+  for( i = 0; i < n_points; i++, plot_ptr++ )
+    {
+      plot_ptr->in_taller = NULL;
+      plot_ptr->in_larger = NULL;
+    }
+
+  free( in_taller_table );
+  free( in_larger_table );
+
+  in_taller_table        = NULL;
+  in_larger_table        = NULL;
+  competition_table_size = 0;
+
+}
+
+
 /********************************************************************************/
 /*   get_in_taller_attribs                                                      */
 /********************************************************************************/
-/*  Description :   function returns the vectors, by plant type for the two     */   
+/*  Description :   function returns the vectors, by plant type for the two     */
 /*                  attributes (bait/cait) in taller                            */
 /*  Author      :   Jeff D. Hamann                                              */
 /*  Date        :   December 19, 2007                                           */
 /*  Returns     :   void                                                        */
-/*  Comments    :   the bins are scaled linearly between zero and  MAX_AIT_THT  */
+/*  Comments    :   the values are the totals for the plants on the plot that   */
+/*                  are strictly taller than the plant, from the in taller      */
+/*                  table built in calc_plot_stats_2                            */
 /*  Arguments   :                                                               */
 /*  return void                                                                 */
 /*  struct PLANT_RECORD     *plants_ptr a pointer to a plant structure          */
 /*  struct PLOT_RECORD      *plot_ptr,                                          */
-/*  double  bait[PLANT_TYPES][CON_BAT_SIZE];  basal area in taller              */
-/*  double  cait[PLANT_TYPES][CON_BAT_SIZE];  crown area in taller              */
+/*  double  bait[PLANT_TYPES];  basal area in taller                            */
+/*  double  cait[PLANT_TYPES];  crown area in taller                            */
 /********************************************************************************/
 /*  Formula :                                                                   */
 /*  Source  : NA                                                                */
@@ -1844,30 +2580,41 @@ void get_in_taller_attribs(
 			   double                  *cait )
 {
 
+  get_in_taller_attribs_for_height( plant_ptr->tht, plot_ptr, bait, cait );
+
+}
+
+/* same as get_in_taller_attribs, for the plants taller than tht */
+void get_in_taller_attribs_for_height(
+			   double                  tht,
+			   struct PLOT_RECORD      *plot_ptr,
+			   double                  *bait,
+			   double                  *cait )
+{
+
   unsigned long i;
-  unsigned long htidx;
+  struct COMPETITION_RECORD   *ait_ptr = NULL;
 
   /* null out the output vectors */
   memset( bait, 0, sizeof( double ) * PLANT_TYPES );
   memset( cait, 0, sizeof( double ) * PLANT_TYPES );
 
-  /* get the slope to scale the tht into the array */
-  htidx = (int)( (plant_ptr->tht-0.5) / ((double)AIT_BIN_RES));
-
-  if( htidx < 0 )
+  if( plot_ptr->in_taller != NULL )
     {
-      htidx = 0;
+      ait_ptr = find_competition_entry( tht,
+					plot_ptr->last_plant - plot_ptr->first_plant,
+					plot_ptr->in_taller );
     }
 
-  if( htidx >= AIT_SIZE )
+  if( ait_ptr == NULL )
     {
-      htidx = AIT_SIZE - 1;
+      return;
     }
 
   for( i = 0; i < PLANT_TYPES; i++ )
     {
-      bait[i] = plot_ptr->bait[i][htidx];
-      cait[i] = plot_ptr->cait[i][htidx];
+      bait[i] = ait_ptr->ba[i];
+      cait[i] = ait_ptr->ca[i];
     }
 
 }
@@ -1875,16 +2622,18 @@ void get_in_taller_attribs(
 /********************************************************************************/
 /*   get_in_larger_attribs                                                      */
 /********************************************************************************/
-/*  Description :   function returns the vectors, by plant type for bal         */   
+/*  Description :   function returns the vectors, by plant type for bal         */
 /*  Author      :   Martin W. Ritchie                                           */
 /*  Date        :   August 1, 2014                                              */
 /*  Returns     :   void                                                        */
-/*  Comments    :   the bins are scaled linearly between zero and  MAX_AIT_THT  */
+/*  Comments    :   the values are the totals for the plants on the plot with   */
+/*                  a strictly larger dbh than the plant, from the in larger    */
+/*                  table built in calc_plot_stats_2                            */
 /*  Arguments   :                                                               */
 /*  return void                                                                 */
 /*  struct PLANT_RECORD     *plants_ptr a pointer to a plant structure          */
 /*  struct PLOT_RECORD      *plot_ptr,                                          */
-/*  double  bal[PLANT_TYPES][CON_BAT_SIZE];  basal area in larger               */
+/*  double  bal[PLANT_TYPES];  basal area in larger                             */
 /********************************************************************************/
 /*  Formula :                                                                   */
 /*  Source  : NA                                                                */
@@ -1896,100 +2645,40 @@ void get_in_larger_attribs(
 			   double                  *bal )
 {
 
-  unsigned long i;
-  unsigned long htidx;
-
-  /* null out the output vectors */
-  memset( bal, 0, sizeof( double ) * PLANT_TYPES );
-
-  /* get the slope to scale the tht into the array */
-  htidx = (int)( (plant_ptr->dbh) / ((double)AIT_BIN_RES));
-
-  if( htidx < 0 )
-    {
-      htidx = 0;
-    }
-
-  if( htidx >= AIT_SIZE )
-    {
-      htidx = AIT_SIZE - 1;
-    }
-
-  for( i = 0; i < PLANT_TYPES; i++ )
-    {
-      bal[i] = plot_ptr->bal[i][htidx];
-    }
+  get_in_larger_attribs_for_dbh( plant_ptr->dbh, plot_ptr, bal );
 
 }
 
-
-void set_in_taller_attribs(
-			   struct PLANT_RECORD     *plant_ptr,
-			   struct COEFFS_RECORD    *c_ptr,
-			   struct PLOT_RECORD      *plot_ptr )
+/* same as get_in_larger_attribs, for the plants larger than dbh */
+void get_in_larger_attribs_for_dbh(
+			   double                  dbh,
+			   struct PLOT_RECORD      *plot_ptr,
+			   double                  *bal )
 {
 
-  unsigned long k;
-  unsigned long htidx;
-
-  /* compute (fill in) the bal and cait arrays */
-  htidx = (int)( (plant_ptr->tht-0.5) / ((double)AIT_BIN_RES));
-
+  unsigned long i;
+  struct COMPETITION_RECORD   *ail_ptr = NULL;
 
-  /* limit the array to a 300 feet */
-  if( htidx < 0 )
-    {
-      htidx = 0;
-    }
+  /* null out the output vectors */
+  memset( bal, 0, sizeof( double ) * PLANT_TYPES );
 
-  if( htidx > AIT_SIZE )
+  if( plot_ptr->in_larger != NULL )
     {
-      htidx = AIT_SIZE ;
+      ail_ptr = find_competition_entry( dbh,
+					plot_ptr->last_plant - plot_ptr->first_plant,
+					plot_ptr->in_larger );
     }
 
-  /* fill in the "values in taller" array */
-    /* where the basal area in taller values are above 6 inches */
-    for( k = 0; k < htidx; k++ )
-      {
-	plot_ptr->bait[c_ptr->type][k] += ( plant_ptr->d6 * plant_ptr->d6 * FC_I * plant_ptr->expf );
-	plot_ptr->cait[c_ptr->type][k] += ( plant_ptr->crown_area * plant_ptr->expf );
-      }
-
-}
-/* this is the code for basal area in larger for CIPS*/
-/* made by MWR August 1, 2014                */
-void set_in_larger_attribs(
-                           struct PLANT_RECORD    *plant_ptr,
-                           struct COEFFS_RECORD   *c_ptr,
-                           struct PLOT_RECORD     *plot_ptr)
-{
-
-  unsigned long k;
-  unsigned long htidx;
-
-  /* compute (fill in) the bal  array */
-  htidx = (int)( (plant_ptr->dbh) / ((double)AIT_BIN_RES));
-
-
-  /* limit the array to a 75 inches feet */
-  if( htidx < 0 )
+  if( ail_ptr == NULL )
     {
-      htidx = 0;
+      return;
     }
 
-  if( htidx > AIT_SIZE )
+  for( i = 0; i < PLANT_TYPES; i++ )
     {
-      htidx = AIT_SIZE ;
+      bal[i] = ail_ptr->ba[i];
     }
 
-  /* fill in the "values in taller" array */
-    /* where the basal area in taller values are above 6 inches */
-    for( k = 0; k < htidx; k++ )
-      {
-	    plot_ptr->bal[c_ptr->type][k] += ( plant_ptr->dbh * plant_ptr->dbh * FC_I * plant_ptr->expf );
-      }
-
-
 }
 
 
@@ -2041,98 +2730,23 @@ void __stdcall impute_missing_values(
 	  double                  baf)
 {
 
-      /* each variant has it's own impute function  */
-      switch( variant )
-      {
-	    case CONIFERS_SWO:
-            /* this function is in model_swo.c */
-            swo_impute( 
-			        return_code,
-			        n_species,
-			        species_ptr,
-			        n_coeffs,
-			        coeffs_ptr,
-			        variant,
-			        n_plants,
-			        plants_ptr,
-			        n_points,
-			        plots_ptr,
-			        fixed_plot_radius,
-			        min_prism_dbh,
-			        baf );
-            break;
-
-	    case CONIFERS_SMC:
-            /* this function is in model_smc.c */
-            smc_impute( 
-			        return_code,
-			        n_species,
-			        species_ptr,
-			        n_coeffs,
-			        coeffs_ptr,
-			        variant,
-			        n_plants,
-			        plants_ptr,
-			        n_points,
-			        plots_ptr,
-			        fixed_plot_radius,
-			        min_prism_dbh,
-			        baf );
-            break;
-
-	    case CONIFERS_SWOHYBRID:
-            /* this function is in model_swohybrid.c */
-            swohybrid_impute( 
-			        return_code,
-			        n_species,
-			        species_ptr,
-			        n_coeffs,
-			        coeffs_ptr,
-			        variant,
-			        n_plants,
-			        plants_ptr,
-			        n_points,
-			        plots_ptr,
-			        fixed_plot_radius,
-			        min_prism_dbh,
-			        baf );
-            break;
-
-	    case CONIFERS_CIPS:
-            /* this function is in model_cips.c */
-            cips_impute( 
-			        return_code,
-			        n_species,
-			        species_ptr,
-			        n_coeffs,
-			        coeffs_ptr,
-			        variant,
-			        n_plants,
-			        plants_ptr,
-			        n_points,
-			        plots_ptr,
-			        fixed_plot_radius,
-			        min_prism_dbh,
-			        baf );
-            break;
-
-	    default:
-            /* this function is in model_swo.c */
-            swo_impute( 
-			        return_code,
-			        n_species,
-			        species_ptr,
-			        n_coeffs,
-			        coeffs_ptr,
-			        variant,
-			        n_plants,
-			        plants_ptr,
-			        n_points,
-			        plots_ptr,
-			        fixed_plot_radius,
-			        min_prism_dbh,
-			        baf );
-      }
+      /* each variant has it's own impute function, see variants.c */
+      get_variant( variant )->impute( return_code,
+                                      n_species,
+                                      species_ptr,
+                                      n_coeffs,
+                                      coeffs_ptr,
+                                      variant,
+                                      n_plants,
+                                      plants_ptr,
+                                      n_points,
+                                      plots_ptr,
+                                      fixed_plot_radius,
+                                      min_prism_dbh,
+                                      baf );
+
+  /* the competition tables aren't needed after the imputation */
+  free_competition_tables( n_points, plots_ptr );
 
   if( *return_code != CONIFERS_SUCCESS )
   {
@@ -2445,3 +3059,220 @@ void calc_volume(
 }
 
 
+/********************************************************************************/
+/*           calc_volume_batch, calc_biomass_batch                              */
+/********************************************************************************/
+/*  Description :   calc_volume and calc_biomass for n plants (at most          */
+/*                  GROWTH_BATCH_SIZE) of one functional species                */
+/*  Comments    :   the plants take the same equations as the single plant      */
+/*                  versions, the logs, exps and pows for the batch go through  */
+/*                  libm_log_batch, libm_exp_batch and libm_pow_batch, so the   */
+/*                  fast kernels are never used. a plant that doesn't need a    */
+/*                  term gets an argument of 1.0 (or 0.0 for the exps) and the  */
+/*                  value is dropped. the values are the same as calc_volume    */
+/*                  and calc_biomass, the return codes aren't kept since the    */
+/*                  summaries don't use them                                    */
+/********************************************************************************/
+static void calc_volume_batch(
+    unsigned long   n,
+    double          *total_height_ptr,
+    double          *dbh_ptr,
+    double          *pred_volume_ptr,
+    double          *coeffs_ptr )
+{
+    unsigned long   k;
+    double  b0;
+    double  b1;
+    double  b2;
+    double  b3;
+    double  dbh_b1[GROWTH_BATCH_SIZE];
+    double  ht_b2[GROWTH_BATCH_SIZE];
+
+    if( coeffs_ptr == NULL || 
+        coeffs_ptr[0] <= 0.0 || coeffs_ptr[1] <= 0.0 || coeffs_ptr[2] <= 0.0 )
+    {
+        memset( pred_volume_ptr, 0, n * sizeof( double ) );
+        return;
+    }
+
+    b0 = coeffs_ptr[0];
+    b1 = coeffs_ptr[1];
+    b2 = coeffs_ptr[2];
+    b3 = coeffs_ptr[3];
+
+    for( k = 0; k < n; k++ )
+    {
+        if( dbh_ptr[k] <= 0.0 || total_height_ptr[k] <= 4.5 )
+        {
+            dbh_b1[k] = 1.0;
+            ht_b2[k]  = 1.0;
+        }
+        else
+        {
+            dbh_b1[k] = dbh_ptr[k];
+            ht_b2[k]  = total_height_ptr[k];
+        }
+    }
+
+    libm_pow_batch( n, dbh_b1, b1, dbh_b1 );
+    libm_pow_batch( n, ht_b2, b2, ht_b2 );
+
+    for( k = 0; k < n; k++ )
+    {
+        if( dbh_ptr[k] <= 0.0 || total_height_ptr[k] <= 4.5 )
+        {
+            pred_volume_ptr[k] = 0.0;
+        }
+        else
+        {
+            pred_volume_ptr[k] = b0 * 
+                dbh_b1[k] * 
+                ht_b2[k] *
+                pow( b3, dbh_ptr[k] );
+        }
+    }
+}
+
+
+/* the equation calc_biomass picks for a plant */
+#define BIOMASS_NONE       0
+#define BIOMASS_RW_SHRUB   1
+#define BIOMASS_RW_PINE    2
+#define BIOMASS_HT         3
+#define BIOMASS_GHOLZ      4
+#define BIOMASS_GHOLZ_MIN  5
+
+static void calc_biomass_batch(
+    unsigned long   n,
+    double          *total_height_ptr,
+    double          *crown_width_ptr,
+    double          *dbh_ptr,
+    double          *pred_biomass_ptr,
+    double          *coeffs_ptr )
+{
+    unsigned long   k;
+    int     rs_eqs;
+    int     rp_eqs;
+    int     h_eqs;
+    int     g_eqs;
+    double  cw;
+    double  h_bio;
+
+    unsigned char   eq[GROWTH_BATCH_SIZE];
+    double  ln_x[GROWTH_BATCH_SIZE];  /* log of the cw, height or dbh in cm */
+    double  e_1[GROWTH_BATCH_SIZE];   /* R&W, or G&G foliage               */
+    double  e_2[GROWTH_BATCH_SIZE];   /* G&G branch                        */
+    double  e_3[GROWTH_BATCH_SIZE];   /* G&G stem                          */
+
+    if( coeffs_ptr == NULL )
+    {
+        memset( pred_biomass_ptr, 0, n * sizeof( double ) );
+        return;
+    }
+
+    /* the sets of equations that have valid coefficients, in the */
+    /* order calc_biomass tries them                              */
+    rs_eqs = ( coeffs_ptr[0] < 0.0 && coeffs_ptr[1] > 0.0 && coeffs_ptr[2] > 0.0 );
+    rp_eqs = ( coeffs_ptr[3] < 0.0 && coeffs_ptr[4] > 0.0 && coeffs_ptr[5] > 0.0 );
+    h_eqs  = ( coeffs_ptr[12] > 0.0 && coeffs_ptr[13] < 0.0 );
+    g_eqs  = ( coeffs_ptr[6] < 0.0 && coeffs_ptr[8] < 0.0 && coeffs_ptr[10] < 0.0 && 
+               coeffs_ptr[7] > 0.0 && coeffs_ptr[11] && coeffs_ptr[9] > 0.0 );
+
+    for( k = 0; k < n; k++ )
+    {
+        eq[k]   = BIOMASS_NONE;
+        ln_x[k] = 1.0;
+
+        if( dbh_ptr[k] <= 0.0 && crown_width_ptr[k] <= 0.0 && 
+            total_height_ptr[k] <= 0.0 )
+        {
+            continue;
+        }
+
+        if( rs_eqs && crown_width_ptr[k] > 0.0 )
+        {
+            eq[k]   = BIOMASS_RW_SHRUB;
+            ln_x[k] = crown_width_ptr[k] * FT2CM;
+        }
+        else if( rp_eqs && total_height_ptr[k] > 0.0 )
+        {
+            eq[k]   = BIOMASS_RW_PINE;
+            ln_x[k] = total_height_ptr[k] * FT2CM;
+        }
+        else if( h_eqs && crown_width_ptr[k] > 0.0 )
+        {
+            eq[k]   = BIOMASS_HT;
+        }
+        else if( g_eqs && dbh_ptr[k] <= 0.0 )
+        {
+            eq[k]   = BIOMASS_GHOLZ_MIN;
+        }
+        else if( g_eqs )
+        {
+            eq[k]   = BIOMASS_GHOLZ;
+            ln_x[k] = dbh_ptr[k] * IN2CM;
+        }
+    }
+
+    libm_log_batch( n, ln_x, ln_x );
+
+    for( k = 0; k < n; k++ )
+    {
+        e_1[k] = 0.0;
+        e_2[k] = 0.0;
+        e_3[k] = 0.0;
+
+        switch( eq[k] )
+        {
+        case BIOMASS_RW_SHRUB:
+            e_1[k] = coeffs_ptr[0] + coeffs_ptr[1] * ln_x[k] + coeffs_ptr[2] * 0.5;
+            break;
+        case BIOMASS_RW_PINE:
+            e_1[k] = coeffs_ptr[3] + coeffs_ptr[4] * ln_x[k] + coeffs_ptr[5] * 0.5;
+            break;
+        case BIOMASS_GHOLZ:
+            e_1[k] = coeffs_ptr[6] + coeffs_ptr[7] * ln_x[k];
+            e_2[k] = coeffs_ptr[8] + coeffs_ptr[9] * ln_x[k];
+            e_3[k] = coeffs_ptr[10] + coeffs_ptr[11] * ln_x[k];
+            break;
+        }
+    }
+
+    libm_exp_batch( n, e_1, e_1 );
+    if( g_eqs )
+    {
+        libm_exp_batch( n, e_2, e_2 );
+        libm_exp_batch( n, e_3, e_3 );
+    }
+
+    for( k = 0; k < n; k++ )
+    {
+        switch( eq[k] )
+        {
+        case BIOMASS_RW_SHRUB:
+        case BIOMASS_RW_PINE:
+            pred_biomass_ptr[k] = ( e_1[k] * GRM2LB ) * LB2TON;
+            break;
+        case BIOMASS_HT:
+            cw    = crown_width_ptr[k];
+            h_bio = (coeffs_ptr[12] * (MY_PI*((cw*FT2M)*(cw*FT2M))/4.0) + coeffs_ptr[13]) * KG2LB;
+            if ( h_bio < 0.0 ) /* the same small value as calc_biomass */
+            {
+                h_bio = 0.01;
+            }
+            pred_biomass_ptr[k] = h_bio * LB2TON;
+            break;
+        case BIOMASS_GHOLZ:
+            pred_biomass_ptr[k] = ( e_1[k] * KG2LB + 
+                                    e_2[k] * KG2LB + 
+                                    e_3[k] * KG2LB ) * LB2TON;
+            break;
+        case BIOMASS_GHOLZ_MIN:
+            pred_biomass_ptr[k] = 0.01 * LB2TON;
+            break;
+        default:
+            pred_biomass_ptr[k] = 0.0;
+            break;
+        }
+    }
+}
@@ -122,6 +122,9 @@ static int compare_DBH_increasing(
 /*                   as that happens as a part of the growth process            */
 /*                   it is called in a loop which runs throught the plots, so   */
 /*                   when you get here, you already know what plot you are on   */
+/*                   the plant records for the plot are found with the plot     */
+/*                   index, so build_plot_plant_index (or calc_plot_stats_2)    */
+/*                   must be called on the plant list before thinning           */
 /*  Arguments   :                                                               */
 /*     unsigned long         *return_code   - pointer to a return code          */
 /*     unsigned long         n_plants       - total number fo plants in the     */
@@ -183,19 +186,18 @@ void __stdcall thin_plot(
     *plants_removed           = 0.0;
     *ba_removed               = 0.0;
 
+    /* the plot totals have to be recomputed after the thinning */
+    plot_ptr->aggregates_current = 0;
+
     switch( thin_guide )
     {
         /* this is the routine that actually does the sdi mortality */
         case DO_SDI_MORT:    
 
-            plant_ptr = &plants_ptr[0];
-            for( i = 0; i < n_plants; i++, plant_ptr++ )
+            /* only visit the plant records on the plot */
+            plant_ptr = &plants_ptr[plot_ptr->first_plant];
+            for( i = plot_ptr->first_plant; i < plot_ptr->last_plant; i++, plant_ptr++ )
             {
-                /* if you're not on the plot, don't thin it */
-                if( plant_ptr->plot != plot_ptr->plot )
-                {
-                    continue;
-                }
                 c_ptr = &coeffs_ptr[species_ptr[plant_ptr->sp_idx].fsp_idx];
 
                 if( is_tree( c_ptr ) )
@@ -356,15 +358,16 @@ static void do_expf_sp_thinning(
     *plants_removed          =0.0;
     *ba_removed              =0.0;
 
-    /*  This returns num spec on the plot */
-    get_plant_indecies_for_plot( 
-                            return_code,
-                            plot_ptr,
-                            n_plants,
-                            plants_ptr,
-                            &start_idx,      
-                            &end_idx,
-                            &n_plant_records_on_plot );
+    /* the plant records for the plot, from the plot index */
+    start_idx               = plot_ptr->first_plant;
+    n_plant_records_on_plot = plot_ptr->last_plant - plot_ptr->first_plant;
+    if( n_plant_records_on_plot == 0 )
+    {
+        /* the species can't be on an empty plot */
+        *return_code = INVALID_SP_CODE;
+        return;
+    }
+    end_idx                 = plot_ptr->last_plant - 1;
 
     /* build species summary array */
     plot_sum_ptr = build_species_summaries( 
@@ -385,7 +388,8 @@ static void do_expf_sp_thinning(
                             &plants_ptr[start_idx],
                             1,
                             n_sp_on_plot,
-                            plot_sum_ptr );
+                            plot_sum_ptr,
+                            0 );
 
 
     target_species_plot_summary = get_summary_from_code(    n_sp_on_plot,
@@ -506,15 +510,16 @@ static void do_expf_thinning(
     *ba_removed             =0.0;
     total_trees             =0.0;
 
-    /*  This returns num spec on the plot */
-    get_plant_indecies_for_plot(
-                            return_code,
-                            plot_ptr,
-                            n_plants,
-                            plants_ptr,
-                            &start_idx,
-                            &end_idx,
-                            &n_plant_records_on_plot );
+    /* the plant records for the plot, from the plot index */
+    start_idx               = plot_ptr->first_plant;
+    n_plant_records_on_plot = plot_ptr->last_plant - plot_ptr->first_plant;
+    if( n_plant_records_on_plot == 0 )
+    {
+        /* nothing to thin on an empty plot */
+        *return_code = CONIFERS_SUCCESS;
+        return;
+    }
+    end_idx                 = plot_ptr->last_plant - 1;
     /* build species summary array */
     plot_sum_ptr = build_species_summaries( 
                             return_code,
@@ -534,7 +539,8 @@ static void do_expf_thinning(
                             &plants_ptr[start_idx],
                             1,
                             n_sp_on_plot,
-                            plot_sum_ptr );
+                            plot_sum_ptr,
+                            0 );
 
     temp_plot_record = &plot_sum_ptr[0];
 
@@ -657,14 +663,16 @@ static void do_expf_thinning_from_below(
     *ba_removed             =0.0;
     total_trees             =0.0;
 
-    /*  This returns num spec on the plot */
-    get_plant_indecies_for_plot(    return_code,
-                                    plot_ptr,
-                                    n_plants,
-                                    plants_ptr,
-                                    &start_idx,
-                                    &end_idx,
-                                    &n_plant_records_on_plot );
+    /* the plant records for the plot, from the plot index */
+    start_idx               = plot_ptr->first_plant;
+    n_plant_records_on_plot = plot_ptr->last_plant - plot_ptr->first_plant;
+    if( n_plant_records_on_plot == 0 )
+    {
+        /* nothing to thin on an empty plot */
+        *return_code = CONIFERS_SUCCESS;
+        return;
+    }
+    end_idx                 = plot_ptr->last_plant - 1;
 
     /* build species summary array */
     plot_sum_ptr = build_species_summaries( return_code,
@@ -684,7 +692,8 @@ static void do_expf_thinning_from_below(
                                 &plants_ptr[start_idx],
                                 1,
                                 n_sp_on_plot,
-                                plot_sum_ptr );
+                                plot_sum_ptr,
+                                0 );
 
 
     /* loop through the specs, because you need to      */
@@ -835,14 +844,16 @@ static void do_expf_sp_thinning_from_below(
     *ba_removed             =0.0;
     total_trees             =0.0;
 
-    /*  This returns num spec on the plot */
-    get_plant_indecies_for_plot(    return_code,
-                                    plot_ptr,
-                                    n_plants,
-                                    plants_ptr,
-                                    &start_idx,
-                                    &end_idx,
-                                    &n_plant_records_on_plot );
+    /* the plant records for the plot, from the plot index */
+    start_idx               = plot_ptr->first_plant;
+    n_plant_records_on_plot = plot_ptr->last_plant - plot_ptr->first_plant;
+    if( n_plant_records_on_plot == 0 )
+    {
+        /* nothing to thin on an empty plot */
+        *return_code = CONIFERS_SUCCESS;
+        return;
+    }
+    end_idx                 = plot_ptr->last_plant - 1;
 
     /* build species summary array */
     plot_sum_ptr = build_species_summaries( return_code,
@@ -862,7 +873,8 @@ static void do_expf_sp_thinning_from_below(
                                 &plants_ptr[start_idx],
                                 1,
                                 n_sp_on_plot,
-                                plot_sum_ptr );
+                                plot_sum_ptr,
+                                0 );
 
 
     /* loop through the specs, because you need to      */
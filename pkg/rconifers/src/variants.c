@@ -0,0 +1,105 @@
+/********************************************************************************/
+/*                                                                              */
+/*  variants.c                                                                  */
+/*  the table of simulator variants and the functions that implement them       */
+/*                                                                              */
+/********************************************************************************/
+
+/********************************************************************************/
+/*                          Revision History                                    */
+/*                                                                              */
+/*  Number  Date        Who     Revision Notes                                  */
+/********************************************************************************/
+/*  MOD000  Oct 17,2026         created file, table of the variants and their   */
+/*                              functions, replaces the switches on the         */
+/*                              variant in the calling functions                */
+/********************************************************************************/
+
+#include <math.h>
+#include <memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "conifers.h"
+
+
+/* the variants, in the order of their CONIFERS_XXX codes */
+/* todo: step #4 - add a VARIANT_RECORD for the new variant here */
+static struct VARIANT_RECORD variants[N_VARIANTS] = {
+
+   {  CONIFERS_SWO,
+      "CONIFERS_SWO",
+      0,
+      con_swo_init_coeffs,
+      swo_impute,
+      swo_project_plot },
+
+   {  CONIFERS_SMC,
+      "CONIFERS_SMC",
+      1,
+      con_smc_init_coeffs,
+      smc_impute,
+      smc_project_plot },
+
+   {  CONIFERS_SWOHYBRID,
+      "CONIFERS_SWOHYBRID",
+      0,
+      con_swo_hybrid_init_coeffs,
+      swohybrid_impute,
+      swo_hybrid_project_plot },
+
+   {  CONIFERS_CIPS,
+      "CONIFERS_CIPS",
+      0,
+      con_cips_init_coeffs,
+      cips_impute,
+      cips_project_plot }
+
+};
+
+
+/********************************************************************************/
+/* find_variant                                                                 */
+/********************************************************************************/
+/*  Description :   returns the VARIANT_RECORD for a variant code               */
+/*  Returns     :   struct VARIANT_RECORD * or NULL if there isn't a variant    */
+/*                  with that code                                              */
+/*  Arguments   :   unsigned long variant - CONIFERS_SWO, CONIFERS_SMC, ...     */
+/********************************************************************************/
+struct VARIANT_RECORD *find_variant( unsigned long variant )
+{
+
+   if( variant >= N_VARIANTS )
+   {
+      return NULL;
+   }
+
+   return &variants[variant];
+
+}
+
+
+/********************************************************************************/
+/* get_variant                                                                  */
+/********************************************************************************/
+/*  Description :   returns the VARIANT_RECORD for a variant code               */
+/*  Returns     :   struct VARIANT_RECORD *                                     */
+/*  Comments    :   unknown codes get the CONIFERS_SWO variant, the same as     */
+/*                  the default cases the variant switches used to have         */
+/*  Arguments   :   unsigned long variant - CONIFERS_SWO, CONIFERS_SMC, ...     */
+/********************************************************************************/
+struct VARIANT_RECORD *get_variant( unsigned long variant )
+{
+
+   struct VARIANT_RECORD   *variant_ptr;
+
+   variant_ptr = find_variant( variant );
+   if( variant_ptr == NULL )
+   {
+      variant_ptr = &variants[CONIFERS_SWO];
+   }
+
+   return variant_ptr;
+
+}